@@ -172,6 +172,28 @@ extern void (*MEM_reset_peak_memory)(void);
 /** Get the peak memory usage in bytes, including mmap allocations. */
 extern size_t (*MEM_get_peak_memory)(void) ATTR_WARN_UNUSED_RESULT;
 
+/** Memory statistics of a single thread, see #MEM_get_thread_stats. */
+typedef struct MEM_ThreadStats {
+  /** Number and size of the blocks allocated by the thread which are not freed yet. */
+  unsigned int blocks_in_use;
+  size_t mem_in_use;
+  /** Peak of #mem_in_use since the last #MEM_reset_peak_memory. */
+  size_t peak_mem;
+  /** Bytes reserved for pooled small blocks, and the part of it used by blocks. */
+  size_t pool_reserved;
+  size_t pool_in_use;
+} MEM_ThreadStats;
+
+/**
+ * Fill in memory statistics for each thread which allocated memory, up to `stats_num` threads.
+ * Returns the number of filled in statistics. Only the pooled allocator keeps track of these,
+ * other allocators return zero.
+ */
+extern int (*MEM_get_thread_stats)(MEM_ThreadStats *r_stats, int stats_num);
+
+/** Fraction of the memory reserved for pooled blocks which is not used by any block. */
+extern float (*MEM_get_fragmentation)(void) ATTR_WARN_UNUSED_RESULT;
+
 #ifdef __GNUC__
 #  define MEM_SAFE_FREE(v) \
     do { \
@@ -238,6 +260,16 @@ void MEM_use_lockfree_allocator(void);
  * NOTE: The switch between allocator types can only happen before any allocation did happen. */
 void MEM_use_guarded_allocator(void);
 
+/* Switch allocator to fast mode with per-thread arenas.
+ *
+ * Like the lock-free allocator, but small blocks are allocated from pools owned by the allocating
+ * thread, and statistics are kept per thread. This avoids contention in the system allocator when
+ * many threads allocate at the same time. Memory reserved for pools is reused by later
+ * allocations, but not returned to the system.
+ *
+ * NOTE: The switch between allocator types can only happen before any allocation did happen. */
+void MEM_use_pooled_allocator(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -46,6 +46,9 @@ size_t (*MEM_get_memory_in_use)(void) = MEM_lockfree_get_memory_in_use;
 unsigned int (*MEM_get_memory_blocks_in_use)(void) = MEM_lockfree_get_memory_blocks_in_use;
 void (*MEM_reset_peak_memory)(void) = MEM_lockfree_reset_peak_memory;
 size_t (*MEM_get_peak_memory)(void) = MEM_lockfree_get_peak_memory;
+int (*MEM_get_thread_stats)(MEM_ThreadStats *r_stats,
+                            int stats_num) = MEM_lockfree_get_thread_stats;
+float (*MEM_get_fragmentation)(void) = MEM_lockfree_get_fragmentation;
 
 #ifndef NDEBUG
 const char *(*MEM_name_ptr)(void *vmemh) = MEM_lockfree_name_ptr;
@@ -125,6 +128,8 @@ void MEM_use_lockfree_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_lockfree_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_lockfree_reset_peak_memory;
   MEM_get_peak_memory = MEM_lockfree_get_peak_memory;
+  MEM_get_thread_stats = MEM_lockfree_get_thread_stats;
+  MEM_get_fragmentation = MEM_lockfree_get_fragmentation;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_lockfree_name_ptr;
@@ -156,8 +161,43 @@ void MEM_use_guarded_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_guarded_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_guarded_reset_peak_memory;
   MEM_get_peak_memory = MEM_guarded_get_peak_memory;
+  MEM_get_thread_stats = MEM_guarded_get_thread_stats;
+  MEM_get_fragmentation = MEM_guarded_get_fragmentation;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_guarded_name_ptr;
 #endif
 }
+
+void MEM_use_pooled_allocator(void)
+{
+  assert_for_allocator_change();
+
+  MEM_allocN_len = MEM_pooled_allocN_len;
+  MEM_freeN = MEM_pooled_freeN;
+  MEM_dupallocN = MEM_pooled_dupallocN;
+  MEM_reallocN_id = MEM_pooled_reallocN_id;
+  MEM_recallocN_id = MEM_pooled_recallocN_id;
+  MEM_callocN = MEM_pooled_callocN;
+  MEM_calloc_arrayN = MEM_pooled_calloc_arrayN;
+  MEM_mallocN = MEM_pooled_mallocN;
+  MEM_malloc_arrayN = MEM_pooled_malloc_arrayN;
+  MEM_mallocN_aligned = MEM_pooled_mallocN_aligned;
+  MEM_printmemlist_pydict = MEM_pooled_printmemlist_pydict;
+  MEM_printmemlist = MEM_pooled_printmemlist;
+  MEM_callbackmemlist = MEM_pooled_callbackmemlist;
+  MEM_printmemlist_stats = MEM_pooled_printmemlist_stats;
+  MEM_set_error_callback = MEM_pooled_set_error_callback;
+  MEM_consistency_check = MEM_pooled_consistency_check;
+  MEM_set_memory_debug = MEM_pooled_set_memory_debug;
+  MEM_get_memory_in_use = MEM_pooled_get_memory_in_use;
+  MEM_get_memory_blocks_in_use = MEM_pooled_get_memory_blocks_in_use;
+  MEM_reset_peak_memory = MEM_pooled_reset_peak_memory;
+  MEM_get_peak_memory = MEM_pooled_get_peak_memory;
+  MEM_get_thread_stats = MEM_pooled_get_thread_stats;
+  MEM_get_fragmentation = MEM_pooled_get_fragmentation;
+
+#ifndef NDEBUG
+  MEM_name_ptr = MEM_pooled_name_ptr;
+#endif
+}
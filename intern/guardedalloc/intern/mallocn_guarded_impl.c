@@ -1159,6 +1159,16 @@ size_t MEM_guarded_get_peak_memory(void)
   return _peak_mem;
 }
 
+int MEM_guarded_get_thread_stats(MEM_ThreadStats *UNUSED(r_stats), int UNUSED(stats_num))
+{
+  return 0;
+}
+
+float MEM_guarded_get_fragmentation(void)
+{
+  return 0.0f;
+}
+
 void MEM_guarded_reset_peak_memory(void)
 {
   mem_lock_thread();
@@ -129,6 +129,8 @@ size_t MEM_lockfree_get_memory_in_use(void);
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void);
 void MEM_lockfree_reset_peak_memory(void);
 size_t MEM_lockfree_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+int MEM_lockfree_get_thread_stats(MEM_ThreadStats *r_stats, int stats_num);
+float MEM_lockfree_get_fragmentation(void) ATTR_WARN_UNUSED_RESULT;
 #ifndef NDEBUG
 const char *MEM_lockfree_name_ptr(void *vmemh);
 #endif
@@ -172,10 +174,57 @@ size_t MEM_guarded_get_memory_in_use(void);
 unsigned int MEM_guarded_get_memory_blocks_in_use(void);
 void MEM_guarded_reset_peak_memory(void);
 size_t MEM_guarded_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+int MEM_guarded_get_thread_stats(MEM_ThreadStats *r_stats, int stats_num);
+float MEM_guarded_get_fragmentation(void) ATTR_WARN_UNUSED_RESULT;
 #ifndef NDEBUG
 const char *MEM_guarded_name_ptr(void *vmemh);
 #endif
 
+/* Prototypes for pooled allocator functions */
+size_t MEM_pooled_allocN_len(const void *vmemh) ATTR_WARN_UNUSED_RESULT;
+void MEM_pooled_freeN(void *vmemh);
+void *MEM_pooled_dupallocN(const void *vmemh) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void *MEM_pooled_reallocN_id(void *vmemh,
+                             size_t len,
+                             const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(2);
+void *MEM_pooled_recallocN_id(void *vmemh,
+                              size_t len,
+                              const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(2);
+void *MEM_pooled_callocN(size_t len, const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1) ATTR_NONNULL(2);
+void *MEM_pooled_calloc_arrayN(size_t len,
+                               size_t size,
+                               const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1, 2) ATTR_NONNULL(3);
+void *MEM_pooled_mallocN(size_t len, const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1) ATTR_NONNULL(2);
+void *MEM_pooled_malloc_arrayN(size_t len,
+                               size_t size,
+                               const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1, 2) ATTR_NONNULL(3);
+void *MEM_pooled_mallocN_aligned(size_t len,
+                                 size_t alignment,
+                                 const char *str) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1) ATTR_NONNULL(3);
+void MEM_pooled_printmemlist_pydict(void);
+void MEM_pooled_printmemlist(void);
+void MEM_pooled_callbackmemlist(void (*func)(void *));
+void MEM_pooled_printmemlist_stats(void);
+void MEM_pooled_set_error_callback(void (*func)(const char *));
+bool MEM_pooled_consistency_check(void);
+void MEM_pooled_set_memory_debug(void);
+size_t MEM_pooled_get_memory_in_use(void);
+unsigned int MEM_pooled_get_memory_blocks_in_use(void);
+void MEM_pooled_reset_peak_memory(void);
+size_t MEM_pooled_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+int MEM_pooled_get_thread_stats(MEM_ThreadStats *r_stats, int stats_num);
+float MEM_pooled_get_fragmentation(void) ATTR_WARN_UNUSED_RESULT;
+#ifndef NDEBUG
+const char *MEM_pooled_name_ptr(void *vmemh);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
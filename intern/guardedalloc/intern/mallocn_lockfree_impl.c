@@ -416,6 +416,16 @@ size_t MEM_lockfree_get_peak_memory(void)
   return peak_mem;
 }
 
+int MEM_lockfree_get_thread_stats(MEM_ThreadStats *UNUSED(r_stats), int UNUSED(stats_num))
+{
+  return 0;
+}
+
+float MEM_lockfree_get_fragmentation(void)
+{
+  return 0.0f;
+}
+
 #ifndef NDEBUG
 const char *MEM_lockfree_name_ptr(void *vmemh)
 {
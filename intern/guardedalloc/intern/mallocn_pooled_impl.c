@@ -0,0 +1,739 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup intern_mem
+ *
+ * Memory allocation with per-thread arenas. Small blocks are taken from pools owned by the
+ * allocating thread, so threads don't contend on the system allocator or on shared counters.
+ */
+
+#include <stdarg.h>
+#include <stdio.h> /* printf */
+#include <stdlib.h>
+#include <string.h> /* memcpy */
+#include <sys/types.h>
+
+#include <pthread.h>
+
+#include "MEM_guardedalloc.h"
+
+/* to ensure strict conversions */
+#include "../../source/blender/blenlib/BLI_strict_flags.h"
+
+#include "atomic_ops.h"
+#include "mallocn_intern.h"
+
+/* Blocks up to this size are allocated from the pools of the thread arenas, bigger blocks are
+ * allocated with the system allocator. */
+#define POOL_MAX_SIZE 512
+#define POOL_SIZE_CLASS_STEP 16
+#define POOL_SIZE_CLASSES_NUM (POOL_MAX_SIZE / POOL_SIZE_CLASS_STEP)
+/* Size of the chunks requested from the system allocator to carve pooled blocks from. */
+#define POOL_CHUNK_SIZE (64 * 1024)
+
+/* Threads only add their memory usage to the global counter used for the peak memory when it
+ * changed by this many bytes. This avoids contention on the counter, at the cost of the peak
+ * being slightly off when many threads allocate at the same time. */
+#define PEAK_FLUSH_THRESHOLD ((int64_t)1024 * 1024)
+
+typedef struct MemArena MemArena;
+
+/* The length is stored last, so that it can be accessed the same way for aligned blocks. */
+typedef struct MemHead {
+  /* Arena of the thread that allocated the block. */
+  MemArena *arena;
+  /* Length of allocated memory block. */
+  size_t len;
+} MemHead;
+
+typedef struct MemHeadAligned {
+  short alignment;
+  MemArena *arena;
+  size_t len;
+} MemHeadAligned;
+
+/* Unused pooled block, stored in place of its #MemHead. */
+typedef struct MemFreeBlock {
+  struct MemFreeBlock *next;
+} MemFreeBlock;
+
+/* Memory requested from the system allocator for pooled blocks. The size keeps the blocks
+ * carved from the chunk aligned the same as blocks from the system allocator. */
+typedef struct MemPoolChunk {
+  struct MemPoolChunk *next;
+  size_t size;
+} MemPoolChunk;
+
+struct MemArena {
+  /* Unused pooled blocks for each size class. Only accessed by the thread owning the arena. */
+  MemFreeBlock *free_blocks[POOL_SIZE_CLASSES_NUM];
+  /* Part of the last chunk that was not used for blocks yet. */
+  char *chunk_free_begin;
+  char *chunk_free_end;
+  MemPoolChunk *chunks;
+
+  /* Pooled blocks freed by other threads. These are lock-free stacks, which the owning thread
+   * takes over when its own free list of the size class is empty. */
+  MemFreeBlock *remote_free_blocks[POOL_SIZE_CLASSES_NUM];
+
+  /* Statistics of the blocks allocated by the thread. Other threads modify them when they free
+   * blocks owned by this arena, so they are changed with atomics. */
+  unsigned int totblock;
+  size_t mem_in_use, peak_mem;
+  /* Bytes of chunks requested for pools and bytes of pooled blocks in use, including headers. */
+  size_t pool_reserved, pool_in_use;
+  /* Change of #mem_in_use not added to the global counter yet. */
+  int64_t mem_unflushed;
+
+  /* Non-zero after the owning thread has exited, the arena is then reused by the next thread
+   * which needs an arena. Blocks are not owned by a thread but by an arena, so arenas are never
+   * freed. */
+  uint32_t is_abandoned;
+  MemArena *next;
+};
+
+static MemArena *arenas = NULL;
+static pthread_key_t arena_key;
+static pthread_once_t arena_key_once = PTHREAD_ONCE_INIT;
+
+static int64_t mem_in_use_flushed = 0;
+static size_t peak_mem = 0;
+static bool malloc_debug_memset = false;
+
+static void (*error_callback)(const char *) = NULL;
+
+enum {
+  MEMHEAD_ALIGN_FLAG = 1,
+  MEMHEAD_POOLED_FLAG = 2,
+};
+
+#define MEMHEAD_FLAGS_MASK ((size_t)(MEMHEAD_ALIGN_FLAG | MEMHEAD_POOLED_FLAG))
+
+#define MEMHEAD_FROM_PTR(ptr) (((MemHead *)ptr) - 1)
+#define PTR_FROM_MEMHEAD(memhead) (memhead + 1)
+#define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned *)ptr) - 1)
+#define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t)MEMHEAD_ALIGN_FLAG)
+#define MEMHEAD_IS_POOLED(memhead) ((memhead)->len & (size_t)MEMHEAD_POOLED_FLAG)
+
+MEM_INLINE void update_maximum(size_t *maximum_value, size_t value)
+{
+  atomic_fetch_and_update_max_z(maximum_value, value);
+}
+
+#ifdef __GNUC__
+__attribute__((format(printf, 1, 2)))
+#endif
+static void
+print_error(const char *str, ...)
+{
+  char buf[512];
+  va_list ap;
+
+  va_start(ap, str);
+  vsnprintf(buf, sizeof(buf), str, ap);
+  va_end(ap);
+  buf[sizeof(buf) - 1] = '\0';
+
+  if (error_callback) {
+    error_callback(buf);
+  }
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Thread Arenas
+ * \{ */
+
+static void memory_usage_flush(MemArena *arena)
+{
+  int64_t delta;
+  do {
+    delta = arena->mem_unflushed;
+  } while (atomic_cas_int64(&arena->mem_unflushed, delta, 0) != delta);
+
+  const int64_t total = atomic_add_and_fetch_int64(&mem_in_use_flushed, delta);
+  if (total > 0) {
+    update_maximum(&peak_mem, (size_t)total);
+  }
+}
+
+static void arena_abandon(void *arena_v)
+{
+  MemArena *arena = (MemArena *)arena_v;
+  memory_usage_flush(arena);
+  atomic_cas_uint32(&arena->is_abandoned, 0, 1);
+}
+
+static void arena_key_create(void)
+{
+  pthread_key_create(&arena_key, arena_abandon);
+}
+
+static MemArena *arena_acquire(void)
+{
+  MemArena *arena = NULL;
+
+  /* Prefer arenas of exited threads, to reuse their pools. */
+  for (MemArena *iter = arenas; iter; iter = iter->next) {
+    if (iter->is_abandoned && atomic_cas_uint32(&iter->is_abandoned, 1, 0) == 1) {
+      arena = iter;
+      break;
+    }
+  }
+
+  if (arena == NULL) {
+    arena = (MemArena *)calloc(1, sizeof(MemArena));
+    if (UNLIKELY(arena == NULL)) {
+      print_error("Could not allocate memory arena for thread\n");
+      abort();
+    }
+    MemArena *head;
+    do {
+      head = arenas;
+      arena->next = head;
+    } while (atomic_cas_ptr((void **)&arenas, head, arena) != head);
+  }
+
+  pthread_setspecific(arena_key, arena);
+  return arena;
+}
+
+MEM_INLINE MemArena *arena_get(void)
+{
+  pthread_once(&arena_key_once, arena_key_create);
+  MemArena *arena = (MemArena *)pthread_getspecific(arena_key);
+  if (UNLIKELY(arena == NULL)) {
+    arena = arena_acquire();
+  }
+  return arena;
+}
+
+MEM_INLINE void memory_usage_add(MemArena *arena, size_t len, size_t pool_len)
+{
+  atomic_add_and_fetch_u(&arena->totblock, 1);
+  update_maximum(&arena->peak_mem, atomic_add_and_fetch_z(&arena->mem_in_use, len));
+  if (pool_len) {
+    atomic_add_and_fetch_z(&arena->pool_in_use, pool_len);
+  }
+  if (atomic_add_and_fetch_int64(&arena->mem_unflushed, (int64_t)len) > PEAK_FLUSH_THRESHOLD) {
+    memory_usage_flush(arena);
+  }
+}
+
+MEM_INLINE void memory_usage_sub(MemArena *arena, size_t len, size_t pool_len)
+{
+  atomic_sub_and_fetch_u(&arena->totblock, 1);
+  atomic_sub_and_fetch_z(&arena->mem_in_use, len);
+  if (pool_len) {
+    atomic_sub_and_fetch_z(&arena->pool_in_use, pool_len);
+  }
+  if (atomic_sub_and_fetch_int64(&arena->mem_unflushed, (int64_t)len) < -PEAK_FLUSH_THRESHOLD) {
+    memory_usage_flush(arena);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Pooled Blocks
+ * \{ */
+
+MEM_INLINE int pool_size_class(size_t len)
+{
+  return len == 0 ? 0 : (int)((len - 1) / POOL_SIZE_CLASS_STEP);
+}
+
+MEM_INLINE size_t pool_block_size(int size_class)
+{
+  return sizeof(MemHead) + (size_t)(size_class + 1) * POOL_SIZE_CLASS_STEP;
+}
+
+static MemFreeBlock *free_blocks_take_all(MemFreeBlock **free_blocks)
+{
+  MemFreeBlock *head;
+  do {
+    head = *free_blocks;
+  } while (head && atomic_cas_ptr((void **)free_blocks, head, NULL) != head);
+  return head;
+}
+
+static bool arena_chunk_add(MemArena *arena)
+{
+  MemPoolChunk *chunk = (MemPoolChunk *)malloc(POOL_CHUNK_SIZE);
+  if (UNLIKELY(chunk == NULL)) {
+    return false;
+  }
+  chunk->next = arena->chunks;
+  chunk->size = POOL_CHUNK_SIZE;
+  arena->chunks = chunk;
+  arena->chunk_free_begin = (char *)(chunk + 1);
+  arena->chunk_free_end = (char *)chunk + POOL_CHUNK_SIZE;
+  atomic_add_and_fetch_z(&arena->pool_reserved, POOL_CHUNK_SIZE);
+  return true;
+}
+
+/* Returns the header of an unused block of the size class, or null when out of memory. */
+static MemHead *pool_block_alloc(MemArena *arena, int size_class)
+{
+  MemFreeBlock *block = arena->free_blocks[size_class];
+  if (block == NULL) {
+    block = free_blocks_take_all(&arena->remote_free_blocks[size_class]);
+  }
+  if (block) {
+    arena->free_blocks[size_class] = block->next;
+    return (MemHead *)block;
+  }
+
+  const size_t block_size = pool_block_size(size_class);
+  if ((size_t)(arena->chunk_free_end - arena->chunk_free_begin) < block_size) {
+    if (!arena_chunk_add(arena)) {
+      return NULL;
+    }
+  }
+  MemHead *memh = (MemHead *)arena->chunk_free_begin;
+  arena->chunk_free_begin += block_size;
+  return memh;
+}
+
+static void pool_block_free(MemArena *arena, MemHead *memh, int size_class)
+{
+  MemFreeBlock *block = (MemFreeBlock *)memh;
+  if (arena == (MemArena *)pthread_getspecific(arena_key)) {
+    block->next = arena->free_blocks[size_class];
+    arena->free_blocks[size_class] = block;
+    return;
+  }
+
+  MemFreeBlock **free_blocks = &arena->remote_free_blocks[size_class];
+  MemFreeBlock *head;
+  do {
+    head = *free_blocks;
+    block->next = head;
+  } while (atomic_cas_ptr((void **)free_blocks, head, block) != head);
+}
+
+/** \} */
+
+size_t MEM_pooled_allocN_len(const void *vmemh)
+{
+  if (vmemh) {
+    return MEMHEAD_FROM_PTR(vmemh)->len & ~MEMHEAD_FLAGS_MASK;
+  }
+
+  return 0;
+}
+
+void MEM_pooled_freeN(void *vmemh)
+{
+  if (leak_detector_has_run) {
+    print_error("%s\n", free_after_leak_detection_message);
+  }
+
+  if (vmemh == NULL) {
+    print_error("Attempt to free NULL pointer\n");
+#ifdef WITH_ASSERT_ABORT
+    abort();
+#endif
+    return;
+  }
+
+  MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+  MemArena *arena = memh->arena;
+  size_t len = MEM_pooled_allocN_len(vmemh);
+
+  if (UNLIKELY(malloc_debug_memset && len)) {
+    memset(memh + 1, 255, len);
+  }
+  if (MEMHEAD_IS_POOLED(memh)) {
+    const int size_class = pool_size_class(len);
+    memory_usage_sub(arena, len, pool_block_size(size_class));
+    pool_block_free(arena, memh, size_class);
+  }
+  else if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh))) {
+    memory_usage_sub(arena, len, 0);
+    MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+    aligned_free(MEMHEAD_REAL_PTR(memh_aligned));
+  }
+  else {
+    memory_usage_sub(arena, len, 0);
+    free(memh);
+  }
+}
+
+void *MEM_pooled_dupallocN(const void *vmemh)
+{
+  void *newp = NULL;
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    const size_t prev_size = MEM_pooled_allocN_len(vmemh);
+    if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh))) {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_pooled_mallocN_aligned(
+          prev_size, (size_t)memh_aligned->alignment, "dupli_malloc");
+    }
+    else {
+      newp = MEM_pooled_mallocN(prev_size, "dupli_malloc");
+    }
+    memcpy(newp, vmemh, prev_size);
+  }
+  return newp;
+}
+
+void *MEM_pooled_reallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    size_t old_len = MEM_pooled_allocN_len(vmemh);
+
+    if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
+      newp = MEM_pooled_mallocN(len, "realloc");
+    }
+    else {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_pooled_mallocN_aligned(len, (size_t)memh_aligned->alignment, "realloc");
+    }
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        /* grow (or remain same size) */
+        memcpy(newp, vmemh, old_len);
+      }
+    }
+
+    MEM_pooled_freeN(vmemh);
+  }
+  else {
+    newp = MEM_pooled_mallocN(len, str);
+  }
+
+  return newp;
+}
+
+void *MEM_pooled_recallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    size_t old_len = MEM_pooled_allocN_len(vmemh);
+
+    if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
+      newp = MEM_pooled_mallocN(len, "recalloc");
+    }
+    else {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_pooled_mallocN_aligned(len, (size_t)memh_aligned->alignment, "recalloc");
+    }
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        memcpy(newp, vmemh, old_len);
+
+        if (len > old_len) {
+          /* grow */
+          /* zero new bytes */
+          memset(((char *)newp) + old_len, 0, len - old_len);
+        }
+      }
+    }
+
+    MEM_pooled_freeN(vmemh);
+  }
+  else {
+    newp = MEM_pooled_callocN(len, str);
+  }
+
+  return newp;
+}
+
+/* Allocates a block with an unaligned header, from the pool of the arena if it is small enough.
+ * Returns the header without initializing it. */
+static MemHead *memh_alloc(MemArena *arena, size_t len, bool clear, size_t *r_pool_len)
+{
+  if (len <= POOL_MAX_SIZE) {
+    const int size_class = pool_size_class(len);
+    MemHead *memh = pool_block_alloc(arena, size_class);
+    if (LIKELY(memh) && clear) {
+      memset(memh + 1, 0, len);
+    }
+    *r_pool_len = pool_block_size(size_class);
+    return memh;
+  }
+  *r_pool_len = 0;
+  if (clear) {
+    return (MemHead *)calloc(1, len + sizeof(MemHead));
+  }
+  return (MemHead *)malloc(len + sizeof(MemHead));
+}
+
+void *MEM_pooled_callocN(size_t len, const char *str)
+{
+  MemArena *arena = arena_get();
+  size_t pool_len;
+
+  len = SIZET_ALIGN_4(len);
+
+  MemHead *memh = memh_alloc(arena, len, true, &pool_len);
+
+  if (LIKELY(memh)) {
+    memh->arena = arena;
+    memh->len = len | (pool_len ? (size_t)MEMHEAD_POOLED_FLAG : 0);
+    memory_usage_add(arena, len, pool_len);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Calloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)MEM_pooled_get_memory_in_use());
+  return NULL;
+}
+
+void *MEM_pooled_calloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Calloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)MEM_pooled_get_memory_in_use());
+    abort();
+    return NULL;
+  }
+
+  return MEM_pooled_callocN(total_size, str);
+}
+
+void *MEM_pooled_mallocN(size_t len, const char *str)
+{
+  MemArena *arena = arena_get();
+  size_t pool_len;
+
+  len = SIZET_ALIGN_4(len);
+
+  MemHead *memh = memh_alloc(arena, len, false, &pool_len);
+
+  if (LIKELY(memh)) {
+    if (UNLIKELY(malloc_debug_memset && len)) {
+      memset(memh + 1, 255, len);
+    }
+
+    memh->arena = arena;
+    memh->len = len | (pool_len ? (size_t)MEMHEAD_POOLED_FLAG : 0);
+    memory_usage_add(arena, len, pool_len);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)MEM_pooled_get_memory_in_use());
+  return NULL;
+}
+
+void *MEM_pooled_malloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Malloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)MEM_pooled_get_memory_in_use());
+    abort();
+    return NULL;
+  }
+
+  return MEM_pooled_mallocN(total_size, str);
+}
+
+void *MEM_pooled_mallocN_aligned(size_t len, size_t alignment, const char *str)
+{
+  /* Huge alignment values doesn't make sense and they wouldn't fit into 'short' used in the
+   * MemHead. */
+  assert(alignment < 1024);
+
+  /* We only support alignments that are a power of two. */
+  assert(IS_POW2(alignment));
+
+  /* Some OS specific aligned allocators require a certain minimal alignment. */
+  if (alignment < ALIGNED_MALLOC_MINIMUM_ALIGNMENT) {
+    alignment = ALIGNED_MALLOC_MINIMUM_ALIGNMENT;
+  }
+
+  /* Aligned blocks are not pooled, the padding would waste most of the gain for small blocks. */
+  MemArena *arena = arena_get();
+  size_t extra_padding = MEMHEAD_ALIGN_PADDING(alignment);
+
+  len = SIZET_ALIGN_4(len);
+
+  MemHeadAligned *memh = (MemHeadAligned *)aligned_malloc(
+      len + extra_padding + sizeof(MemHeadAligned), alignment);
+
+  if (LIKELY(memh)) {
+    memh = (MemHeadAligned *)((char *)memh + extra_padding);
+
+    if (UNLIKELY(malloc_debug_memset && len)) {
+      memset(memh + 1, 255, len);
+    }
+
+    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG;
+    memh->alignment = (short)alignment;
+    memh->arena = arena;
+    memory_usage_add(arena, len, 0);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)MEM_pooled_get_memory_in_use());
+  return NULL;
+}
+
+void MEM_pooled_printmemlist_pydict(void)
+{
+}
+
+void MEM_pooled_printmemlist(void)
+{
+}
+
+/* unused */
+void MEM_pooled_callbackmemlist(void (*func)(void *))
+{
+  (void)func; /* Ignored. */
+}
+
+void MEM_pooled_printmemlist_stats(void)
+{
+  printf("\ntotal memory len: %.3f MB\n",
+         (double)MEM_pooled_get_memory_in_use() / (double)(1024 * 1024));
+  printf("peak memory len: %.3f MB\n",
+         (double)MEM_pooled_get_peak_memory() / (double)(1024 * 1024));
+  printf("pool fragmentation: %.1f%%\n", (double)MEM_pooled_get_fragmentation() * 100.0);
+
+  printf("\nthread  blocks      in use MB   peak MB     pool MB     pool used MB\n");
+  int index = 0;
+  for (MemArena *arena = arenas; arena; arena = arena->next, index++) {
+    printf("%-7d %-11u %-11.3f %-11.3f %-11.3f %-11.3f%s\n",
+           index,
+           arena->totblock,
+           (double)arena->mem_in_use / (double)(1024 * 1024),
+           (double)arena->peak_mem / (double)(1024 * 1024),
+           (double)arena->pool_reserved / (double)(1024 * 1024),
+           (double)arena->pool_in_use / (double)(1024 * 1024),
+           arena->is_abandoned ? " (exited)" : "");
+  }
+
+#ifdef HAVE_MALLOC_STATS
+  printf("System Statistics:\n");
+  malloc_stats();
+#endif
+}
+
+void MEM_pooled_set_error_callback(void (*func)(const char *))
+{
+  error_callback = func;
+}
+
+bool MEM_pooled_consistency_check(void)
+{
+  return true;
+}
+
+void MEM_pooled_set_memory_debug(void)
+{
+  malloc_debug_memset = true;
+}
+
+size_t MEM_pooled_get_memory_in_use(void)
+{
+  size_t mem_in_use = 0;
+  for (MemArena *arena = arenas; arena; arena = arena->next) {
+    mem_in_use += arena->mem_in_use;
+  }
+  return mem_in_use;
+}
+
+unsigned int MEM_pooled_get_memory_blocks_in_use(void)
+{
+  unsigned int totblock = 0;
+  for (MemArena *arena = arenas; arena; arena = arena->next) {
+    totblock += arena->totblock;
+  }
+  return totblock;
+}
+
+void MEM_pooled_reset_peak_memory(void)
+{
+  peak_mem = MEM_pooled_get_memory_in_use();
+  for (MemArena *arena = arenas; arena; arena = arena->next) {
+    arena->peak_mem = arena->mem_in_use;
+  }
+}
+
+size_t MEM_pooled_get_peak_memory(void)
+{
+  /* The global peak misses changes not flushed yet, but it's at least the current usage and the
+   * peak of every single thread. */
+  size_t result = peak_mem;
+  size_t mem_in_use = 0;
+  for (MemArena *arena = arenas; arena; arena = arena->next) {
+    mem_in_use += arena->mem_in_use;
+    result = arena->peak_mem > result ? arena->peak_mem : result;
+  }
+  return mem_in_use > result ? mem_in_use : result;
+}
+
+int MEM_pooled_get_thread_stats(MEM_ThreadStats *r_stats, int stats_num)
+{
+  int index = 0;
+  for (MemArena *arena = arenas; arena && index < stats_num; arena = arena->next, index++) {
+    MEM_ThreadStats *stats = &r_stats[index];
+    stats->blocks_in_use = arena->totblock;
+    stats->mem_in_use = arena->mem_in_use;
+    stats->peak_mem = arena->peak_mem;
+    stats->pool_reserved = arena->pool_reserved;
+    stats->pool_in_use = arena->pool_in_use;
+  }
+  return index;
+}
+
+float MEM_pooled_get_fragmentation(void)
+{
+  size_t pool_reserved = 0, pool_in_use = 0;
+  for (MemArena *arena = arenas; arena; arena = arena->next) {
+    pool_reserved += arena->pool_reserved;
+    pool_in_use += arena->pool_in_use;
+  }
+  if (pool_reserved == 0) {
+    return 0.0f;
+  }
+  return (float)(pool_reserved - pool_in_use) / (float)pool_reserved;
+}
+
+#ifndef NDEBUG
+const char *MEM_pooled_name_ptr(void *vmemh)
+{
+  if (vmemh) {
+    return "unknown block name ptr";
+  }
+
+  return "MEM_pooled_name_ptr(NULL)";
+}
+#endif /* NDEBUG */
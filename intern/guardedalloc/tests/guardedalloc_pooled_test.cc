@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <thread>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "guardedalloc_test_base.h"
+
+namespace {
+
+void AllocateBlocks(std::vector<void *> &r_blocks, const int blocks_num)
+{
+  for (int i = 0; i < blocks_num; i++) {
+    /* Mix pooled and system allocations. */
+    const size_t len = (i % 7 == 0) ? 4096 : size_t(i % 500);
+    char *block = (char *)MEM_mallocN(len, __func__);
+    memset(block, i & 0xff, len);
+    r_blocks.push_back(block);
+  }
+}
+
+}  // namespace
+
+TEST_F(PooledAllocatorTest, Basic)
+{
+  char *a = (char *)MEM_callocN(24, __func__);
+  for (int i = 0; i < 24; i++) {
+    EXPECT_EQ(a[i], 0);
+  }
+  EXPECT_EQ(MEM_allocN_len(a), 24);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), 1);
+
+  a = (char *)MEM_reallocN(a, 2000);
+  EXPECT_EQ(MEM_allocN_len(a), 2000);
+  a = (char *)MEM_reallocN(a, 100);
+  EXPECT_EQ(MEM_allocN_len(a), 100);
+  char *b = (char *)MEM_dupallocN(a);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), 2);
+  EXPECT_EQ(MEM_get_memory_in_use(), 200);
+
+  MEM_freeN(a);
+  MEM_freeN(b);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), 0);
+  EXPECT_EQ(MEM_get_memory_in_use(), 0);
+}
+
+TEST_F(PooledAllocatorTest, FreeOnOtherThreads)
+{
+  const int threads_num = 8;
+  const int blocks_num = 10000;
+
+  /* Every thread frees the blocks allocated by the next one. */
+  std::vector<std::vector<void *>> blocks(threads_num);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threads_num; i++) {
+    threads.emplace_back([&, i]() { AllocateBlocks(blocks[i], blocks_num); });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), threads_num * blocks_num);
+
+  threads.clear();
+  for (int i = 0; i < threads_num; i++) {
+    threads.emplace_back([&, i]() {
+      for (void *block : blocks[(i + 1) % threads_num]) {
+        MEM_freeN(block);
+      }
+      /* Reuse blocks freed by other threads. */
+      blocks[(i + 1) % threads_num].clear();
+      AllocateBlocks(blocks[(i + 1) % threads_num], blocks_num);
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), threads_num * blocks_num);
+
+  for (std::vector<void *> &thread_blocks : blocks) {
+    for (void *block : thread_blocks) {
+      MEM_freeN(block);
+    }
+  }
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), 0);
+  EXPECT_EQ(MEM_get_memory_in_use(), 0);
+}
+
+TEST_F(PooledAllocatorTest, ThreadStats)
+{
+  MEM_reset_peak_memory();
+
+  std::vector<void *> blocks;
+  std::thread thread([&]() { AllocateBlocks(blocks, 1000); });
+  thread.join();
+  const size_t mem_in_use = MEM_get_memory_in_use();
+
+  MEM_ThreadStats stats[64];
+  const int stats_num = MEM_get_thread_stats(stats, 64);
+  EXPECT_GT(stats_num, 0);
+  size_t stats_mem_in_use = 0;
+  unsigned int stats_blocks_in_use = 0;
+  for (int i = 0; i < stats_num; i++) {
+    stats_mem_in_use += stats[i].mem_in_use;
+    stats_blocks_in_use += stats[i].blocks_in_use;
+    EXPECT_LE(stats[i].pool_in_use, stats[i].pool_reserved);
+  }
+  EXPECT_EQ(stats_mem_in_use, mem_in_use);
+  EXPECT_EQ(stats_blocks_in_use, 1000);
+
+  for (void *block : blocks) {
+    MEM_freeN(block);
+  }
+  EXPECT_GE(MEM_get_peak_memory(), mem_in_use);
+  EXPECT_GT(MEM_get_fragmentation(), 0.0f);
+  EXPECT_LE(MEM_get_fragmentation(), 1.0f);
+}
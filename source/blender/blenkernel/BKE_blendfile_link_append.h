@@ -206,6 +206,18 @@ void BKE_blendfile_library_relocate(struct BlendfileLinkAppendContext *lapp_cont
                                     struct Library *library,
                                     bool do_reload);
 
+/**
+ * Read the actual data of lazily linked IDs (see #LIB_TAG_LAZY_LINK) tagged with #LIB_TAG_DOIT
+ * from their libraries, replacing their place-holders.
+ *
+ * Dependencies of the loaded IDs are linked lazily again.
+ * The caller is responsible for tagging depsgraph relations for update.
+ */
+void BKE_blendfile_lazy_link_load_tagged(struct Main *bmain,
+                                         struct Scene *scene,
+                                         struct ViewLayer *view_layer,
+                                         struct ReportList *reports);
+
 #ifdef __cplusplus
 }
 #endif
@@ -315,6 +315,9 @@ typedef struct bNodeType {
   /* Execute a geometry node. */
   NodeGeometryExecFunction geometry_node_execute;
   bool geometry_node_execute_supports_laziness;
+  /* The outputs only depend on the inputs and properties of the node and computing them is
+   * expensive enough that it is worth keeping them between evaluations of the node tree. */
+  bool geometry_node_execute_supports_caching;
 
   /* Declares which sockets the node has. */
   NodeDeclareFunction declare;
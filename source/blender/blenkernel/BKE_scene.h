@@ -19,6 +19,7 @@ struct GHash;
 struct Main;
 struct Object;
 struct RenderData;
+struct ReportList;
 struct Scene;
 struct TransformOrientation;
 struct UnitSettings;
@@ -197,6 +198,27 @@ int BKE_scene_orientation_get_index_from_flag(struct Scene *scene, int flag);
 void BKE_scene_update_sound(struct Depsgraph *depsgraph, struct Main *bmain);
 void BKE_scene_update_tag_audio_volume(struct Depsgraph *, struct Scene *scene);
 
+/**
+ * Read the data of lazily linked IDs (see #LIB_TAG_LAZY_LINK) used by the depsgraph, which can in
+ * turn bring in more lazily linked dependencies. Only possible from the main thread.
+ *
+ * \return The number of loaded IDs.
+ */
+int BKE_scene_graph_lazy_link_load(struct Depsgraph *depsgraph,
+                                   struct Main *bmain,
+                                   struct ReportList *reports);
+/**
+ * Read the data of lazily linked IDs needed to render the scene, or only its \a single_layer.
+ * Renders can run in a job thread and build their depsgraphs there, so this has to be done on
+ * the main thread before.
+ *
+ * \return The number of loaded IDs.
+ */
+int BKE_scene_lazy_link_load_for_render(struct Main *bmain,
+                                        struct Scene *scene,
+                                        struct ViewLayer *single_layer,
+                                        struct ReportList *reports);
+
 void BKE_scene_graph_update_tagged(struct Depsgraph *depsgraph, struct Main *bmain);
 void BKE_scene_graph_evaluated_ensure(struct Depsgraph *depsgraph, struct Main *bmain);
 
@@ -1426,10 +1426,14 @@ static void blendfile_library_relocate_remap(Main *bmain,
   }
 }
 
-void BKE_blendfile_library_relocate(BlendfileLinkAppendContext *lapp_context,
-                                    ReportList *reports,
-                                    Library *library,
-                                    const bool do_reload)
+/**
+ * \param only_tagged: Only relocate the IDs of \a library tagged with #LIB_TAG_DOIT.
+ */
+static void blendfile_library_relocate_ex(BlendfileLinkAppendContext *lapp_context,
+                                          ReportList *reports,
+                                          Library *library,
+                                          const bool do_reload,
+                                          const bool only_tagged)
 {
   ListBase *lbarray[INDEX_ID_MAX];
   int lba_idx;
@@ -1457,7 +1461,7 @@ void BKE_blendfile_library_relocate(BlendfileLinkAppendContext *lapp_context,
     }
 
     for (; id; id = id->next) {
-      if (id->lib == library) {
+      if (id->lib == library && (!only_tagged || (id->tag & LIB_TAG_DOIT))) {
         BlendfileLinkAppendContextItem *item;
 
         /* We remove it from current Main, and add it to items to link... */
@@ -1652,4 +1656,101 @@ void BKE_blendfile_library_relocate(BlendfileLinkAppendContext *lapp_context,
   BKE_main_collection_sync(bmain);
 }
 
+void BKE_blendfile_library_relocate(BlendfileLinkAppendContext *lapp_context,
+                                    ReportList *reports,
+                                    Library *library,
+                                    const bool do_reload)
+{
+  blendfile_library_relocate_ex(lapp_context, reports, library, do_reload, false);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Lazy Linking
+ * \{ */
+
+/** Tag the lazily linked IDs of \a library in \a requested_uuids, return whether any was found. */
+static bool lazy_link_tag_requested(Main *bmain, const Library *library, GSet *requested_uuids)
+{
+  bool found = false;
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    id->tag &= ~LIB_TAG_DOIT;
+    if (id->lib == library && (id->tag & LIB_TAG_LAZY_LINK) &&
+        BLI_gset_haskey(requested_uuids, POINTER_FROM_UINT(id->session_uuid))) {
+      id->tag |= LIB_TAG_DOIT;
+      found = true;
+    }
+  }
+  FOREACH_MAIN_ID_END;
+  return found;
+}
+
+void BKE_blendfile_lazy_link_load_tagged(Main *bmain,
+                                         Scene *scene,
+                                         ViewLayer *view_layer,
+                                         ReportList *reports)
+{
+  /* Tags get cleared when relocating, so identify the requested IDs by their session UUID. */
+  GSet *requested_uuids = BLI_gset_int_new(__func__);
+  GSet *libraries = BLI_gset_ptr_new(__func__);
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    if ((id->tag & (LIB_TAG_LAZY_LINK | LIB_TAG_DOIT)) == (LIB_TAG_LAZY_LINK | LIB_TAG_DOIT)) {
+      BLI_gset_add(requested_uuids, POINTER_FROM_UINT(id->session_uuid));
+      BLI_gset_add(libraries, id->lib);
+    }
+  }
+  FOREACH_MAIN_ID_END;
+
+  GSET_FOREACH_BEGIN (Library *, library, libraries) {
+    if (!lazy_link_tag_requested(bmain, library, requested_uuids)) {
+      continue;
+    }
+    CLOG_INFO(&LOG, 2, "Lazy loading data-blocks from '%s'", library->filepath_abs);
+
+    LibraryLink_Params lapp_params;
+    BLO_library_link_params_init_with_context(
+        &lapp_params,
+        bmain,
+        BLO_LIBLINK_USE_PLACEHOLDERS | BLO_LIBLINK_FORCE_INDIRECT | BLO_LIBLINK_USE_LAZY,
+        0,
+        scene,
+        view_layer,
+        NULL);
+    BlendfileLinkAppendContext *lapp_context = BKE_blendfile_link_append_context_new(
+        &lapp_params);
+    BKE_blendfile_link_append_context_library_add(lapp_context, library->filepath_abs, NULL);
+
+    blendfile_library_relocate_ex(lapp_context, reports, library, true, true);
+
+    BKE_blendfile_link_append_context_free(lapp_context);
+  }
+  GSET_FOREACH_END();
+
+  /* Data-blocks that could not be read (e.g. when the library is not available anymore) are
+   * turned into regular missing place-holders, so that they are not requested again. */
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    id->tag &= ~LIB_TAG_DOIT;
+    if ((id->tag & LIB_TAG_LAZY_LINK) &&
+        BLI_gset_haskey(requested_uuids, POINTER_FROM_UINT(id->session_uuid))) {
+      id->tag &= ~LIB_TAG_LAZY_LINK;
+      id->tag |= LIB_TAG_MISSING;
+      BKE_reportf(reports,
+                  RPT_WARNING,
+                  "Lazy Link: could not read data-block '%s' from library '%s'",
+                  id->name,
+                  id->lib->filepath_abs);
+    }
+  }
+  FOREACH_MAIN_ID_END;
+
+  BLI_gset_free(requested_uuids, NULL);
+  BLI_gset_free(libraries, NULL);
+
+  BKE_main_lib_objects_recalc_all(bmain);
+  BKE_main_id_tag_all(bmain, LIB_TAG_PRE_EXISTING, false);
+}
+
 /** \} */
@@ -123,10 +123,29 @@ static void mesh_copy_data(Main *bmain, ID *id_dst, const ID *id_src, const int
   BKE_defgroup_copy_list(&mesh_dst->vertex_group_names, &mesh_src->vertex_group_names);
 
   const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ? CD_REFERENCE : CD_DUPLICATE;
-  CustomData_copy(&mesh_src->vdata, &mesh_dst->vdata, mask.vmask, alloc_type, mesh_dst->totvert);
-  CustomData_copy(&mesh_src->edata, &mesh_dst->edata, mask.emask, alloc_type, mesh_dst->totedge);
-  CustomData_copy(&mesh_src->ldata, &mesh_dst->ldata, mask.lmask, alloc_type, mesh_dst->totloop);
-  CustomData_copy(&mesh_src->pdata, &mesh_dst->pdata, mask.pmask, alloc_type, mesh_dst->totpoly);
+  /* The domains are independent, copy them in parallel when duplicating large meshes. This is
+   * mainly for the copy-on-write of the first evaluation of a scene, where a few huge meshes
+   * can take longer to copy than all other data-blocks together. */
+  const bool copy_in_parallel = (alloc_type == CD_DUPLICATE) &&
+                                (mesh_src->totvert + mesh_src->totloop >= 100000);
+  blender::threading::parallel_invoke(
+      copy_in_parallel,
+      [&]() {
+        CustomData_copy(
+            &mesh_src->vdata, &mesh_dst->vdata, mask.vmask, alloc_type, mesh_dst->totvert);
+      },
+      [&]() {
+        CustomData_copy(
+            &mesh_src->edata, &mesh_dst->edata, mask.emask, alloc_type, mesh_dst->totedge);
+      },
+      [&]() {
+        CustomData_copy(
+            &mesh_src->ldata, &mesh_dst->ldata, mask.lmask, alloc_type, mesh_dst->totloop);
+      },
+      [&]() {
+        CustomData_copy(
+            &mesh_src->pdata, &mesh_dst->pdata, mask.pmask, alloc_type, mesh_dst->totpoly);
+      });
   if (do_tessface) {
     CustomData_copy(&mesh_src->fdata, &mesh_dst->fdata, mask.fmask, alloc_type, mesh_dst->totface);
   }
@@ -55,6 +55,7 @@
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
 #include "BKE_armature.h"
+#include "BKE_blendfile_link_append.h"
 #include "BKE_bpath.h"
 #include "BKE_cachefile.h"
 #include "BKE_collection.h"
@@ -2562,6 +2563,80 @@ void BKE_scene_update_tag_audio_volume(Depsgraph *UNUSED(depsgraph), Scene *scen
   scene->id.recalc |= ID_RECALC_AUDIO_VOLUME;
 }
 
+int BKE_scene_graph_lazy_link_load(Depsgraph *depsgraph, Main *bmain, ReportList *reports)
+{
+  BLI_assert(BLI_thread_is_main());
+  Scene *scene = DEG_get_input_scene(depsgraph);
+  ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
+  int loaded_num = 0;
+
+  DEG_graph_relations_update(depsgraph);
+  int tagged_num;
+  while ((tagged_num = DEG_graph_lazy_link_ids_tag(depsgraph)) != 0) {
+    BKE_blendfile_lazy_link_load_tagged(bmain, scene, view_layer, reports);
+    DEG_relations_tag_update(bmain);
+    DEG_graph_relations_update(depsgraph);
+    loaded_num += tagged_num;
+  }
+  return loaded_num;
+}
+
+static bool main_has_lazy_link_ids(Main *bmain)
+{
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    if (id->tag & LIB_TAG_LAZY_LINK) {
+      return true;
+    }
+  }
+  FOREACH_MAIN_ID_END;
+  return false;
+}
+
+static int scene_lazy_link_load_for_graph(Main *bmain,
+                                          Scene *scene,
+                                          ViewLayer *view_layer,
+                                          const bool for_render_pipeline,
+                                          ReportList *reports)
+{
+  Depsgraph *depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(depsgraph, "LAZY LINK");
+  if (for_render_pipeline) {
+    DEG_graph_build_for_render_pipeline(depsgraph);
+  }
+  else {
+    DEG_graph_build_from_view_layer(depsgraph);
+  }
+  const int loaded_num = BKE_scene_graph_lazy_link_load(depsgraph, bmain, reports);
+  DEG_graph_free(depsgraph);
+  return loaded_num;
+}
+
+int BKE_scene_lazy_link_load_for_render(Main *bmain,
+                                        Scene *scene,
+                                        ViewLayer *single_layer,
+                                        ReportList *reports)
+{
+  BLI_assert(BLI_thread_is_main());
+  /* Avoid building graphs for the common case of files without lazily linked data. */
+  if (!main_has_lazy_link_ids(bmain)) {
+    return 0;
+  }
+
+  /* Compositor and sequencer data used by the render pipeline itself. */
+  int loaded_num = scene_lazy_link_load_for_graph(
+      bmain, scene, BKE_view_layer_default_render(scene), true, reports);
+
+  /* Data of the view layers which are handed to render engines. */
+  LISTBASE_FOREACH (ViewLayer *, view_layer, &scene->view_layers) {
+    if (single_layer ? (view_layer != single_layer) : !(view_layer->flag & VIEW_LAYER_RENDER)) {
+      continue;
+    }
+    loaded_num += scene_lazy_link_load_for_graph(bmain, scene, view_layer, false, reports);
+  }
+  return loaded_num;
+}
+
 /* TODO(sergey): This actually should become view_layer_graph or so.
  * Same applies to update_for_newframe.
  *
@@ -2574,6 +2649,11 @@ static void scene_graph_update_tagged(Depsgraph *depsgraph, Main *bmain, bool on
     return;
   }
 
+  if (BLI_thread_is_main()) {
+    /* Data of lazily linked IDs has to be read before evaluation, which modifies main. */
+    BKE_scene_graph_lazy_link_load(depsgraph, bmain, nullptr);
+  }
+
   Scene *scene = DEG_get_input_scene(depsgraph);
   ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
   bool used_multiple_passes = false;
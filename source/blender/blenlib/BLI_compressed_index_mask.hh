@@ -0,0 +1,299 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * A #CompressedIndexMask contains the same kind of data as an #IndexMask: a sorted set of
+ * non-negative indices without duplicates. Different from #IndexMask, it owns its indices and
+ * stores them in a compact form, which makes it suitable for selections on very large geometry.
+ *
+ * The index space is split into aligned windows of #max_segment_size indices. All indices of a
+ * mask that are in the same window form a segment. A segment stores a 64 bit offset and the
+ * indices relative to that offset as 16 bit integers. Segments that are a contiguous range of
+ * indices don't store any relative indices at all, they reference a shared static array instead.
+ *
+ * For example, a mask that selects every other point of 100 million points needs 100 MB instead
+ * of the 400 MB for 64 bit indices, and a mask that selects a few large ranges only needs a few
+ * bytes per #max_segment_size indices.
+ *
+ * The segmented layout also allows set operations (#complement, #unite, #intersect and
+ * #difference) to work on one window at a time using bit operations.
+ *
+ * Use #foreach_index or #foreach_segment to iterate over the indices. Random access with
+ * `operator[]` requires a binary search over the segments.
+ */
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_index_range.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+class CompressedIndexMask {
+ public:
+  static constexpr int64_t max_segment_size_shift = 14;
+  static constexpr int64_t max_segment_size = int64_t(1) << max_segment_size_shift;
+  static constexpr int64_t max_segment_size_mask = max_segment_size - 1;
+
+ private:
+  struct Segment {
+    /** All indices in the segment are this offset plus a relative index. */
+    int64_t offset;
+    /**
+     * Position of the relative indices of this segment in #relative_indices_. This is -1 when the
+     * segment is a contiguous range, its relative indices are then `[0, size)`.
+     */
+    int64_t relative_indices_start;
+  };
+
+  Vector<Segment, 0> segments_;
+  /** Number of indices in all segments before a segment, has one more element than segments. */
+  Vector<int64_t, 0> cumulative_segment_sizes_ = {0};
+  /** Relative indices for all segments that are not a contiguous range. */
+  Vector<int16_t, 0> relative_indices_;
+
+ public:
+  /** Creates an empty mask. */
+  CompressedIndexMask() = default;
+
+  /** Creates a mask that contains all indices in the range. This does not store any indices. */
+  explicit CompressedIndexMask(IndexRange range);
+
+  /** Creates a mask that contains all indices in `[0, n)`. */
+  explicit CompressedIndexMask(const int64_t n) : CompressedIndexMask(IndexRange(n))
+  {
+  }
+
+  /** The indices have to be sorted and must not contain duplicates. */
+  static CompressedIndexMask from_indices(Span<int64_t> indices);
+  static CompressedIndexMask from_index_mask(const IndexMask mask);
+  /** Creates a mask with all indices whose value is true. */
+  static CompressedIndexMask from_bools(Span<bool> bools);
+
+  /**
+   * Evaluate the predicate for all indices in the universe in parallel and create a mask that
+   * contains all indices for which the predicate is true.
+   */
+  template<typename Predicate>
+  static CompressedIndexMask from_predicate(IndexRange universe,
+                                            int64_t grain_size,
+                                            const Predicate &predicate);
+
+  /** Creates a mask that contains all indices in the universe that are not in this mask. */
+  CompressedIndexMask complement(IndexRange universe) const;
+  static CompressedIndexMask unite(const CompressedIndexMask &a, const CompressedIndexMask &b);
+  static CompressedIndexMask intersect(const CompressedIndexMask &a, const CompressedIndexMask &b);
+  /** Creates a mask that contains all indices of the first mask that are not in the second. */
+  static CompressedIndexMask difference(const CompressedIndexMask &a,
+                                        const CompressedIndexMask &b);
+
+  /** Number of indices in the mask. */
+  int64_t size() const
+  {
+    return cumulative_segment_sizes_.last();
+  }
+
+  bool is_empty() const
+  {
+    return this->size() == 0;
+  }
+
+  int64_t segments_num() const
+  {
+    return segments_.size();
+  }
+
+  /** Returns the n-th index in the mask. This requires a binary search over the segments. */
+  int64_t operator[](int64_t n) const;
+
+  int64_t first() const
+  {
+    BLI_assert(!this->is_empty());
+    return segments_.first().offset + this->segment_relative_indices(0).first();
+  }
+
+  int64_t last() const
+  {
+    BLI_assert(!this->is_empty());
+    return segments_.last().offset + this->segment_relative_indices(segments_.size() - 1).last();
+  }
+
+  /** Minimum size an array must have to be indexed by all indices in this mask. */
+  int64_t min_array_size() const
+  {
+    return this->is_empty() ? 0 : this->last() + 1;
+  }
+
+  /** True when the mask does not skip any indices. */
+  bool is_range() const
+  {
+    return !this->is_empty() && this->last() - this->first() == this->size() - 1;
+  }
+
+  IndexRange as_range() const
+  {
+    BLI_assert(this->is_range());
+    return IndexRange(this->first(), this->size());
+  }
+
+  /** Number of bytes used to store the mask, excluding the object itself. */
+  int64_t memory_usage() const
+  {
+    return segments_.capacity() * int64_t(sizeof(Segment)) +
+           cumulative_segment_sizes_.capacity() * int64_t(sizeof(int64_t)) +
+           relative_indices_.capacity() * int64_t(sizeof(int16_t));
+  }
+
+  /**
+   * Call the function for every segment with the segment offset and the sorted relative indices.
+   * The function can use #relative_indices_are_range to check for the common case where it can
+   * iterate over a range instead.
+   */
+  template<typename Fn> void foreach_segment(const Fn &fn) const
+  {
+    for (const int64_t segment_i : segments_.index_range()) {
+      fn(segments_[segment_i].offset, this->segment_relative_indices(segment_i));
+    }
+  }
+
+  /**
+   * Call the function for every index in ascending order. Contiguous segments are iterated over
+   * as a range, so that the compiler can optimize the loop better.
+   */
+  template<typename Fn> void foreach_index(const Fn &fn) const
+  {
+    for (const int64_t segment_i : segments_.index_range()) {
+      this->foreach_index_in_segment(segment_i, fn);
+    }
+  }
+
+  /**
+   * Same as #foreach_index, but segments are processed in parallel. The grain size is given in
+   * number of indices and rounded to whole segments.
+   */
+  template<typename Fn> void foreach_index(const int64_t grain_size, const Fn &fn) const
+  {
+    const int64_t segments_grain_size = std::max<int64_t>(1, grain_size / max_segment_size);
+    threading::parallel_for(
+        segments_.index_range(), segments_grain_size, [&](const IndexRange segments_range) {
+          for (const int64_t segment_i : segments_range) {
+            this->foreach_index_in_segment(segment_i, fn);
+          }
+        });
+  }
+
+  /** Write all indices into the span, which must have the size of the mask. */
+  void to_indices(MutableSpan<int64_t> r_indices) const;
+
+  /**
+   * Create an #IndexMask for code that does not support compressed masks yet. No indices are
+   * copied when the mask is a range, otherwise they are written to #r_indices.
+   */
+  IndexMask to_index_mask(Vector<int64_t> &r_indices) const;
+
+  /** Write true for every index in the mask, without changing other elements. */
+  void to_bools(MutableSpan<bool> r_bools) const;
+
+  static bool relative_indices_are_range(const Span<int16_t> relative_indices)
+  {
+    return relative_indices.last() - relative_indices.first() == relative_indices.size() - 1;
+  }
+
+  friend bool operator==(const CompressedIndexMask &a, const CompressedIndexMask &b);
+  friend bool operator!=(const CompressedIndexMask &a, const CompressedIndexMask &b)
+  {
+    return !(a == b);
+  }
+
+ private:
+  Span<int16_t> segment_relative_indices(const int64_t segment_i) const
+  {
+    const int64_t start = segments_[segment_i].relative_indices_start;
+    const int64_t size = cumulative_segment_sizes_[segment_i + 1] -
+                         cumulative_segment_sizes_[segment_i];
+    if (start == -1) {
+      return static_range_indices().take_front(size);
+    }
+    return relative_indices_.as_span().slice(start, size);
+  }
+
+  template<typename Fn> void foreach_index_in_segment(const int64_t segment_i, const Fn &fn) const
+  {
+    const int64_t offset = segments_[segment_i].offset;
+    const Span<int16_t> relative_indices = this->segment_relative_indices(segment_i);
+    if (relative_indices_are_range(relative_indices)) {
+      const int64_t start = offset + relative_indices.first();
+      for (const int64_t i : IndexRange(start, relative_indices.size())) {
+        fn(i);
+      }
+    }
+    else {
+      for (const int16_t i : relative_indices) {
+        fn(offset + i);
+      }
+    }
+  }
+
+  /** The relative indices `[0, max_segment_size)`, shared by all range segments. */
+  static Span<int16_t> static_range_indices();
+
+  /**
+   * Append a segment. All relative indices have to be smaller than #max_segment_size and the
+   * segment must come after all existing segments.
+   */
+  void append_segment(int64_t offset, Span<int16_t> relative_indices);
+  void append_range(IndexRange range);
+
+  /** Concatenate masks of consecutive non-overlapping windows, used by parallel construction. */
+  static CompressedIndexMask concatenate(MutableSpan<CompressedIndexMask> masks);
+
+  /** Helper for set operations that combine the masks one window at a time. */
+  enum class SetOperation { Union, Intersection, Difference };
+  static CompressedIndexMask set_operation(const CompressedIndexMask &a,
+                                           const CompressedIndexMask &b,
+                                           SetOperation operation);
+};
+
+template<typename Predicate>
+inline CompressedIndexMask CompressedIndexMask::from_predicate(const IndexRange universe,
+                                                               const int64_t grain_size,
+                                                               const Predicate &predicate)
+{
+  if (universe.is_empty()) {
+    return {};
+  }
+  /* Every task creates the segments for a number of windows, they are joined afterwards. */
+  const int64_t first_window = universe.first() >> max_segment_size_shift;
+  const int64_t windows_num = (universe.last() >> max_segment_size_shift) - first_window + 1;
+  const int64_t windows_grain_size = std::max<int64_t>(1, grain_size / max_segment_size);
+  const int64_t tasks_num = (windows_num + windows_grain_size - 1) / windows_grain_size;
+
+  Array<CompressedIndexMask> task_masks(tasks_num);
+  threading::parallel_for(IndexRange(tasks_num), 1, [&](const IndexRange tasks_range) {
+    int16_t relative_indices[max_segment_size];
+    for (const int64_t task_i : tasks_range) {
+      CompressedIndexMask &mask = task_masks[task_i];
+      const int64_t windows_start = windows_grain_size * task_i;
+      const int64_t windows_end = std::min(windows_start + windows_grain_size, windows_num);
+      for (const int64_t window_i : IndexRange(windows_start, windows_end - windows_start)) {
+        const int64_t offset = (first_window + window_i) << max_segment_size_shift;
+        const int64_t start = std::max(offset, universe.start());
+        const int64_t end = std::min(offset + max_segment_size, universe.one_after_last());
+        int64_t count = 0;
+        for (const int64_t i : IndexRange(start, end - start)) {
+          relative_indices[count] = int16_t(i - offset);
+          count += bool(predicate(i));
+        }
+        mask.append_segment(offset, Span<int16_t>(relative_indices, count));
+      }
+    }
+  });
+  return concatenate(task_masks);
+}
+
+}  // namespace blender
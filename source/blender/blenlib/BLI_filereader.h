@@ -30,12 +30,23 @@ struct FileReader;
 typedef ssize_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
 typedef off64_t (*FileReaderSeekFn)(struct FileReader *reader, off64_t offset, int whence);
 typedef void (*FileReaderCloseFn)(struct FileReader *reader);
+typedef const void *(*FileReaderMapFn)(struct FileReader *reader, off64_t offset, size_t size);
 
 /** General structure for all #FileReaders, implementations add custom fields at the end. */
 typedef struct FileReader {
   FileReaderReadFn read;
   FileReaderSeekFn seek;
   FileReaderCloseFn close;
+  /**
+   * Optional, may be NULL: access `size` bytes at `offset` without copying them, for readers
+   * that have the whole file in memory. Returns NULL when the range can't be accessed.
+   * The memory stays valid until the reader is closed and must not be modified.
+   *
+   * Accessing memory-mapped files can fail at any time (the memory then reads as zeroes),
+   * so after using the memory, a call with a `size` of zero has to be done to check that
+   * no error occurred in the meantime.
+   */
+  FileReaderMapFn map;
 
   off64_t offset;
 } FileReader;
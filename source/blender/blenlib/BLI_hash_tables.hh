@@ -14,7 +14,10 @@
 #include "BLI_allocator.hh"
 #include "BLI_array.hh"
 #include "BLI_math_base.h"
+#include "BLI_math_bits.h"
 #include "BLI_memory_utils.hh"
+#include "BLI_probing_strategies.hh"
+#include "BLI_simd.h"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
 #include "BLI_utildefines.h"
@@ -329,6 +332,142 @@ class HashTableStats {
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Hash Table Control Bytes
+ *
+ * Hash tables that use #GroupProbingStrategy store one control byte per slot in a separate array.
+ * It contains 7 bits of the hash for occupied slots, and a marker for empty and removed slots.
+ * A whole group of slots can then be checked for potential matches at once, which avoids
+ * accessing slots that can't contain the key.
+ *
+ * For other probing strategies, the control bytes are disabled and all methods do nothing. The
+ * hash table is then responsible for not calling the lookup methods.
+ * \{ */
+
+template<bool Enabled, typename Allocator> class HashTableControlBytes {
+ public:
+  HashTableControlBytes(Allocator /*allocator*/ = {})
+  {
+  }
+
+  void reinitialize(const int64_t /*total_slots*/)
+  {
+  }
+
+  void clear()
+  {
+  }
+
+  void set_occupied(const int64_t /*slot_index*/, const uint64_t /*hash*/)
+  {
+  }
+
+  void set_removed(const int64_t /*slot_index*/)
+  {
+  }
+};
+
+template<typename Allocator> class HashTableControlBytes<true, Allocator> {
+ private:
+  static constexpr int64_t GroupSize = GroupProbingStrategy::group_size;
+  static constexpr uint8_t EmptyByte = 0x80;
+  static constexpr uint8_t RemovedByte = 0xFE;
+
+  /**
+   * One byte per slot, but at least one group. Bytes past the last slot stay empty, so that small
+   * tables can be checked like a single group.
+   */
+  Array<uint8_t, GroupSize, Allocator> bytes_;
+
+ public:
+  HashTableControlBytes(Allocator allocator = {}) : bytes_(GroupSize, EmptyByte, allocator)
+  {
+  }
+
+  void reinitialize(const int64_t total_slots)
+  {
+    bytes_.reinitialize(std::max(total_slots, GroupSize));
+    bytes_.fill(EmptyByte);
+  }
+
+  void clear()
+  {
+    bytes_.fill(EmptyByte);
+  }
+
+  void set_occupied(const int64_t slot_index, const uint64_t hash)
+  {
+    bytes_[slot_index] = GroupProbingStrategy::control_byte(hash);
+  }
+
+  void set_removed(const int64_t slot_index)
+  {
+    bytes_[slot_index] = RemovedByte;
+  }
+
+  /**
+   * Find the first slot in the probing sequence of the hash for which `is_match(slot_index)`
+   * returns true. Only occupied slots whose control byte matches the hash are checked. Returns -1
+   * if no slot matches.
+   */
+  template<typename IsMatchFn>
+  int64_t find(const uint64_t hash, const uint64_t slot_mask, const IsMatchFn &is_match) const
+  {
+    const uint8_t control_byte = GroupProbingStrategy::control_byte(hash);
+    GroupProbingStrategy probing_strategy(hash);
+    while (true) {
+      const int64_t group_begin = static_cast<int64_t>(probing_strategy.get() & slot_mask);
+      const uint8_t *group = bytes_.data() + group_begin;
+      for (uint32_t matches = match(group, control_byte); matches != 0; matches &= matches - 1) {
+        const int64_t slot_index = group_begin + bitscan_forward_uint(matches);
+        if (is_match(slot_index)) {
+          return slot_index;
+        }
+      }
+      if (match(group, EmptyByte) != 0) {
+        return -1;
+      }
+      probing_strategy.next();
+    }
+  }
+
+  /**
+   * Find the first empty slot in the probing sequence of the hash. This is the same slot that the
+   * generic probing loop would find.
+   */
+  int64_t find_empty(const uint64_t hash, const uint64_t slot_mask) const
+  {
+    GroupProbingStrategy probing_strategy(hash);
+    while (true) {
+      const int64_t group_begin = static_cast<int64_t>(probing_strategy.get() & slot_mask);
+      const uint32_t empty_mask = match(bytes_.data() + group_begin, EmptyByte);
+      if (empty_mask != 0) {
+        return group_begin + bitscan_forward_uint(empty_mask);
+      }
+      probing_strategy.next();
+    }
+  }
+
+ private:
+  /** Returns a bit mask of the bytes in the group that are equal to the given byte. */
+  static uint32_t match(const uint8_t *group, const uint8_t byte)
+  {
+#ifdef BLI_HAVE_SSE2
+    const __m128i group_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    const __m128i equal = _mm_cmpeq_epi8(group_bytes, _mm_set1_epi8(static_cast<char>(byte)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(equal));
+#else
+    uint32_t result = 0;
+    for (int64_t i = 0; i < GroupSize; i++) {
+      result |= static_cast<uint32_t>(group[i] == byte) << i;
+    }
+    return result;
+#endif
+  }
+};
+
+/** \} */
+
 /**
  * This struct provides an equality operator that returns true for all objects that compare equal
  * when one would use the `==` operator. This is different from std::equal_to<T>, because that
@@ -142,6 +142,11 @@ class Map {
       Array<Slot, LoadFactor::compute_total_slots(InlineBufferCapacity, LOAD_FACTOR), Allocator>;
 #undef LOAD_FACTOR
 
+  /** Control bytes allow checking many slots at once, see #GroupProbingStrategy. */
+  static constexpr bool UseControlBytes = std::is_same_v<ProbingStrategy, GroupProbingStrategy>;
+  using ControlBytes = HashTableControlBytes<UseControlBytes, Allocator>;
+  ControlBytes control_bytes_;
+
   /**
    * This is the array that contains the actual slots. There is always at least one empty slot and
    * the size of the array is a power of two.
@@ -167,6 +172,7 @@ class Map {
         slot_mask_(0),
         hash_(),
         is_equal_(),
+        control_bytes_(allocator),
         slots_(1, allocator)
   {
   }
@@ -198,6 +204,7 @@ class Map {
     occupied_and_removed_slots_ = other.occupied_and_removed_slots_;
     usable_slots_ = other.usable_slots_;
     slot_mask_ = other.slot_mask_;
+    control_bytes_ = std::move(other.control_bytes_);
     hash_ = std::move(other.hash_);
     is_equal_ = std::move(other.is_equal_);
     other.noexcept_reset();
@@ -330,8 +337,7 @@ class Map {
     if (slot == nullptr) {
       return false;
     }
-    slot->remove();
-    removed_slots_++;
+    this->remove_slot(*slot);
     return true;
   }
 
@@ -346,8 +352,7 @@ class Map {
   template<typename ForwardKey> void remove_contained_as(const ForwardKey &key)
   {
     Slot &slot = this->lookup_slot(key, hash_(key));
-    slot.remove();
-    removed_slots_++;
+    this->remove_slot(slot);
   }
 
   /**
@@ -362,8 +367,7 @@ class Map {
   {
     Slot &slot = this->lookup_slot(key, hash_(key));
     Value value = std::move(*slot.value());
-    slot.remove();
-    removed_slots_++;
+    this->remove_slot(slot);
     return value;
   }
 
@@ -382,8 +386,7 @@ class Map {
       return {};
     }
     std::optional<Value> value = std::move(*slot->value());
-    slot->remove();
-    removed_slots_++;
+    this->remove_slot(*slot);
     return value;
   }
 
@@ -407,8 +410,7 @@ class Map {
       return Value(std::forward<ForwardValue>(default_value)...);
     }
     Value value = std::move(*slot->value());
-    slot->remove();
-    removed_slots_++;
+    this->remove_slot(*slot);
     return value;
   }
 
@@ -882,8 +884,7 @@ class Map {
   {
     Slot &slot = iterator.current_slot();
     BLI_assert(slot.is_occupied());
-    slot.remove();
-    removed_slots_++;
+    this->remove_slot(slot);
   }
 
   /**
@@ -966,6 +967,7 @@ class Map {
       slot.~Slot();
       new (&slot) Slot();
     }
+    control_bytes_.clear();
 
     removed_slots_ = 0;
     occupied_and_removed_slots_ = 0;
@@ -995,6 +997,7 @@ class Map {
     if (this->size() == 0) {
       try {
         slots_.reinitialize(total_slots);
+        control_bytes_.reinitialize(total_slots);
       }
       catch (...) {
         this->noexcept_reset();
@@ -1010,6 +1013,7 @@ class Map {
     SlotArray new_slots(total_slots);
 
     try {
+      control_bytes_.reinitialize(total_slots);
       for (Slot &slot : slots_) {
         if (slot.is_occupied()) {
           this->add_after_grow(slot, new_slots, new_slot_mask);
@@ -1036,6 +1040,7 @@ class Map {
       Slot &slot = new_slots[slot_index];
       if (slot.is_empty()) {
         slot.occupy(std::move(*old_slot.key()), hash, std::move(*old_slot.value()));
+        control_bytes_.set_occupied(slot_index, hash);
         return;
       }
     }
@@ -1056,6 +1061,14 @@ class Map {
 
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+      slots_[slot_index].occupy(
+          std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
+      this->slot_occupied(slot_index, hash);
+      return;
+    }
+
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
@@ -1071,6 +1084,17 @@ class Map {
   {
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      if (this->find_slot_index(key, hash) != -1) {
+        return false;
+      }
+      const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+      slots_[slot_index].occupy(
+          std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
+      this->slot_occupied(slot_index, hash);
+      return true;
+    }
+
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
@@ -1097,6 +1121,28 @@ class Map {
 
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      const int64_t existing_slot_index = this->find_slot_index(key, hash);
+      if (existing_slot_index != -1) {
+        return modify_value(slots_[existing_slot_index].value());
+      }
+      const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+      Slot &slot = slots_[slot_index];
+      Value *value_ptr = slot.value();
+      if constexpr (std::is_void_v<CreateReturnT>) {
+        create_value(value_ptr);
+        slot.occupy_no_value(std::forward<ForwardKey>(key), hash);
+        this->slot_occupied(slot_index, hash);
+        return;
+      }
+      else {
+        auto &&return_value = create_value(value_ptr);
+        slot.occupy_no_value(std::forward<ForwardKey>(key), hash);
+        this->slot_occupied(slot_index, hash);
+        return return_value;
+      }
+    }
+
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         Value *value_ptr = slot.value();
@@ -1126,6 +1172,18 @@ class Map {
   {
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      const int64_t existing_slot_index = this->find_slot_index(key, hash);
+      if (existing_slot_index != -1) {
+        return *slots_[existing_slot_index].value();
+      }
+      const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+      Slot &slot = slots_[slot_index];
+      slot.occupy(std::forward<ForwardKey>(key), hash, create_value());
+      this->slot_occupied(slot_index, hash);
+      return *slot.value();
+    }
+
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash, create_value());
@@ -1144,6 +1202,18 @@ class Map {
   {
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      const int64_t existing_slot_index = this->find_slot_index(key, hash);
+      if (existing_slot_index != -1) {
+        return *slots_[existing_slot_index].value();
+      }
+      const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+      Slot &slot = slots_[slot_index];
+      slot.occupy(std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
+      this->slot_occupied(slot_index, hash);
+      return *slot.value();
+    }
+
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash, std::forward<ForwardValue>(value)...);
@@ -1176,6 +1246,9 @@ class Map {
   const Slot &lookup_slot(const ForwardKey &key, const uint64_t hash) const
   {
     BLI_assert(this->contains_as(key));
+    if constexpr (UseControlBytes) {
+      return slots_[this->find_slot_index(key, hash)];
+    }
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         return slot;
@@ -1192,6 +1265,10 @@ class Map {
   template<typename ForwardKey>
   const Slot *lookup_slot_ptr(const ForwardKey &key, const uint64_t hash) const
   {
+    if constexpr (UseControlBytes) {
+      const int64_t slot_index = this->find_slot_index(key, hash);
+      return slot_index == -1 ? nullptr : &slots_[slot_index];
+    }
     MAP_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         return &slot;
@@ -1232,6 +1309,29 @@ class Map {
       BLI_assert(occupied_and_removed_slots_ < usable_slots_);
     }
   }
+
+  void remove_slot(Slot &slot)
+  {
+    slot.remove();
+    control_bytes_.set_removed(&slot - slots_.data());
+    removed_slots_++;
+  }
+
+  /** Only used with control bytes. Returns the index of the slot containing the key or -1. */
+  template<typename ForwardKey>
+  int64_t find_slot_index(const ForwardKey &key, const uint64_t hash) const
+  {
+    return control_bytes_.find(hash, slot_mask_, [&](const int64_t slot_index) {
+      return slots_[slot_index].contains(key, is_equal_, hash);
+    });
+  }
+
+  /** Only used with control bytes. Has to be called after an empty slot has been occupied. */
+  void slot_occupied(const int64_t slot_index, const uint64_t hash)
+  {
+    control_bytes_.set_occupied(slot_index, hash);
+    occupied_and_removed_slots_++;
+  }
 };
 
 /**
@@ -33,6 +33,11 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
 
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
+/* Returns whether an IO error occurred while accessing the mapped memory.
+ * When reading through #BLI_mmap_get_pointer instead of #BLI_mmap_read, this has to be checked
+ * after the memory was accessed, since failed pages read as zeroes. */
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
 
 #ifdef __cplusplus
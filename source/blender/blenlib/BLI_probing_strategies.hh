@@ -193,6 +193,62 @@ template<uint64_t LinearSteps = 2, bool PreShuffle = false> class ShuffleProbing
   }
 };
 
+/**
+ * Probes groups of consecutive slots, similar to SwissTable. The groups are visited in a
+ * triangular sequence, which hits every group when the number of groups is a power of two. Within
+ * a group, linear probing is used.
+ *
+ * When #Set or #Map use this strategy, they also store a control byte per slot with a few bits of
+ * the hash. That way all slots in a group can be checked for a potential match with a few SIMD
+ * instructions, before any slot is accessed. See #HashTableControlBytes.
+ *
+ * The hash is remixed in the constructor, because the control bytes and the group index need
+ * different well distributed bits of it, and many hash functions in Blender are trivial.
+ */
+class GroupProbingStrategy {
+ private:
+  uint64_t group_;
+  uint64_t iteration_;
+
+ public:
+  static constexpr int64_t group_size = 16;
+
+  GroupProbingStrategy(const uint64_t hash) : group_(mix(hash) >> 7), iteration_(0)
+  {
+  }
+
+  void next()
+  {
+    iteration_++;
+    group_ += iteration_;
+  }
+
+  uint64_t get() const
+  {
+    return group_ * group_size;
+  }
+
+  int64_t linear_steps() const
+  {
+    return group_size;
+  }
+
+  /**
+   * Returns the 7 bits of the hash that are stored in the control byte of an occupied slot. They
+   * are independent of the bits that determine the group.
+   */
+  static uint8_t control_byte(const uint64_t hash)
+  {
+    return static_cast<uint8_t>(mix(hash) >> 57);
+  }
+
+ private:
+  static uint64_t mix(const uint64_t hash)
+  {
+    return (hash ^ (hash >> 32)) * 0x9E3779B97F4A7C15;
+  }
+};
+
 /**
  * Having a specified default is convenient.
  */
@@ -148,6 +148,11 @@ class Set {
       Array<Slot, LoadFactor::compute_total_slots(InlineBufferCapacity, LOAD_FACTOR), Allocator>;
 #undef LOAD_FACTOR
 
+  /** Control bytes allow checking many slots at once, see #GroupProbingStrategy. */
+  static constexpr bool UseControlBytes = std::is_same_v<ProbingStrategy, GroupProbingStrategy>;
+  using ControlBytes = HashTableControlBytes<UseControlBytes, Allocator>;
+  ControlBytes control_bytes_;
+
   /**
    * This is the array that contains the actual slots. There is always at least one empty slot and
    * the size of the array is a power of two.
@@ -171,6 +176,7 @@ class Set {
         occupied_and_removed_slots_(0),
         usable_slots_(0),
         slot_mask_(0),
+        control_bytes_(allocator),
         slots_(1, allocator)
   {
   }
@@ -215,6 +221,7 @@ class Set {
     occupied_and_removed_slots_ = other.occupied_and_removed_slots_;
     usable_slots_ = other.usable_slots_;
     slot_mask_ = other.slot_mask_;
+    control_bytes_ = std::move(other.control_bytes_);
     hash_ = std::move(other.hash_);
     is_equal_ = std::move(other.is_equal_);
     other.noexcept_reset();
@@ -489,6 +496,7 @@ class Set {
     Slot &slot = const_cast<Slot &>(iterator.current_slot());
     BLI_assert(slot.is_occupied());
     slot.remove();
+    control_bytes_.set_removed(iterator.current_slot_);
     removed_slots_++;
   }
 
@@ -519,6 +527,7 @@ class Set {
       slot.~Slot();
       new (&slot) Slot();
     }
+    control_bytes_.clear();
 
     removed_slots_ = 0;
     occupied_and_removed_slots_ = 0;
@@ -634,6 +643,7 @@ class Set {
     if (this->size() == 0) {
       try {
         slots_.reinitialize(total_slots);
+        control_bytes_.reinitialize(total_slots);
       }
       catch (...) {
         this->noexcept_reset();
@@ -650,6 +660,7 @@ class Set {
     SlotArray new_slots(total_slots);
 
     try {
+      control_bytes_.reinitialize(total_slots);
       for (Slot &slot : slots_) {
         if (slot.is_occupied()) {
           this->add_after_grow(slot, new_slots, new_slot_mask);
@@ -677,6 +688,7 @@ class Set {
       Slot &slot = new_slots[slot_index];
       if (slot.is_empty()) {
         slot.occupy(std::move(*old_slot.key()), hash);
+        control_bytes_.set_occupied(slot_index, hash);
         return;
       }
     }
@@ -697,6 +709,10 @@ class Set {
   template<typename ForwardKey>
   bool contains__impl(const ForwardKey &key, const uint64_t hash) const
   {
+    if constexpr (UseControlBytes) {
+      return this->find_slot_index(key, hash) != -1;
+    }
+
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         return false;
@@ -724,6 +740,11 @@ class Set {
   template<typename ForwardKey>
   const Key *lookup_key_ptr__impl(const ForwardKey &key, const uint64_t hash) const
   {
+    if constexpr (UseControlBytes) {
+      const int64_t slot_index = this->find_slot_index(key, hash);
+      return slot_index == -1 ? nullptr : slots_[slot_index].key();
+    }
+
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         return slot.key();
@@ -741,6 +762,11 @@ class Set {
 
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      this->occupy_empty_slot(std::forward<ForwardKey>(key), hash);
+      return;
+    }
+
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash);
@@ -755,6 +781,14 @@ class Set {
   {
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      if (this->find_slot_index(key, hash) != -1) {
+        return false;
+      }
+      this->occupy_empty_slot(std::forward<ForwardKey>(key), hash);
+      return true;
+    }
+
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.is_empty()) {
         slot.occupy(std::forward<ForwardKey>(key), hash);
@@ -773,6 +807,7 @@ class Set {
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         slot.remove();
+        control_bytes_.set_removed(&slot - slots_.data());
         removed_slots_++;
         return true;
       }
@@ -791,6 +826,7 @@ class Set {
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         slot.remove();
+        control_bytes_.set_removed(&slot - slots_.data());
         removed_slots_++;
         return;
       }
@@ -803,6 +839,14 @@ class Set {
   {
     this->ensure_can_add();
 
+    if constexpr (UseControlBytes) {
+      const int64_t slot_index = this->find_slot_index(key, hash);
+      if (slot_index != -1) {
+        return *slots_[slot_index].key();
+      }
+      return *this->occupy_empty_slot(std::forward<ForwardKey>(key), hash).key();
+    }
+
     SET_SLOT_PROBING_BEGIN (hash, slot) {
       if (slot.contains(key, is_equal_, hash)) {
         return *slot.key();
@@ -840,6 +884,26 @@ class Set {
       BLI_assert(occupied_and_removed_slots_ < usable_slots_);
     }
   }
+
+  /** Only used with control bytes. Returns the index of the slot containing the key or -1. */
+  template<typename ForwardKey>
+  int64_t find_slot_index(const ForwardKey &key, const uint64_t hash) const
+  {
+    return control_bytes_.find(hash, slot_mask_, [&](const int64_t slot_index) {
+      return slots_[slot_index].contains(key, is_equal_, hash);
+    });
+  }
+
+  /** Only used with control bytes. The key must not be in the set yet. */
+  template<typename ForwardKey> Slot &occupy_empty_slot(ForwardKey &&key, const uint64_t hash)
+  {
+    const int64_t slot_index = control_bytes_.find_empty(hash, slot_mask_);
+    Slot &slot = slots_[slot_index];
+    slot.occupy(std::forward<ForwardKey>(key), hash);
+    control_bytes_.set_occupied(slot_index, hash);
+    occupied_and_removed_slots_++;
+    return slot;
+  }
 };
 
 /**
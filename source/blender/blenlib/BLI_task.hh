@@ -30,8 +30,16 @@
 #  endif
 #endif
 
+#include <atomic>
+#include <type_traits>
+
+#include "MEM_guardedalloc.h"
+
 #include "BLI_index_range.hh"
+#include "BLI_task.h"
+#include "BLI_timeit.hh"
 #include "BLI_utildefines.h"
+#include "BLI_utility_mixins.hh"
 
 namespace blender::threading {
 
@@ -105,6 +113,160 @@ template<typename... Functions> void parallel_invoke(Functions &&...functions)
 #endif
 }
 
+/**
+ * Same as #parallel_invoke, but allows disabling threading dynamically. This is useful because
+ * executing tiny tasks in parallel can be more expensive than executing them serially.
+ */
+template<typename... Functions>
+void parallel_invoke(const bool use_threading, Functions &&...functions)
+{
+  if (use_threading) {
+    parallel_invoke(std::forward<Functions>(functions)...);
+  }
+  else {
+    (functions(), ...);
+  }
+}
+
+/**
+ * Allows stopping work which is not needed anymore. Tokens can be nested, a token is canceled when
+ * it or any of its parents is canceled. That way canceling an operation also stops all the work
+ * that was started for it.
+ */
+class CancellationToken : NonCopyable, NonMovable {
+ private:
+  const CancellationToken *parent_;
+  std::atomic<bool> is_canceled_ = false;
+
+ public:
+  CancellationToken(const CancellationToken *parent = nullptr) : parent_(parent)
+  {
+  }
+
+  void cancel()
+  {
+    is_canceled_.store(true, std::memory_order_relaxed);
+  }
+
+  bool is_canceled() const
+  {
+    for (const CancellationToken *token = this; token != nullptr; token = token->parent_) {
+      if (token->is_canceled_.load(std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * Same as #parallel_invoke, but functions are skipped when the token is canceled before they
+ * start. Functions can check the token themselves to stop early.
+ */
+template<typename... Functions>
+void parallel_invoke_cancelable(const CancellationToken &token, Functions &&...functions)
+{
+  parallel_invoke([&]() {
+    if (!token.is_canceled()) {
+      functions();
+    }
+  }...);
+}
+
+/**
+ * A group of tasks that are executed by the task scheduler and waited for together, the
+ * destructor waits for all tasks that are still running.
+ *
+ * Groups with #TASK_PRIORITY_LOW only get worker threads when there is no other work, so
+ * background work (e.g. baking or writing files) does not slow down interactive work.
+ *
+ * Tasks are skipped when the group's token is canceled before they start. Nested groups can pass
+ * the token of their parent group, so canceling an outer group stops the nested work as well.
+ *
+ * The CPU time that threads spent in the tasks of a group is accumulated, which helps finding
+ * which work competes for the threads. Time in nested groups counts for the outer tasks as well,
+ * time that a task spends waiting or sleeping does not count.
+ */
+class TaskGroup : NonCopyable, NonMovable {
+ private:
+  TaskPool *pool_;
+  CancellationToken token_;
+  std::atomic<int64_t> cpu_time_ns_ = 0;
+
+ public:
+  TaskGroup(const eTaskPriority priority = TASK_PRIORITY_HIGH,
+            const CancellationToken *parent_token = nullptr)
+      : token_(parent_token)
+  {
+    pool_ = BLI_task_pool_create(this, priority);
+  }
+
+  ~TaskGroup()
+  {
+    this->wait();
+    BLI_task_pool_free(pool_);
+  }
+
+  /** Add a task to the group, it may be executed immediately. */
+  template<typename Function> void run(Function &&function)
+  {
+    using FunctionT = std::decay_t<Function>;
+    FunctionT *task = MEM_new<FunctionT>(__func__, std::forward<Function>(function));
+    BLI_task_pool_push(
+        pool_,
+        [](TaskPool *__restrict pool, void *taskdata) {
+          TaskGroup &group = *static_cast<TaskGroup *>(BLI_task_pool_user_data(pool));
+          group.execute(*static_cast<FunctionT *>(taskdata));
+        },
+        task,
+        true,
+        [](TaskPool *UNUSED(pool), void *taskdata) {
+          MEM_delete(static_cast<FunctionT *>(taskdata));
+        });
+  }
+
+  /** Wait until all tasks are done, the calling thread helps executing them. */
+  void wait()
+  {
+    BLI_task_pool_work_and_wait(pool_);
+  }
+
+  /** Skip all tasks which did not start yet, running tasks can check #is_canceled. */
+  void cancel()
+  {
+    token_.cancel();
+  }
+
+  bool is_canceled() const
+  {
+    return token_.is_canceled();
+  }
+
+  /** Token to pass to nested work, which should stop when this group is canceled. */
+  const CancellationToken &token() const
+  {
+    return token_;
+  }
+
+  /** CPU time in seconds that all threads together spent executing tasks of this group so far. */
+  double cpu_time() const
+  {
+    return double(cpu_time_ns_.load(std::memory_order_relaxed)) * 1e-9;
+  }
+
+ private:
+  template<typename Function> void execute(Function &function)
+  {
+    if (token_.is_canceled()) {
+      return;
+    }
+    const timeit::Nanoseconds start = timeit::thread_cpu_time();
+    function();
+    const timeit::Nanoseconds duration = timeit::thread_cpu_time() - start;
+    cpu_time_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+  }
+};
+
 /** See #BLI_task_isolate for a description of what isolating a task means. */
 template<typename Function> void isolate_task(const Function &function)
 {
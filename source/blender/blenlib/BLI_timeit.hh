@@ -16,6 +16,12 @@ using Nanoseconds = std::chrono::nanoseconds;
 
 void print_duration(Nanoseconds duration);
 
+/**
+ * CPU time used by the calling thread so far. Work that the thread delegates to other threads is
+ * not included. Returns zero when the platform does not support measuring it.
+ */
+Nanoseconds thread_cpu_time();
+
 class ScopedTimer {
  private:
   std::string name_;
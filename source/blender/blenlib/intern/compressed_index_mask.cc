@@ -0,0 +1,320 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <array>
+
+#include "BLI_compressed_index_mask.hh"
+#include "BLI_math_bits.h"
+
+namespace blender {
+
+/** Number of 64 bit words that are necessary to store one bit for every index in a window. */
+static constexpr int64_t window_words_num = CompressedIndexMask::max_segment_size / 64;
+
+Span<int16_t> CompressedIndexMask::static_range_indices()
+{
+  static const std::array<int16_t, max_segment_size> indices = []() {
+    std::array<int16_t, max_segment_size> indices;
+    for (const int64_t i : IndexRange(max_segment_size)) {
+      indices[i] = int16_t(i);
+    }
+    return indices;
+  }();
+  return Span<int16_t>(indices.data(), max_segment_size);
+}
+
+CompressedIndexMask::CompressedIndexMask(const IndexRange range)
+{
+  this->append_range(range);
+}
+
+void CompressedIndexMask::append_range(const IndexRange range)
+{
+  int64_t start = range.start();
+  const int64_t end = range.one_after_last();
+  while (start < end) {
+    /* Split the range at window boundaries, so that every segment is in a single window. */
+    const int64_t window_end = (start | max_segment_size_mask) + 1;
+    const int64_t segment_end = std::min(window_end, end);
+    segments_.append({start, -1});
+    cumulative_segment_sizes_.append(cumulative_segment_sizes_.last() + segment_end - start);
+    start = segment_end;
+  }
+}
+
+void CompressedIndexMask::append_segment(const int64_t offset,
+                                         const Span<int16_t> relative_indices)
+{
+  if (relative_indices.is_empty()) {
+    return;
+  }
+  BLI_assert(offset >= 0);
+  BLI_assert(this->is_empty() || offset + relative_indices.first() > this->last());
+  BLI_assert(relative_indices.last() < max_segment_size);
+  if (relative_indices_are_range(relative_indices)) {
+    segments_.append({offset + relative_indices.first(), -1});
+  }
+  else {
+    segments_.append({offset, relative_indices_.size()});
+    relative_indices_.extend(relative_indices);
+  }
+  cumulative_segment_sizes_.append(cumulative_segment_sizes_.last() + relative_indices.size());
+}
+
+CompressedIndexMask CompressedIndexMask::from_indices(const Span<int64_t> indices)
+{
+  BLI_assert(IndexMask::indices_are_valid_index_mask(indices));
+  CompressedIndexMask mask;
+  int16_t relative_indices[max_segment_size];
+  int64_t i = 0;
+  while (i < indices.size()) {
+    const int64_t offset = indices[i] & ~max_segment_size_mask;
+    const int64_t window_end = offset + max_segment_size;
+    int64_t count = 0;
+    for (; i < indices.size() && indices[i] < window_end; i++) {
+      relative_indices[count] = int16_t(indices[i] - offset);
+      count++;
+    }
+    mask.append_segment(offset, Span<int16_t>(relative_indices, count));
+  }
+  return mask;
+}
+
+CompressedIndexMask CompressedIndexMask::from_index_mask(const IndexMask mask)
+{
+  if (mask.is_range()) {
+    return CompressedIndexMask(mask.as_range());
+  }
+  return from_indices(mask.indices());
+}
+
+CompressedIndexMask CompressedIndexMask::from_bools(const Span<bool> bools)
+{
+  return from_predicate(bools.index_range(), 4096, [&](const int64_t i) { return bools[i]; });
+}
+
+CompressedIndexMask CompressedIndexMask::concatenate(MutableSpan<CompressedIndexMask> masks)
+{
+  if (masks.size() == 1) {
+    return std::move(masks[0]);
+  }
+  int64_t segments_num = 0;
+  int64_t relative_indices_num = 0;
+  for (const CompressedIndexMask &mask : masks) {
+    segments_num += mask.segments_.size();
+    relative_indices_num += mask.relative_indices_.size();
+  }
+  CompressedIndexMask result;
+  result.segments_.reserve(segments_num);
+  result.cumulative_segment_sizes_.reserve(segments_num + 1);
+  result.relative_indices_.reserve(relative_indices_num);
+  for (const CompressedIndexMask &mask : masks) {
+    BLI_assert(mask.is_empty() || result.is_empty() || mask.first() > result.last());
+    const int64_t relative_indices_offset = result.relative_indices_.size();
+    const int64_t size_offset = result.size();
+    for (const int64_t segment_i : mask.segments_.index_range()) {
+      Segment segment = mask.segments_[segment_i];
+      if (segment.relative_indices_start != -1) {
+        segment.relative_indices_start += relative_indices_offset;
+      }
+      result.segments_.append(segment);
+      result.cumulative_segment_sizes_.append(size_offset +
+                                              mask.cumulative_segment_sizes_[segment_i + 1]);
+    }
+    result.relative_indices_.extend(mask.relative_indices_);
+  }
+  return result;
+}
+
+int64_t CompressedIndexMask::operator[](const int64_t n) const
+{
+  BLI_assert(n >= 0 && n < this->size());
+  const int64_t segment_i = std::upper_bound(cumulative_segment_sizes_.begin(),
+                                             cumulative_segment_sizes_.end(),
+                                             n) -
+                            cumulative_segment_sizes_.begin() - 1;
+  const Span<int16_t> relative_indices = this->segment_relative_indices(segment_i);
+  return segments_[segment_i].offset + relative_indices[n - cumulative_segment_sizes_[segment_i]];
+}
+
+void CompressedIndexMask::to_indices(MutableSpan<int64_t> r_indices) const
+{
+  BLI_assert(r_indices.size() == this->size());
+  threading::parallel_for(segments_.index_range(), 16, [&](const IndexRange segments_range) {
+    for (const int64_t segment_i : segments_range) {
+      const int64_t offset = segments_[segment_i].offset;
+      const Span<int16_t> relative_indices = this->segment_relative_indices(segment_i);
+      MutableSpan<int64_t> segment_indices = r_indices.slice(
+          cumulative_segment_sizes_[segment_i], relative_indices.size());
+      for (const int64_t i : relative_indices.index_range()) {
+        segment_indices[i] = offset + relative_indices[i];
+      }
+    }
+  });
+}
+
+IndexMask CompressedIndexMask::to_index_mask(Vector<int64_t> &r_indices) const
+{
+  if (this->is_empty()) {
+    return {};
+  }
+  if (this->is_range()) {
+    return this->as_range();
+  }
+  r_indices.reinitialize(this->size());
+  this->to_indices(r_indices);
+  return r_indices.as_span();
+}
+
+void CompressedIndexMask::to_bools(MutableSpan<bool> r_bools) const
+{
+  BLI_assert(r_bools.size() >= this->min_array_size());
+  this->foreach_index(4096, [&](const int64_t i) { r_bools[i] = true; });
+}
+
+bool operator==(const CompressedIndexMask &a, const CompressedIndexMask &b)
+{
+  /* Masks are stored in a canonical form, with one segment per window and all contiguous segments
+   * stored as ranges. So it is enough to compare the segments. */
+  if (a.cumulative_segment_sizes_ != b.cumulative_segment_sizes_) {
+    return false;
+  }
+  for (const int64_t segment_i : a.segments_.index_range()) {
+    if (a.segments_[segment_i].offset != b.segments_[segment_i].offset) {
+      return false;
+    }
+    if (a.segment_relative_indices(segment_i) != b.segment_relative_indices(segment_i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Set Operations
+ * \{ */
+
+static void set_segment_bits(const int64_t offset_in_window,
+                             const Span<int16_t> relative_indices,
+                             MutableSpan<uint64_t> r_words)
+{
+  if (CompressedIndexMask::relative_indices_are_range(relative_indices)) {
+    int64_t start = offset_in_window + relative_indices.first();
+    const int64_t end = start + relative_indices.size();
+    /* Set single bits until the start is aligned, then whole words. */
+    for (; start < end && (start & 63) != 0; start++) {
+      r_words[start >> 6] |= uint64_t(1) << (start & 63);
+    }
+    for (; start + 64 <= end; start += 64) {
+      r_words[start >> 6] = ~uint64_t(0);
+    }
+    for (; start < end; start++) {
+      r_words[start >> 6] |= uint64_t(1) << (start & 63);
+    }
+    return;
+  }
+  for (const int16_t relative_index : relative_indices) {
+    const int64_t i = offset_in_window + relative_index;
+    r_words[i >> 6] |= uint64_t(1) << (i & 63);
+  }
+}
+
+CompressedIndexMask CompressedIndexMask::set_operation(const CompressedIndexMask &a,
+                                                       const CompressedIndexMask &b,
+                                                       const SetOperation operation)
+{
+  CompressedIndexMask result;
+  std::array<uint64_t, window_words_num> words_a;
+  std::array<uint64_t, window_words_num> words_b;
+  int16_t relative_indices[max_segment_size];
+
+  /* Both masks have at most one segment per window, so their segments can be merged like two
+   * sorted lists. Only windows that exist in both masks have to be combined bit by bit. */
+  int64_t segment_a = 0;
+  int64_t segment_b = 0;
+  while (segment_a < a.segments_.size() || segment_b < b.segments_.size()) {
+    const int64_t window_a = segment_a < a.segments_.size() ?
+                                 a.segments_[segment_a].offset >> max_segment_size_shift :
+                                 INT64_MAX;
+    const int64_t window_b = segment_b < b.segments_.size() ?
+                                 b.segments_[segment_b].offset >> max_segment_size_shift :
+                                 INT64_MAX;
+    if (window_a < window_b) {
+      if (operation != SetOperation::Intersection) {
+        result.append_segment(a.segments_[segment_a].offset,
+                              a.segment_relative_indices(segment_a));
+      }
+      segment_a++;
+      continue;
+    }
+    if (window_b < window_a) {
+      if (operation == SetOperation::Union) {
+        result.append_segment(b.segments_[segment_b].offset,
+                              b.segment_relative_indices(segment_b));
+      }
+      segment_b++;
+      continue;
+    }
+
+    const int64_t window_offset = window_a << max_segment_size_shift;
+    words_a.fill(0);
+    words_b.fill(0);
+    set_segment_bits(a.segments_[segment_a].offset - window_offset,
+                     a.segment_relative_indices(segment_a),
+                     words_a);
+    set_segment_bits(b.segments_[segment_b].offset - window_offset,
+                     b.segment_relative_indices(segment_b),
+                     words_b);
+
+    int64_t count = 0;
+    for (const int64_t word_i : IndexRange(window_words_num)) {
+      uint64_t word = 0;
+      switch (operation) {
+        case SetOperation::Union:
+          word = words_a[word_i] | words_b[word_i];
+          break;
+        case SetOperation::Intersection:
+          word = words_a[word_i] & words_b[word_i];
+          break;
+        case SetOperation::Difference:
+          word = words_a[word_i] & ~words_b[word_i];
+          break;
+      }
+      while (word != 0) {
+        relative_indices[count] = int16_t((word_i << 6) + bitscan_forward_uint64(word));
+        count++;
+        word &= word - 1;
+      }
+    }
+    result.append_segment(window_offset, Span<int16_t>(relative_indices, count));
+    segment_a++;
+    segment_b++;
+  }
+  return result;
+}
+
+CompressedIndexMask CompressedIndexMask::complement(const IndexRange universe) const
+{
+  return set_operation(CompressedIndexMask(universe), *this, SetOperation::Difference);
+}
+
+CompressedIndexMask CompressedIndexMask::unite(const CompressedIndexMask &a,
+                                               const CompressedIndexMask &b)
+{
+  return set_operation(a, b, SetOperation::Union);
+}
+
+CompressedIndexMask CompressedIndexMask::intersect(const CompressedIndexMask &a,
+                                                   const CompressedIndexMask &b)
+{
+  return set_operation(a, b, SetOperation::Intersection);
+}
+
+CompressedIndexMask CompressedIndexMask::difference(const CompressedIndexMask &a,
+                                                    const CompressedIndexMask &b)
+{
+  return set_operation(a, b, SetOperation::Difference);
+}
+
+/** \} */
+
+}  // namespace blender
@@ -61,6 +61,16 @@ static off64_t memory_seek(FileReader *reader, off64_t offset, int whence)
   return mem->reader.offset;
 }
 
+static const void *memory_map_raw(FileReader *reader, off64_t offset, size_t size)
+{
+  MemoryReader *mem = (MemoryReader *)reader;
+
+  if (offset < 0 || (size_t)offset + size > mem->length) {
+    return NULL;
+  }
+  return mem->data + offset;
+}
+
 static void memory_close_raw(FileReader *reader)
 {
   MEM_freeN(reader);
@@ -76,6 +86,7 @@ FileReader *BLI_filereader_new_memory(const void *data, size_t len)
   mem->reader.read = memory_read_raw;
   mem->reader.seek = memory_seek;
   mem->reader.close = memory_close_raw;
+  mem->reader.map = memory_map_raw;
 
   return (FileReader *)mem;
 }
@@ -102,6 +113,22 @@ static ssize_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
   return readsize;
 }
 
+#ifndef WIN32
+static const void *memory_map_mmap(FileReader *reader, off64_t offset, size_t size)
+{
+  MemoryReader *mem = (MemoryReader *)reader;
+
+  /* Also catches errors that happened while accessing previously mapped ranges. */
+  if (BLI_mmap_any_io_error(mem->mmap)) {
+    return NULL;
+  }
+  if (offset < 0 || (size_t)offset + size > mem->length) {
+    return NULL;
+  }
+  return (const char *)BLI_mmap_get_pointer(mem->mmap) + offset;
+}
+#endif
+
 static void memory_close_mmap(FileReader *reader)
 {
   MemoryReader *mem = (MemoryReader *)reader;
@@ -124,6 +151,11 @@ FileReader *BLI_filereader_new_mmap(int filedes)
   mem->reader.read = memory_read_mmap;
   mem->reader.seek = memory_seek;
   mem->reader.close = memory_close_mmap;
+#ifndef WIN32
+  /* On Windows, IO errors are only caught inside #BLI_mmap_read, so don't give direct access to
+   * the mapped memory there. */
+  mem->reader.map = memory_map_mmap;
+#endif
 
   return (FileReader *)mem;
 }
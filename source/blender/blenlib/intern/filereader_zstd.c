@@ -12,9 +12,15 @@
 #include "BLI_endian_switch.h"
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
+/* Maximum amount of frames that are decompressed in parallel when reading sequentially.
+ * This bounds the read-ahead memory, since frames are usually 1 MB. */
+#define ZSTD_READ_AHEAD_FRAMES_MAX 32
+
 typedef struct {
   FileReader reader;
 
@@ -29,8 +35,17 @@ typedef struct {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
+    /* Single frame, for random access outside of the read-ahead range. */
     char *cached_content;
     int cached_frame;
+
+    /* Contiguous decompressed frames `[ahead_frame, ahead_frame + ahead_frames_num)`,
+     * decompressed in parallel when reading sequentially. */
+    char *ahead_content;
+    int ahead_frame;
+    int ahead_frames_num;
+    /* Maximum value of `ahead_frames_num`. */
+    int ahead_frames_max;
   } seek;
 } ZstdReader;
 
@@ -127,6 +142,8 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
   }
 
   zstd->seek.cached_frame = -1;
+  zstd->seek.ahead_frame = -1;
+  zstd->seek.ahead_frames_max = clamp_i(BLI_system_thread_count(), 1, ZSTD_READ_AHEAD_FRAMES_MAX);
 
   return true;
 }
@@ -154,14 +171,114 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
+typedef struct ZstdReadAheadData {
+  ZstdReader *zstd;
+  const char *compressed_data;
+  char *uncompressed_data;
+  bool error;
+} ZstdReadAheadData;
+
+static void zstd_read_ahead_decompress_fn(void *__restrict userdata,
+                                          const int i,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ZstdReadAheadData *data = userdata;
+  const ZstdReader *zstd = data->zstd;
+  const int frame = zstd->seek.ahead_frame + i;
+
+  const size_t compressed_ofs = zstd->seek.compressed_ofs[frame] -
+                                zstd->seek.compressed_ofs[zstd->seek.ahead_frame];
+  const size_t uncompressed_ofs = zstd->seek.uncompressed_ofs[frame] -
+                                  zstd->seek.uncompressed_ofs[zstd->seek.ahead_frame];
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                             zstd->seek.uncompressed_ofs[frame];
+
+  /* Every task uses its own context, the one of the reader is not thread-safe. */
+  size_t res = ZSTD_decompress(data->uncompressed_data + uncompressed_ofs,
+                               uncompressed_size,
+                               data->compressed_data + compressed_ofs,
+                               compressed_size);
+  if (ZSTD_isError(res) || res < uncompressed_size) {
+    data->error = true;
+  }
+}
+
+/* Read and decompress the frames starting at the given one in parallel,
+ * replacing the previous read-ahead range. */
+static bool zstd_read_ahead(ZstdReader *zstd, int frame)
+{
+  MEM_SAFE_FREE(zstd->seek.ahead_content);
+  zstd->seek.ahead_frame = -1;
+  zstd->seek.ahead_frames_num = 0;
+
+  const int frames_num = min_ii(zstd->seek.ahead_frames_max, zstd->seek.frames_num - frame);
+  const int end_frame = frame + frames_num;
+
+  /* The frames are stored contiguously, so read all of them at once. */
+  size_t compressed_size = zstd->seek.compressed_ofs[end_frame] -
+                           zstd->seek.compressed_ofs[frame];
+  size_t uncompressed_size = zstd->seek.uncompressed_ofs[end_frame] -
+                             zstd->seek.uncompressed_ofs[frame];
+
+  char *compressed_data = MEM_mallocN(compressed_size, __func__);
+  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size) {
+    MEM_freeN(compressed_data);
+    return false;
+  }
+
+  zstd->seek.ahead_frame = frame;
+  ZstdReadAheadData data = {
+      .zstd = zstd,
+      .compressed_data = compressed_data,
+      .uncompressed_data = MEM_mallocN(uncompressed_size, __func__),
+      .error = false,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, frames_num, &data, zstd_read_ahead_decompress_fn, &settings);
+
+  MEM_freeN(compressed_data);
+  if (data.error) {
+    MEM_freeN(data.uncompressed_data);
+    zstd->seek.ahead_frame = -1;
+    return false;
+  }
+
+  zstd->seek.ahead_content = data.uncompressed_data;
+  zstd->seek.ahead_frames_num = frames_num;
+  return true;
+}
+
 /* Ensure that the currently loaded frame is the correct one. */
 static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 {
+  const int ahead_frame = zstd->seek.ahead_frame;
+  const int ahead_end_frame = ahead_frame + zstd->seek.ahead_frames_num;
+  if (ahead_frame != -1 && frame >= ahead_frame && frame < ahead_end_frame) {
+    /* Frame was already decompressed by the read-ahead. */
+    return zstd->seek.ahead_content +
+           (zstd->seek.uncompressed_ofs[frame] - zstd->seek.uncompressed_ofs[ahead_frame]);
+  }
+
   if (zstd->seek.cached_frame == frame) {
     /* Cached frame matches, so just return it. */
     return zstd->seek.cached_content;
   }
 
+  /* Reading continues sequentially (which is the common case of reading all #BHead's),
+   * so decompress the following frames in parallel. Frames that are accessed randomly
+   * (e.g. data read on demand) are decompressed one by one, keeping the read-ahead intact. */
+  if (zstd->seek.ahead_frames_max > 1 && (ahead_frame == -1 || frame == ahead_end_frame)) {
+    if (zstd_read_ahead(zstd, frame)) {
+      return zstd->seek.ahead_content;
+    }
+    return NULL;
+  }
+
   /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
   MEM_SAFE_FREE(zstd->seek.cached_content);
 
@@ -281,7 +398,8 @@ static void zstd_close(FileReader *reader)
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    MEM_freeN(zstd->seek.cached_content);
+    MEM_SAFE_FREE(zstd->seek.cached_content);
+    MEM_SAFE_FREE(zstd->seek.ahead_content);
   }
   else {
     MEM_freeN((void *)zstd->in_buf.src);
@@ -6,8 +6,12 @@
  * Task pool to run tasks in parallel.
  */
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "MEM_guardedalloc.h"
@@ -23,6 +27,9 @@
 #  include <tbb/blocked_range.h>
 #  include <tbb/task_arena.h>
 #  include <tbb/task_group.h>
+#  if TBB_INTERFACE_VERSION_MAJOR >= 12
+#    define WITH_TBB_ARENA_PRIORITY
+#  endif
 #endif
 
 /* Task
@@ -109,10 +116,9 @@ class TBBTaskGroup : public tbb::task_group {
  public:
   TBBTaskGroup(eTaskPriority priority)
   {
-#  if TBB_INTERFACE_VERSION_MAJOR >= 12
-    /* TODO: support priorities in TBB 2021, where they are only available as
-     * part of task arenas, no longer for task groups. Or remove support for
-     * task priorities if they are no longer useful. */
+#  ifdef WITH_TBB_ARENA_PRIORITY
+    /* Priorities are only available for task arenas in TBB 2021, low priority
+     * tasks use #LowPriorityTaskQueue instead. */
     UNUSED_VARS(priority);
 #  else
     switch (priority) {
@@ -128,6 +134,62 @@ class TBBTaskGroup : public tbb::task_group {
 };
 #endif
 
+/* Low Priority Task Queue.
+ *
+ * TBB 2021 only supports priorities for task arenas. Tasks of low priority pools
+ * are executed by a separate arena with low priority, which only gets worker
+ * threads when arenas of higher priority have no work. That way background work
+ * does not slow down interactive work.
+ *
+ * The arena executes tasks from a queue owned by the pool. Threads waiting for
+ * the pool execute tasks from the queue too, so they don't depend on the arena
+ * getting any workers. */
+
+#ifdef WITH_TBB_ARENA_PRIORITY
+static tbb::task_arena &low_priority_arena()
+{
+  static tbb::task_arena arena(
+      tbb::task_arena::automatic, 0, tbb::task_arena::priority::low);
+  return arena;
+}
+
+struct LowPriorityTaskQueue {
+  std::mutex mutex;
+  std::condition_variable tasks_done;
+  std::deque<Task> tasks;
+  int running_tasks_num = 0;
+  std::atomic<bool> is_canceling = false;
+
+  /* Execute the next task, returns false when there is none. */
+  bool run_next()
+  {
+    std::unique_lock lock{mutex};
+    if (tasks.empty()) {
+      return false;
+    }
+    {
+      Task task = std::move(tasks.front());
+      tasks.pop_front();
+      running_tasks_num++;
+      lock.unlock();
+      task();
+    }
+    lock.lock();
+    running_tasks_num--;
+    if (tasks.empty() && running_tasks_num == 0) {
+      tasks_done.notify_all();
+    }
+    return true;
+  }
+
+  void wait_running()
+  {
+    std::unique_lock lock{mutex};
+    tasks_done.wait(lock, [&]() { return tasks.empty() && running_tasks_num == 0; });
+  }
+};
+#endif
+
 /* Task Pool */
 
 enum TaskPoolType {
@@ -148,6 +210,11 @@ struct TaskPool {
 #ifdef WITH_TBB
   /* TBB task pool. */
   TBBTaskGroup tbb_group;
+#endif
+#ifdef WITH_TBB_ARENA_PRIORITY
+  /* Queue for low priority pools, shared with tasks in the low priority arena
+   * which may still be pending after the pool is freed. */
+  std::shared_ptr<LowPriorityTaskQueue> low_priority_queue;
 #endif
   volatile bool is_suspended;
   BLI_mempool *suspended_mempool;
@@ -183,6 +250,12 @@ static void tbb_task_pool_create(TaskPool *pool, eTaskPriority priority)
   if (pool->use_threads) {
     new (&pool->tbb_group) TBBTaskGroup(priority);
   }
+#  ifdef WITH_TBB_ARENA_PRIORITY
+  new (&pool->low_priority_queue) std::shared_ptr<LowPriorityTaskQueue>();
+  if (pool->use_threads && priority == TASK_PRIORITY_LOW) {
+    pool->low_priority_queue = std::make_shared<LowPriorityTaskQueue>();
+  }
+#  endif
 #else
   UNUSED_VARS(priority);
 #endif
@@ -202,6 +275,17 @@ static void tbb_task_pool_run(TaskPool *pool, Task &&task)
     std::atomic_thread_fence(std::memory_order_release);
 #endif
   }
+#ifdef WITH_TBB_ARENA_PRIORITY
+  else if (pool->low_priority_queue) {
+    /* Execute in the low priority arena. */
+    std::shared_ptr<LowPriorityTaskQueue> queue = pool->low_priority_queue;
+    {
+      std::lock_guard lock{queue->mutex};
+      queue->tasks.push_back(std::move(task));
+    }
+    low_priority_arena().enqueue([queue]() { queue->run_next(); });
+  }
+#endif
 #ifdef WITH_TBB
   else if (pool->use_threads) {
     /* Execute in TBB task group. */
@@ -229,6 +313,15 @@ static void tbb_task_pool_work_and_wait(TaskPool *pool)
     BLI_mempool_clear(pool->suspended_mempool);
   }
 
+#ifdef WITH_TBB_ARENA_PRIORITY
+  if (pool->low_priority_queue) {
+    /* Help with the remaining tasks, they are needed now. */
+    while (pool->low_priority_queue->run_next()) {
+    }
+    pool->low_priority_queue->wait_running();
+    return;
+  }
+#endif
 #ifdef WITH_TBB
   if (pool->use_threads) {
     /* This is called wait(), but internally it can actually do work. This
@@ -241,6 +334,22 @@ static void tbb_task_pool_work_and_wait(TaskPool *pool)
 
 static void tbb_task_pool_cancel(TaskPool *pool)
 {
+#ifdef WITH_TBB_ARENA_PRIORITY
+  if (pool->low_priority_queue) {
+    LowPriorityTaskQueue &queue = *pool->low_priority_queue;
+    std::deque<Task> canceled_tasks;
+    queue.is_canceling = true;
+    {
+      std::lock_guard lock{queue.mutex};
+      std::swap(canceled_tasks, queue.tasks);
+    }
+    /* Free task data outside of the lock. */
+    canceled_tasks.clear();
+    queue.wait_running();
+    queue.is_canceling = false;
+    return;
+  }
+#endif
 #ifdef WITH_TBB
   if (pool->use_threads) {
     pool->tbb_group.cancel();
@@ -253,6 +362,11 @@ static void tbb_task_pool_cancel(TaskPool *pool)
 
 static bool tbb_task_pool_canceled(TaskPool *pool)
 {
+#ifdef WITH_TBB_ARENA_PRIORITY
+  if (pool->low_priority_queue) {
+    return pool->low_priority_queue->is_canceling;
+  }
+#endif
 #ifdef WITH_TBB
   if (pool->use_threads) {
     return tbb::is_current_task_group_canceling();
@@ -271,6 +385,9 @@ static void tbb_task_pool_free(TaskPool *pool)
     pool->tbb_group.~TBBTaskGroup();
   }
 #endif
+#ifdef WITH_TBB_ARENA_PRIORITY
+  pool->low_priority_queue.~shared_ptr<LowPriorityTaskQueue>();
+#endif
 
   if (pool->suspended_mempool) {
     BLI_mempool_destroy(pool->suspended_mempool);
@@ -4,6 +4,12 @@
 
 #include <algorithm>
 
+#ifdef WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
 namespace blender::timeit {
 
 void print_duration(Nanoseconds duration)
@@ -19,6 +25,29 @@ void print_duration(Nanoseconds duration)
   }
 }
 
+Nanoseconds thread_cpu_time()
+{
+#ifdef WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return Nanoseconds(0);
+  }
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  /* The times are given in units of 100 nanoseconds. */
+  return Nanoseconds(int64_t(kernel.QuadPart + user.QuadPart) * 100);
+#else
+  timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+    return Nanoseconds(0);
+  }
+  return Nanoseconds(int64_t(time.tv_sec) * 1000000000 + int64_t(time.tv_nsec));
+#endif
+}
+
 ScopedTimerAveraged::~ScopedTimerAveraged()
 {
   const TimePoint end = Clock::now();
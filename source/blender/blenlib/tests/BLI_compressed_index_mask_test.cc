@@ -0,0 +1,233 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <set>
+
+#include "BLI_compressed_index_mask.hh"
+#include "BLI_rand.hh"
+
+namespace blender::tests {
+
+static Vector<int64_t> mask_to_vector(const CompressedIndexMask &mask)
+{
+  Vector<int64_t> indices;
+  mask.foreach_index([&](const int64_t i) { indices.append(i); });
+  return indices;
+}
+
+static Vector<int64_t> random_indices(const int64_t universe_size,
+                                      const float probability,
+                                      const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Vector<int64_t> indices;
+  for (const int64_t i : IndexRange(universe_size)) {
+    if (rng.get_float() < probability) {
+      indices.append(i);
+    }
+  }
+  return indices;
+}
+
+TEST(compressed_index_mask, DefaultConstructor)
+{
+  CompressedIndexMask mask;
+  EXPECT_TRUE(mask.is_empty());
+  EXPECT_EQ(mask.size(), 0);
+  EXPECT_EQ(mask.min_array_size(), 0);
+  EXPECT_FALSE(mask.is_range());
+  EXPECT_EQ(mask.segments_num(), 0);
+}
+
+TEST(compressed_index_mask, RangeConstructor)
+{
+  const int64_t segment_size = CompressedIndexMask::max_segment_size;
+  CompressedIndexMask mask(IndexRange(10, 3 * segment_size));
+  EXPECT_EQ(mask.size(), 3 * segment_size);
+  EXPECT_TRUE(mask.is_range());
+  EXPECT_EQ(mask.as_range(), IndexRange(10, 3 * segment_size));
+  EXPECT_EQ(mask.first(), 10);
+  EXPECT_EQ(mask.last(), 3 * segment_size + 9);
+  EXPECT_EQ(mask[0], 10);
+  EXPECT_EQ(mask[segment_size], segment_size + 10);
+  /* The range is split at window boundaries. */
+  EXPECT_EQ(mask.segments_num(), 4);
+  EXPECT_EQ(mask_to_vector(mask).as_span(), IndexRange(10, 3 * segment_size).as_span());
+}
+
+TEST(compressed_index_mask, FromIndices)
+{
+  const Vector<int64_t> indices = {0, 3, 4, 5, 100000, 100002, 1000000, 1000001};
+  const CompressedIndexMask mask = CompressedIndexMask::from_indices(indices);
+  EXPECT_EQ(mask.size(), indices.size());
+  EXPECT_FALSE(mask.is_range());
+  EXPECT_EQ(mask.segments_num(), 3);
+  EXPECT_EQ(mask.min_array_size(), 1000002);
+  for (const int64_t i : indices.index_range()) {
+    EXPECT_EQ(mask[i], indices[i]);
+  }
+  EXPECT_EQ(mask_to_vector(mask), indices);
+
+  Vector<int64_t> written_indices(mask.size());
+  mask.to_indices(written_indices);
+  EXPECT_EQ(written_indices, indices);
+}
+
+TEST(compressed_index_mask, FromIndexMask)
+{
+  EXPECT_TRUE(CompressedIndexMask::from_index_mask(IndexMask(1000)).is_range());
+  EXPECT_EQ(CompressedIndexMask::from_index_mask({}).size(), 0);
+  const CompressedIndexMask mask = CompressedIndexMask::from_index_mask({2, 3, 7});
+  EXPECT_EQ(mask_to_vector(mask).as_span(), Span<int64_t>({2, 3, 7}));
+}
+
+TEST(compressed_index_mask, ToIndexMask)
+{
+  Vector<int64_t> indices;
+  const IndexMask range_mask = CompressedIndexMask(IndexRange(5, 100000)).to_index_mask(indices);
+  EXPECT_TRUE(range_mask.is_range());
+  EXPECT_EQ(range_mask.as_range(), IndexRange(5, 100000));
+  EXPECT_TRUE(indices.is_empty());
+
+  const Vector<int64_t> expected = random_indices(100000, 0.3f, 0);
+  const IndexMask mask = CompressedIndexMask::from_indices(expected).to_index_mask(indices);
+  EXPECT_EQ(mask.indices(), expected.as_span());
+}
+
+TEST(compressed_index_mask, FromBools)
+{
+  Array<bool> bools(100000, false);
+  const Vector<int64_t> expected = random_indices(bools.size(), 0.5f, 1);
+  for (const int64_t i : expected) {
+    bools[i] = true;
+  }
+  const CompressedIndexMask mask = CompressedIndexMask::from_bools(bools);
+  EXPECT_EQ(mask_to_vector(mask), expected);
+  EXPECT_EQ(mask, CompressedIndexMask::from_indices(expected));
+
+  Array<bool> written_bools(bools.size(), false);
+  mask.to_bools(written_bools);
+  EXPECT_EQ(written_bools.as_span(), bools.as_span());
+}
+
+TEST(compressed_index_mask, FromPredicate)
+{
+  const IndexRange universe(1000, 200000);
+  const CompressedIndexMask mask = CompressedIndexMask::from_predicate(
+      universe, 1, [](const int64_t i) { return i % 3 == 0; });
+  Vector<int64_t> expected;
+  for (const int64_t i : universe) {
+    if (i % 3 == 0) {
+      expected.append(i);
+    }
+  }
+  EXPECT_EQ(mask_to_vector(mask), expected);
+
+  const CompressedIndexMask all = CompressedIndexMask::from_predicate(
+      universe, 4096, [](const int64_t /*i*/) { return true; });
+  EXPECT_EQ(all, CompressedIndexMask(universe));
+  EXPECT_TRUE(CompressedIndexMask::from_predicate(universe, 4096, [](const int64_t /*i*/) {
+                return false;
+              }).is_empty());
+}
+
+TEST(compressed_index_mask, MemoryUsage)
+{
+  const int64_t size = 10000000;
+  const CompressedIndexMask every_other = CompressedIndexMask::from_predicate(
+      IndexRange(size), 4096, [](const int64_t i) { return i % 2 == 0; });
+  EXPECT_EQ(every_other.size(), size / 2);
+  /* Two bytes per index, plus a small overhead per segment. */
+  EXPECT_LT(every_other.memory_usage(), size / 2 * sizeof(int16_t) * 11 / 10);
+
+  const CompressedIndexMask range{IndexRange(size)};
+  EXPECT_LT(range.memory_usage(), size / 100);
+}
+
+TEST(compressed_index_mask, ForeachIndexParallel)
+{
+  const Vector<int64_t> indices = random_indices(1000000, 0.1f, 2);
+  const CompressedIndexMask mask = CompressedIndexMask::from_indices(indices);
+  Array<bool> found(1000000, false);
+  mask.foreach_index(1, [&](const int64_t i) { found[i] = true; });
+  Array<bool> expected(1000000, false);
+  for (const int64_t i : indices) {
+    expected[i] = true;
+  }
+  EXPECT_EQ(found.as_span(), expected.as_span());
+}
+
+TEST(compressed_index_mask, ForeachSegment)
+{
+  const CompressedIndexMask mask = CompressedIndexMask::from_indices({1, 2, 3, 20000, 20005});
+  Vector<int64_t> offsets;
+  Vector<bool> is_range;
+  mask.foreach_segment([&](const int64_t offset, const Span<int16_t> relative_indices) {
+    offsets.append(offset);
+    is_range.append(CompressedIndexMask::relative_indices_are_range(relative_indices));
+  });
+  EXPECT_EQ(offsets.as_span(), Span<int64_t>({1, CompressedIndexMask::max_segment_size}));
+  EXPECT_EQ(is_range.as_span(), Span<bool>({true, false}));
+}
+
+TEST(compressed_index_mask, SetOperations)
+{
+  const IndexRange universe(70000);
+  const Vector<int64_t> indices_a = random_indices(universe.size(), 0.3f, 3);
+  /* Also test range segments and windows that only exist in one of the masks. */
+  Vector<int64_t> indices_b;
+  for (const int64_t i : random_indices(universe.size(), 0.6f, 4)) {
+    if ((i >= 16384 && i < 49152) || (i >= 50000 && i < 55000)) {
+      continue;
+    }
+    indices_b.append(i);
+  }
+  indices_b.extend(IndexRange(50000, 5000).as_span());
+  std::sort(indices_b.begin(), indices_b.end());
+
+  const std::set<int64_t> set_a(indices_a.begin(), indices_a.end());
+  const std::set<int64_t> set_b(indices_b.begin(), indices_b.end());
+  Vector<int64_t> expected_union;
+  Vector<int64_t> expected_intersection;
+  Vector<int64_t> expected_difference;
+  Vector<int64_t> expected_complement;
+  for (const int64_t i : universe) {
+    const bool in_a = set_a.count(i) > 0;
+    const bool in_b = set_b.count(i) > 0;
+    if (in_a || in_b) {
+      expected_union.append(i);
+    }
+    if (in_a && in_b) {
+      expected_intersection.append(i);
+    }
+    if (in_a && !in_b) {
+      expected_difference.append(i);
+    }
+    if (!in_a) {
+      expected_complement.append(i);
+    }
+  }
+
+  const CompressedIndexMask a = CompressedIndexMask::from_indices(indices_a);
+  const CompressedIndexMask b = CompressedIndexMask::from_indices(indices_b);
+  EXPECT_EQ(mask_to_vector(CompressedIndexMask::unite(a, b)), expected_union);
+  EXPECT_EQ(mask_to_vector(CompressedIndexMask::intersect(a, b)), expected_intersection);
+  EXPECT_EQ(mask_to_vector(CompressedIndexMask::difference(a, b)), expected_difference);
+  EXPECT_EQ(mask_to_vector(a.complement(universe)), expected_complement);
+  EXPECT_EQ(a.complement(universe).complement(universe), a);
+}
+
+TEST(compressed_index_mask, SetOperationsWithRanges)
+{
+  const CompressedIndexMask a(IndexRange(100, 50000));
+  const CompressedIndexMask b(IndexRange(30000, 50000));
+  EXPECT_EQ(CompressedIndexMask::unite(a, b), CompressedIndexMask(IndexRange(100, 79900)));
+  EXPECT_EQ(CompressedIndexMask::intersect(a, b), CompressedIndexMask(IndexRange(30000, 20100)));
+  EXPECT_EQ(CompressedIndexMask::difference(a, b), CompressedIndexMask(IndexRange(100, 29900)));
+  EXPECT_TRUE(CompressedIndexMask::intersect(a, {}).is_empty());
+  EXPECT_EQ(CompressedIndexMask::unite(a, {}), a);
+  EXPECT_TRUE(CompressedIndexMask(IndexRange(1000)).complement(IndexRange(1000)).is_empty());
+}
+
+}  // namespace blender::tests
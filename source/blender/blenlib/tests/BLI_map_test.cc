@@ -653,6 +653,45 @@ TEST(map, LookupKey)
   EXPECT_EQ(map.lookup_key_ptr("a"), map.lookup_key_ptr_as("a"));
 }
 
+TEST(map, GroupProbing)
+{
+  using GroupMap = Map<int, int, 4, GroupProbingStrategy>;
+  GroupMap map;
+  EXPECT_EQ(map.lookup_ptr(0), nullptr);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(map.add(i * 3, i));
+  }
+  EXPECT_FALSE(map.add(300, 0));
+  EXPECT_EQ(map.size(), 1000);
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(map.contains(i), i % 3 == 0);
+  }
+  EXPECT_EQ(map.lookup(300), 100);
+  EXPECT_EQ(map.pop(300), 100);
+  EXPECT_FALSE(map.remove(300));
+  EXPECT_EQ(map.lookup_or_add(300, 5), 5);
+  EXPECT_EQ(map.lookup_or_add_cb(301, []() { return 7; }), 7);
+  EXPECT_EQ(map.lookup_or_add_default(301), 7);
+  EXPECT_FALSE(map.add_overwrite(301, 8));
+  EXPECT_EQ(map.lookup(301), 8);
+  map.add_new(302, 9);
+  EXPECT_EQ(map.size(), 1002);
+
+  for (int i = 0; i < 3000; i += 2) {
+    map.remove(i);
+  }
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(map.contains(i), (i % 3 == 0 && i % 2 == 1) || i == 301);
+  }
+
+  GroupMap copied_map = map;
+  map.clear();
+  EXPECT_FALSE(map.contains(301));
+  EXPECT_EQ(copied_map.lookup(301), 8);
+  GroupMap moved_map = std::move(copied_map);
+  EXPECT_EQ(moved_map.lookup(3), 1);
+}
+
 /**
  * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
  */
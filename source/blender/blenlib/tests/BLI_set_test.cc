@@ -570,6 +570,56 @@ TEST(set, RemoveDuringIteration)
   EXPECT_TRUE(set.contains(3));
 }
 
+TEST(set, GroupProbing)
+{
+  using GroupSet = Set<int, 4, GroupProbingStrategy>;
+  GroupSet set;
+  EXPECT_FALSE(set.contains(0));
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(set.add(i * 3));
+  }
+  EXPECT_FALSE(set.add(300));
+  EXPECT_EQ(set.size(), 1000);
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(set.contains(i), i % 3 == 0);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    set.remove_contained(i * 3);
+  }
+  EXPECT_EQ(set.size(), 500);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(set.contains(i * 3), i % 2 == 1);
+  }
+  EXPECT_EQ(set.lookup_key_or_add(9), 9);
+  EXPECT_EQ(set.lookup_key_or_add(6), 6);
+  EXPECT_EQ(set.size(), 501);
+
+  GroupSet copied_set = set;
+  set.clear();
+  EXPECT_FALSE(set.contains(9));
+  EXPECT_TRUE(copied_set.contains(9));
+  GroupSet moved_set = std::move(copied_set);
+  EXPECT_TRUE(moved_set.contains(6));
+  EXPECT_EQ(moved_set.size(), 501);
+}
+
+TEST(set, GroupProbingRemoveDuringIteration)
+{
+  Set<int, 4, GroupProbingStrategy> set;
+  for (int i = 0; i < 100; i++) {
+    set.add_new(i);
+  }
+  for (auto it = set.begin(); it != set.end(); ++it) {
+    if (*it % 3 == 0) {
+      set.remove(it);
+    }
+  }
+  EXPECT_EQ(set.size(), 66);
+  EXPECT_FALSE(set.contains(3));
+  EXPECT_TRUE(set.contains(4));
+  EXPECT_TRUE(set.add(3));
+}
+
 /**
  * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
  */
@@ -3,6 +3,7 @@
 #include "testing/testing.h"
 #include <atomic>
 #include <cstring>
+#include <thread>
 
 #include "atomic_ops.h"
 
@@ -294,3 +295,93 @@ TEST(task, ParallelInvoke)
                                       [&]() { counter++; });
   EXPECT_EQ(counter, 6);
 }
+
+TEST(task, LowPriorityPool)
+{
+  BLI_threadapi_init();
+
+  std::atomic<int> counter = 0;
+  TaskPool *pool = BLI_task_pool_create(&counter, TASK_PRIORITY_LOW);
+  for (int i = 0; i < 200; i++) {
+    BLI_task_pool_push(
+        pool,
+        [](TaskPool *__restrict pool, void * /*taskdata*/) {
+          std::atomic<int> *counter = static_cast<std::atomic<int> *>(
+              BLI_task_pool_user_data(pool));
+          (*counter)++;
+        },
+        nullptr,
+        false,
+        nullptr);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+  EXPECT_EQ(counter, 200);
+
+  BLI_threadapi_exit();
+}
+
+TEST(task, TaskGroup)
+{
+  BLI_threadapi_init();
+
+  std::atomic<int> counter = 0;
+  blender::threading::TaskGroup group;
+  for (int i = 0; i < 10; i++) {
+    group.run([&]() {
+      blender::threading::TaskGroup nested_group(TASK_PRIORITY_HIGH, &group.token());
+      for (int j = 0; j < 100; j++) {
+        nested_group.run([&]() { counter++; });
+      }
+      nested_group.wait();
+    });
+  }
+  group.wait();
+  EXPECT_EQ(counter, 1000);
+
+  BLI_threadapi_exit();
+}
+
+TEST(task, TaskGroupCancel)
+{
+  BLI_threadapi_init();
+
+  std::atomic<int> counter = 0;
+  blender::threading::TaskGroup group;
+  group.cancel();
+  for (int i = 0; i < 100; i++) {
+    group.run([&]() { counter++; });
+  }
+  group.wait();
+  EXPECT_TRUE(group.is_canceled());
+  EXPECT_EQ(counter, 0);
+
+  BLI_threadapi_exit();
+}
+
+TEST(task, TaskGroupCpuTime)
+{
+  BLI_threadapi_init();
+
+  blender::threading::TaskGroup group;
+  group.run([]() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+  group.wait();
+  /* Sleeping does not use the CPU. */
+  EXPECT_LT(group.cpu_time(), 0.05);
+
+  BLI_threadapi_exit();
+}
+
+TEST(task, ParallelInvokeCancelable)
+{
+  std::atomic<int> counter = 0;
+  blender::threading::CancellationToken token;
+  blender::threading::parallel_invoke_cancelable(
+      token, [&]() { counter++; }, [&]() { counter++; });
+  EXPECT_EQ(counter, 2);
+
+  token.cancel();
+  blender::threading::parallel_invoke_cancelable(
+      token, [&]() { counter++; }, [&]() { counter++; });
+  EXPECT_EQ(counter, 2);
+}
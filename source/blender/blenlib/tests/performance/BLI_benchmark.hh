@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * A minimal micro-benchmark harness on top of gtest, loosely following Google Benchmark. Every
+ * benchmark is run in batches that take at least a minimum time and the fastest batch is reported.
+ * Results can be written to a JSON file that uses the same layout as the output of Google
+ * Benchmark, so that existing tools to compare runs can be used. A previously written file can
+ * also be used as baseline to detect regressions, see #compare_to_baseline.
+ */
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_timeit.hh"
+
+namespace blender::benchmark {
+
+struct Options {
+  /** Minimum time in seconds that a single repetition of a benchmark should run. */
+  double min_time = 0.1;
+  /** Number of repetitions. The fastest repetition is reported. */
+  int repetitions = 3;
+};
+
+struct Result {
+  std::string name;
+  int64_t iterations;
+  /** Wall clock time per iteration of the fastest repetition, in nanoseconds. */
+  double real_time;
+  /** Processor time of all threads per iteration of the fastest repetition, in nanoseconds. */
+  double cpu_time;
+  /** Number of processed elements per iteration, used to compute the throughput. */
+  int64_t items_per_iteration;
+};
+
+inline Options &options()
+{
+  static Options options;
+  return options;
+}
+
+/**
+ * Uses std::vector instead of #blender::Vector, because the results have to outlive the memory
+ * leak detection at the end of the tests.
+ */
+inline std::vector<Result> &results()
+{
+  static std::vector<Result> results;
+  return results;
+}
+
+/** Make sure that the compiler does not optimize away the computation of the given value. */
+template<typename T> inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const void *volatile sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * Run the benchmark function repeatedly and record the time per call.
+ * \param items_per_iteration: Number of elements processed by one call of #fn.
+ */
+inline void run(const StringRef name, const int64_t items_per_iteration, FunctionRef<void()> fn)
+{
+  using namespace timeit;
+  const Options &opts = options();
+  const Nanoseconds min_time{int64_t(opts.min_time * 1e9)};
+
+  /* Warm up caches and find the number of iterations that fills the minimum time. */
+  int64_t iterations = 1;
+  while (true) {
+    const TimePoint start = Clock::now();
+    for (int64_t i = 0; i < iterations; i++) {
+      fn();
+    }
+    const Nanoseconds duration = Clock::now() - start;
+    if (duration >= min_time || iterations >= (int64_t(1) << 40)) {
+      break;
+    }
+    const int64_t factor = duration.count() > 0 ? min_time.count() / duration.count() + 1 : 10;
+    iterations *= std::clamp<int64_t>(factor, 2, 10);
+  }
+
+  Result result{name, iterations, std::numeric_limits<double>::max(), 0.0, items_per_iteration};
+  for ([[maybe_unused]] const int repetition : IndexRange(std::max(opts.repetitions, 1))) {
+    const std::clock_t cpu_start = std::clock();
+    const TimePoint start = Clock::now();
+    for (int64_t i = 0; i < iterations; i++) {
+      fn();
+    }
+    const Nanoseconds duration = Clock::now() - start;
+    const std::clock_t cpu_end = std::clock();
+    const double real_time = double(duration.count()) / double(iterations);
+    if (real_time < result.real_time) {
+      result.real_time = real_time;
+      result.cpu_time = double(cpu_end - cpu_start) * 1e9 / CLOCKS_PER_SEC / double(iterations);
+    }
+  }
+
+  std::cout << std::left << std::setw(56) << result.name << std::right << std::setw(14)
+            << std::fixed << std::setprecision(1) << result.real_time << " ns" << std::setw(12)
+            << iterations << " it";
+  if (items_per_iteration > 0) {
+    std::cout << std::setw(12) << std::setprecision(2)
+              << double(items_per_iteration) / result.real_time * 1e3 << " M items/s";
+  }
+  std::cout << std::defaultfloat << "\n";
+
+  results().push_back(std::move(result));
+}
+
+/** Write all recorded results in the JSON format used by Google Benchmark. */
+inline bool write_json(const StringRefNull filepath)
+{
+  std::ofstream file(filepath.c_str());
+  if (!file) {
+    return false;
+  }
+  file << "{\n";
+  file << "  \"context\": {\n";
+  file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  file << "    \"library_build_type\": \"release\"\n";
+#else
+  file << "    \"library_build_type\": \"debug\"\n";
+#endif
+  file << "  },\n";
+  file << "  \"benchmarks\": [";
+  const std::vector<Result> &all_results = results();
+  for (const int64_t i : IndexRange(int64_t(all_results.size()))) {
+    const Result &result = all_results[i];
+    file << (i == 0 ? "\n" : ",\n");
+    file << "    {\n";
+    file << "      \"name\": \"" << result.name << "\",\n";
+    file << "      \"run_type\": \"iteration\",\n";
+    file << "      \"iterations\": " << result.iterations << ",\n";
+    file << "      \"real_time\": " << result.real_time << ",\n";
+    file << "      \"cpu_time\": " << result.cpu_time << ",\n";
+    if (result.items_per_iteration > 0) {
+      file << "      \"items_per_second\": "
+           << double(result.items_per_iteration) / result.real_time * 1e9 << ",\n";
+    }
+    file << "      \"time_unit\": \"ns\"\n";
+    file << "    }";
+  }
+  file << "\n  ]\n}\n";
+  return bool(file);
+}
+
+/**
+ * Read the wall clock time per iteration of every benchmark from a JSON file written by
+ * #write_json or by Google Benchmark. Only the keys used here are parsed, every key is expected
+ * on its own line.
+ */
+inline bool read_json_real_times(const StringRefNull filepath,
+                                 std::map<std::string, double> &r_real_times)
+{
+  std::ifstream file(filepath.c_str());
+  if (!file) {
+    return false;
+  }
+  std::string name;
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t key_start = line.find('"');
+    if (key_start == std::string::npos) {
+      continue;
+    }
+    const size_t key_end = line.find('"', key_start + 1);
+    const size_t colon = line.find(':', key_end);
+    if (key_end == std::string::npos || colon == std::string::npos) {
+      continue;
+    }
+    const std::string key = line.substr(key_start + 1, key_end - key_start - 1);
+    const std::string value = line.substr(colon + 1);
+    if (key == "name") {
+      const size_t value_start = value.find('"');
+      const size_t value_end = value.rfind('"');
+      if (value_start == std::string::npos || value_end <= value_start) {
+        return false;
+      }
+      name = value.substr(value_start + 1, value_end - value_start - 1);
+    }
+    else if (key == "real_time" && !name.empty()) {
+      std::istringstream stream(value);
+      double real_time;
+      if (!(stream >> real_time)) {
+        return false;
+      }
+      r_real_times[name] = real_time;
+    }
+  }
+  return true;
+}
+
+/**
+ * Compare the recorded results with a baseline file from an earlier run on the same machine.
+ * \param tolerance: Relative slowdown that is still accepted, e.g. 0.25 for 25%.
+ * \return The names of the benchmarks that are slower than the baseline allows. Benchmarks
+ * that are missing in the baseline are ignored.
+ */
+inline std::vector<std::string> compare_to_baseline(const std::map<std::string, double> &baseline,
+                                                    const double tolerance)
+{
+  std::vector<std::string> regressions;
+  for (const Result &result : results()) {
+    const auto item = baseline.find(result.name);
+    if (item == baseline.end()) {
+      continue;
+    }
+    const double baseline_time = item->second;
+    std::cout << std::left << std::setw(56) << result.name << std::right << std::setw(14)
+              << std::fixed << std::setprecision(1) << baseline_time << " ns ->"
+              << std::setw(12) << result.real_time << " ns" << std::setw(9)
+              << std::setprecision(2) << result.real_time / baseline_time << "x"
+              << std::defaultfloat << "\n";
+    if (result.real_time > baseline_time * (1.0 + tolerance)) {
+      regressions.push_back(result.name);
+    }
+  }
+  return regressions;
+}
+
+}  // namespace blender::benchmark
@@ -0,0 +1,315 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_benchmark.hh"
+
+#include "BLI_compressed_index_mask.hh"
+#include "BLI_devirtualize_parameters.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_index_mask_ops.hh"
+#include "BLI_linear_allocator.hh"
+#include "BLI_map.hh"
+#include "BLI_rand.hh"
+#include "BLI_set.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+#include "BLI_vector_set.hh"
+#include "BLI_virtual_array.hh"
+
+/**
+ * Micro-benchmarks for containers and parallel primitives that are used in hot loops.
+ *
+ * Run with `--benchmark-out=<file>.json` to write the results in the format of Google Benchmark.
+ * To detect regressions, pass the file of an earlier run on the same machine with
+ * `--benchmark-baseline=<file>.json`. The test fails when a benchmark is slower than the baseline
+ * by more than `--benchmark-tolerance`. A missing baseline file is not an error, so the same file
+ * can be passed for both options to compare every run with the previous one.
+ *
+ * Timings depend on the machine, so no baseline is checked in. ctest compares every run with the
+ * results of the previous run in the build directory, with a short minimum time and a large
+ * tolerance so that only large regressions are caught.
+ */
+
+DEFINE_string(benchmark_out, "", "Write benchmark results to this JSON file.");
+DEFINE_string(benchmark_baseline, "", "Compare benchmark results with this JSON file.");
+DEFINE_double(benchmark_tolerance, 0.25, "Accepted relative slowdown compared to the baseline.");
+DEFINE_double(benchmark_min_time, 0.1, "Minimum time in seconds per benchmark repetition.");
+DEFINE_int32(benchmark_repetitions, 3, "Number of repetitions for every benchmark.");
+
+namespace blender::benchmark::tests {
+
+class BenchmarkEnvironment : public ::testing::Environment {
+ private:
+  std::map<std::string, double> baseline_;
+
+ public:
+  void SetUp() override
+  {
+    options().min_time = FLAGS_benchmark_min_time;
+    options().repetitions = FLAGS_benchmark_repetitions;
+
+    /* Read the baseline before running, it may be the same file the results are written to. */
+    if (!FLAGS_benchmark_baseline.empty()) {
+      if (!std::ifstream(FLAGS_benchmark_baseline).good()) {
+        std::cout << "No benchmark baseline at " << FLAGS_benchmark_baseline << "\n";
+      }
+      else if (!read_json_real_times(FLAGS_benchmark_baseline, baseline_)) {
+        ADD_FAILURE() << "Could not read benchmark baseline from " << FLAGS_benchmark_baseline;
+      }
+    }
+  }
+
+  void TearDown() override
+  {
+    const std::vector<std::string> regressions = compare_to_baseline(baseline_,
+                                                                     FLAGS_benchmark_tolerance);
+    for (const std::string &name : regressions) {
+      ADD_FAILURE() << "Benchmark " << name << " is slower than the baseline";
+    }
+    if (FLAGS_benchmark_out.empty()) {
+      return;
+    }
+    if (!regressions.empty() && FLAGS_benchmark_out == FLAGS_benchmark_baseline) {
+      /* Keep failing until the regression is fixed or the baseline file is removed. */
+      std::cout << "Not updating benchmark baseline " << FLAGS_benchmark_out << "\n";
+      return;
+    }
+    if (!write_json(FLAGS_benchmark_out)) {
+      ADD_FAILURE() << "Could not write benchmark results to " << FLAGS_benchmark_out;
+    }
+  }
+};
+
+static ::testing::Environment *const benchmark_environment =
+    ::testing::AddGlobalTestEnvironment(new BenchmarkEnvironment());
+
+static Vector<int> random_ints(const int64_t size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Vector<int> values(size);
+  for (int &value : values) {
+    value = rng.get_int32();
+  }
+  return values;
+}
+
+TEST(benchmark, Vector)
+{
+  const int64_t size = 100000;
+  run("Vector/append/" + std::to_string(size), size, [&]() {
+    Vector<int> vec;
+    for (const int i : IndexRange(size)) {
+      vec.append(i);
+    }
+    do_not_optimize(vec.last());
+  });
+  run("Vector/append_reserved/" + std::to_string(size), size, [&]() {
+    Vector<int> vec;
+    vec.reserve(size);
+    for (const int i : IndexRange(size)) {
+      vec.append_unchecked(i);
+    }
+    do_not_optimize(vec.last());
+  });
+  const Vector<int> values = random_ints(size, 0);
+  run("Vector/iterate/" + std::to_string(size), size, [&]() {
+    int sum = 0;
+    for (const int value : values) {
+      sum += value;
+    }
+    do_not_optimize(sum);
+  });
+  run("Vector/copy/" + std::to_string(size), size, [&]() {
+    Vector<int> copy = values;
+    do_not_optimize(copy.first());
+  });
+}
+
+TEST(benchmark, Map)
+{
+  const int64_t size = 100000;
+  const Vector<int> keys = random_ints(size, 1);
+  run("Map/add/" + std::to_string(size), size, [&]() {
+    Map<int, int> map;
+    for (const int i : keys.index_range()) {
+      map.add(keys[i], i);
+    }
+    do_not_optimize(map.size());
+  });
+  Map<int, int> map;
+  for (const int i : keys.index_range()) {
+    map.add(keys[i], i);
+  }
+  run("Map/lookup/" + std::to_string(size), size, [&]() {
+    int64_t sum = 0;
+    for (const int key : keys) {
+      sum += map.lookup(key);
+    }
+    do_not_optimize(sum);
+  });
+  const Vector<int> missing_keys = random_ints(size, 2);
+  run("Map/lookup_missing/" + std::to_string(size), size, [&]() {
+    int64_t sum = 0;
+    for (const int key : missing_keys) {
+      sum += map.lookup_default(key, 0);
+    }
+    do_not_optimize(sum);
+  });
+}
+
+TEST(benchmark, Set)
+{
+  const int64_t size = 100000;
+  const Vector<int> keys = random_ints(size, 3);
+  run("Set/add/" + std::to_string(size), size, [&]() {
+    Set<int> set;
+    for (const int key : keys) {
+      set.add(key);
+    }
+    do_not_optimize(set.size());
+  });
+  const Set<int> set(keys);
+  run("Set/contains/" + std::to_string(size), size, [&]() {
+    int64_t count = 0;
+    for (const int key : keys) {
+      count += set.contains(key);
+    }
+    do_not_optimize(count);
+  });
+}
+
+TEST(benchmark, VectorSet)
+{
+  const int64_t size = 100000;
+  const Vector<int> keys = random_ints(size, 4);
+  run("VectorSet/add/" + std::to_string(size), size, [&]() {
+    VectorSet<int> set;
+    for (const int key : keys) {
+      set.add(key);
+    }
+    do_not_optimize(set.size());
+  });
+  const VectorSet<int> set(keys);
+  run("VectorSet/index_of/" + std::to_string(size), size, [&]() {
+    int64_t sum = 0;
+    for (const int key : keys) {
+      sum += set.index_of(key);
+    }
+    do_not_optimize(sum);
+  });
+}
+
+TEST(benchmark, IndexMask)
+{
+  const int64_t size = 1000000;
+  Array<float> values(size, 1.0f);
+  run("IndexMask/foreach_range/" + std::to_string(size), size, [&]() {
+    const IndexMask mask(size);
+    mask.foreach_index([&](const int64_t i) { values[i] *= 1.0001f; });
+    do_not_optimize(values[0]);
+  });
+  Vector<int64_t> even_indices;
+  for (int64_t i = 0; i < size; i += 2) {
+    even_indices.append(i);
+  }
+  run("IndexMask/foreach_indices/" + std::to_string(size), size / 2, [&]() {
+    const IndexMask mask(even_indices);
+    mask.foreach_index([&](const int64_t i) { values[i] *= 1.0001f; });
+    do_not_optimize(values[0]);
+  });
+  const Vector<int> random_values = random_ints(size, 5);
+  run("IndexMask/find_indices_based_on_predicate/" + std::to_string(size), size, [&]() {
+    Vector<int64_t> indices;
+    const IndexMask mask = index_mask_ops::find_indices_based_on_predicate(
+        IndexMask(size), 4096, indices, [&](const int64_t i) { return random_values[i] & 1; });
+    do_not_optimize(mask.size());
+  });
+  const CompressedIndexMask compressed_mask = CompressedIndexMask::from_indices(even_indices);
+  run("CompressedIndexMask/foreach_indices/" + std::to_string(size), size / 2, [&]() {
+    compressed_mask.foreach_index([&](const int64_t i) { values[i] *= 1.0001f; });
+    do_not_optimize(values[0]);
+  });
+  run("CompressedIndexMask/from_predicate/" + std::to_string(size), size, [&]() {
+    const CompressedIndexMask mask = CompressedIndexMask::from_predicate(
+        IndexRange(size), 4096, [&](const int64_t i) { return random_values[i] & 1; });
+    do_not_optimize(mask.size());
+  });
+}
+
+TEST(benchmark, VArrayDevirtualize)
+{
+  const int64_t size = 1000000;
+  const Array<float> values(size, 1.0f);
+  const VArray<float> varray_span = VArray<float>::ForSpan(values);
+  const VArray<float> varray_single = VArray<float>::ForSingle(1.0f, size);
+  const VArray<float> varray_func = VArray<float>::ForFunc(size,
+                                                          [](const int64_t) { return 1.0f; });
+
+  auto sum_varray = [&](const VArray<float> &varray, const bool devirtualize) {
+    float sum = 0.0f;
+    devirtualize_varray(
+        varray,
+        [&](auto varray) {
+          for (const int64_t i : IndexRange(size)) {
+            sum += varray[i];
+          }
+        },
+        devirtualize);
+    do_not_optimize(sum);
+  };
+
+  for (const bool devirtualize : {false, true}) {
+    const std::string suffix = std::string(devirtualize ? "devirtualized/" : "virtual/") +
+                               std::to_string(size);
+    run("VArray/span/" + suffix, size, [&]() { sum_varray(varray_span, devirtualize); });
+    run("VArray/single/" + suffix, size, [&]() { sum_varray(varray_single, devirtualize); });
+    run("VArray/func/" + suffix, size, [&]() { sum_varray(varray_func, devirtualize); });
+  }
+}
+
+TEST(benchmark, ParallelForGrainSize)
+{
+  const int64_t size = 1000000;
+  Array<float> values(size, 1.0f);
+  for (const int64_t grain_size : {1, 64, 1024, 16384, 262144}) {
+    run("parallel_for/grain_size_" + std::to_string(grain_size) + "/" + std::to_string(size),
+        size,
+        [&]() {
+          threading::parallel_for(values.index_range(), grain_size, [&](const IndexRange range) {
+            for (const int64_t i : range) {
+              values[i] = values[i] * 0.5f + 1.0f;
+            }
+          });
+          do_not_optimize(values[0]);
+        });
+  }
+}
+
+TEST(benchmark, LinearAllocator)
+{
+  const int64_t size = 100000;
+  run("LinearAllocator/allocate/" + std::to_string(size), size, [&]() {
+    LinearAllocator<> allocator;
+    for ([[maybe_unused]] const int64_t i : IndexRange(size)) {
+      do_not_optimize(allocator.allocate<int64_t>());
+    }
+  });
+  run("LinearAllocator/construct_array/" + std::to_string(size), size, [&]() {
+    LinearAllocator<> allocator;
+    for ([[maybe_unused]] const int64_t i : IndexRange(size / 16)) {
+      do_not_optimize(allocator.construct_array<int>(16, 0).data());
+    }
+  });
+  run("MEM_mallocN/allocate/" + std::to_string(size), size, [&]() {
+    Vector<void *> pointers(size);
+    for (void *&ptr : pointers) {
+      ptr = MEM_mallocN(sizeof(int64_t), __func__);
+    }
+    for (void *ptr : pointers) {
+      MEM_freeN(ptr);
+    }
+  });
+}
+
+}  // namespace blender::benchmark::tests
@@ -0,0 +1,142 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "BLI_ressource_strings.h"
+#include "testing/testing.h"
+
+#include "BLI_map.hh"
+#include "BLI_rand.hh"
+#include "BLI_set.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+/* Compare the default probing strategy of #blender::Map and #blender::Set with group probing,
+ * which checks many slots at once using control bytes. */
+
+namespace blender::tests {
+
+template<typename Key, typename ProbingStrategy>
+static void map_tests(const Span<Key> keys, const Span<Key> missing_keys, const std::string &name)
+{
+  Map<Key, int, 4, ProbingStrategy> map;
+  {
+    SCOPED_TIMER(name + " add");
+    for (const int i : keys.index_range()) {
+      map.add(keys[i], i);
+    }
+  }
+  int64_t found = 0;
+  {
+    SCOPED_TIMER(name + " lookup");
+    for (const Key &key : keys) {
+      found += map.lookup(key);
+    }
+  }
+  {
+    SCOPED_TIMER(name + " lookup missing");
+    for (const Key &key : missing_keys) {
+      found += map.contains(key);
+    }
+  }
+  {
+    SCOPED_TIMER(name + " remove");
+    for (const Key &key : keys) {
+      found += map.remove(key);
+    }
+  }
+  EXPECT_TRUE(map.is_empty());
+  /* Print the value to avoid some compiler optimizations. */
+  std::cout << "Found: " << found << "\n\n";
+}
+
+template<typename Key, typename ProbingStrategy>
+static void set_tests(const Span<Key> keys, const std::string &name)
+{
+  Set<Key, 4, ProbingStrategy> set;
+  int64_t added = 0;
+  {
+    SCOPED_TIMER(name + " add with duplicates");
+    for (const Key &key : keys) {
+      added += set.add(key);
+    }
+    for (const Key &key : keys) {
+      added += set.add(key);
+    }
+  }
+  std::cout << "Added: " << added << "\n\n";
+}
+
+template<typename Key>
+static void compare_strategies(const Span<Key> keys,
+                               const Span<Key> missing_keys,
+                               const std::string &name)
+{
+  std::cout << "========== " << name << " (" << keys.size() << " keys) ==========\n";
+  for ([[maybe_unused]] const int i : IndexRange(3)) {
+    map_tests<Key, DefaultProbingStrategy>(keys, missing_keys, name + " Map Python");
+    map_tests<Key, GroupProbingStrategy>(keys, missing_keys, name + " Map Group ");
+    set_tests<Key, DefaultProbingStrategy>(keys, name + " Set Python");
+    set_tests<Key, GroupProbingStrategy>(keys, name + " Set Group ");
+  }
+}
+
+TEST(map, IntSequential1000000)
+{
+  Vector<int> keys;
+  Vector<int> missing_keys;
+  for (const int i : IndexRange(1000000)) {
+    keys.append(i);
+    missing_keys.append(-i - 1);
+  }
+  compare_strategies<int>(keys, missing_keys, "Int Sequential");
+}
+
+TEST(map, IntRandom1000000)
+{
+  RandomNumberGenerator rng(0);
+  Vector<int> keys;
+  Vector<int> missing_keys;
+  for ([[maybe_unused]] const int i : IndexRange(1000000)) {
+    /* Even keys are added, odd keys are missing. */
+    keys.append(rng.get_int32() & ~1);
+    missing_keys.append(rng.get_int32() | 1);
+  }
+  compare_strategies<int>(keys, missing_keys, "Int Random");
+}
+
+/* Edges of a grid, similar to the edge map built when calculating mesh edges. */
+TEST(map, GridEdges1000x1000)
+{
+  const int size = 1000;
+  Vector<std::pair<int, int>> keys;
+  Vector<std::pair<int, int>> missing_keys;
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size - 1)) {
+      const int v = y * size + x;
+      keys.append({v, v + 1});
+      if (y < size - 1) {
+        keys.append({v, v + size});
+        missing_keys.append({v, v + size + 1});
+      }
+    }
+  }
+  compare_strategies<std::pair<int, int>>(keys, missing_keys, "Grid Edges");
+}
+
+TEST(map, Words10k)
+{
+  Vector<std::string> words;
+  Vector<std::string> missing_words;
+  for (StringRef text = words10k; !text.is_empty();) {
+    const int64_t end = text.find_first_of(" \n.,");
+    const StringRef word = text.substr(0, end == StringRef::not_found ? text.size() : end);
+    if (!word.is_empty()) {
+      words.append(std::string(word));
+      missing_words.append(std::string(word) + "_missing");
+    }
+    text = text.drop_prefix(std::min(word.size() + 1, text.size()));
+  }
+  compare_strategies<std::string>(words, missing_words, "Words");
+}
+
+}  // namespace blender::tests
@@ -50,6 +50,12 @@ enum {
    * (written to #BLENDER_STARTUP_FILE & #BLENDER_USERPREF_FILE).
    */
   USER = BLEND_MAKE_ID('U', 'S', 'E', 'R'),
+  /**
+   * Used to store the offset, code and name of every local ID block,
+   * written between #DNA1 and #ENDB blocks so it can be found from the end of the file.
+   * (ignored for regular file reading, see #BHeadIndexHeader).
+   */
+  INDX = BLEND_MAKE_ID('I', 'N', 'D', 'X'),
   /**
    * Terminate reading (no data).
    */
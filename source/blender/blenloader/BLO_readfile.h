@@ -86,6 +86,8 @@ typedef struct BlendFileReadReport {
     double lib_overrides;
     double lib_overrides_resync;
     double lib_overrides_recursive_resync;
+    /** Time spent in `do_versions` functions, for the main file and its libraries. */
+    double versioning;
   } duration;
 
   /* Count information. */
@@ -324,6 +326,13 @@ typedef enum eBLOLibLinkFlags {
   BLO_LIBLINK_OBDATA_INSTANCE = 1 << 24,
   /** Instantiate collections as empties, instead of linking them into current view layer. */
   BLO_LIBLINK_COLLECTION_INSTANCE = 1 << 25,
+  /**
+   * Only create place-holders for meshes, images and node-groups that linked IDs depend on,
+   * their data is read later, once needed (see #LIB_TAG_LAZY_LINK).
+   * The library remembers this (see #LIBRARY_FLAG_LAZY_LINK), so that its dependencies are also
+   * linked lazily when the file is opened again.
+   */
+  BLO_LIBLINK_USE_LAZY = 1 << 26,
 } eBLOLibLinkFlags;
 
 /**
@@ -19,6 +19,9 @@ typedef struct {
   /** Size in bytes. */
   size_t size;
   /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  bool is_shared;
+  /** When true, this chunk is identical to the one at the same place in the previous step (used
+   * by undo code to detect unchanged IDs). Such chunks always share their memory. */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -27,6 +30,9 @@ typedef struct {
   /** Session UUID of the ID being currently written (MAIN_ID_SESSION_UUID_UNSET when not writing
    * ID-related data). Used to find matching chunks in previous memundo step. */
   uint id_session_uuid;
+  /** Hash of the content for parts of large arrays (zero otherwise), used to find matching chunks
+   * in previous memundo step when the array was resized, see #BLO_memfile_chunk_add_ex. */
+  uint content_hash;
 } MemFileChunk;
 
 typedef struct MemFile {
@@ -43,6 +49,8 @@ typedef struct MemFileWriteData {
 
   /** Maps an ID session uuid to its first reference MemFileChunk, if existing. */
   struct GHash *id_session_uuid_mapping;
+  /** Maps a #MemFileChunk.content_hash to a reference MemFileChunk, if existing. */
+  struct GHash *content_hash_mapping;
 } MemFileWriteData;
 
 typedef struct MemFileUndoData {
@@ -69,6 +77,16 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * Add a chunk which is part of a large array, split at boundaries depending on its content.
+ * When it doesn't match the next chunk of the reference #MemFile, a chunk with the same
+ * \a content_hash is searched for, so data following inserted or removed elements is shared
+ * with the reference #MemFile too.
+ */
+void BLO_memfile_chunk_add_ex(MemFileWriteData *mem_data,
+                              const char *buf,
+                              size_t size,
+                              uint content_hash);
 
 /* exports */
 
@@ -12,6 +12,7 @@
 extern "C" {
 #endif
 
+struct BlendFileWriteCache;
 struct BlendThumbnail;
 struct Main;
 struct MemFile;
@@ -46,6 +47,11 @@ struct BlendFileWriteParams {
   uint use_save_as_copy : 1;
   uint use_userdef : 1;
   const struct BlendThumbnail *thumb;
+  /**
+   * Optional, data kept from a previous save, so that data-blocks which did not change are
+   * neither copied nor compressed again. Updated with the data written by this save.
+   */
+  struct BlendFileWriteCache *cache;
 };
 
 /**
@@ -57,6 +63,15 @@ extern bool BLO_write_file(struct Main *mainvar,
                            const struct BlendFileWriteParams *params,
                            struct ReportList *reports);
 
+/**
+ * Data kept between saves for incremental writing, see #BlendFileWriteParams.cache.
+ * This holds a copy of the uncompressed file, so it uses as much memory as an undo step.
+ */
+typedef struct BlendFileWriteCache BlendFileWriteCache;
+
+extern BlendFileWriteCache *BLO_write_cache_new(void);
+extern void BLO_write_cache_free(BlendFileWriteCache *cache);
+
 /**
  * \return Success.
  */
@@ -110,6 +110,24 @@ LinkNode *BLO_blendhandle_get_datablock_names(BlendHandle *bh,
   BHead *bhead;
   int tot = 0;
 
+  if (fd->bhead_index != NULL) {
+    /* Avoid reading all blocks of the file. */
+    const BHeadIndexEntry *entries = BHEAD_INDEX_ENTRIES(fd->bhead_index);
+    for (int i = 0; i < fd->bhead_index->entries_num; i++) {
+      if (entries[i].code != ofblocktype) {
+        continue;
+      }
+      if (use_assets_only && (entries[i].flag & BHEAD_INDEX_ENTRY_IS_ASSET) == 0) {
+        continue;
+      }
+      BLI_linklist_prepend(&names, BLI_strdupn(entries[i].name + 2, sizeof(entries[i].name) - 2));
+      tot++;
+    }
+
+    *r_tot_names = tot;
+    return names;
+  }
+
   for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
     if (bhead->code == ofblocktype) {
       const char *idname = blo_bhead_id_name(fd, bhead);
@@ -315,6 +333,19 @@ LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype, int *r_
   return previews;
 }
 
+static void blendhandle_linkable_group_add(GSet *gathered, LinkNode **names, const int code)
+{
+  if (BKE_idtype_idcode_is_valid(code)) {
+    if (BKE_idtype_idcode_is_linkable(code)) {
+      const char *str = BKE_idtype_idcode_to_name(code);
+
+      if (BLI_gset_add(gathered, (void *)str)) {
+        BLI_linklist_prepend(names, BLI_strdup(str));
+      }
+    }
+  }
+}
+
 LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh)
 {
   FileData *fd = (FileData *)bh;
@@ -322,18 +353,19 @@ LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh)
   LinkNode *names = NULL;
   BHead *bhead;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
-    if (bhead->code == ENDB) {
-      break;
+  if (fd->bhead_index != NULL) {
+    /* Avoid reading all blocks of the file. */
+    const BHeadIndexEntry *entries = BHEAD_INDEX_ENTRIES(fd->bhead_index);
+    for (int i = 0; i < fd->bhead_index->entries_num; i++) {
+      blendhandle_linkable_group_add(gathered, &names, entries[i].code);
     }
-    if (BKE_idtype_idcode_is_valid(bhead->code)) {
-      if (BKE_idtype_idcode_is_linkable(bhead->code)) {
-        const char *str = BKE_idtype_idcode_to_name(bhead->code);
-
-        if (BLI_gset_add(gathered, (void *)str)) {
-          BLI_linklist_prepend(&names, BLI_strdup(str));
-        }
+  }
+  else {
+    for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+      if (bhead->code == ENDB) {
+        break;
       }
+      blendhandle_linkable_group_add(gathered, &names, bhead->code);
     }
   }
 
@@ -968,6 +968,27 @@ static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
   return success;
 }
 
+/**
+ * Get the data of a block that was not read yet directly from the file memory, without copying.
+ * Returns NULL when the #FileReader doesn't support that (e.g. compressed files).
+ * After accessing the data, #blo_bhead_mapped_data_check has to be called.
+ */
+static const void *blo_bhead_mapped_data(FileData *fd, BHead *thisblock)
+{
+  BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+  BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  if (fd->file->map == NULL) {
+    return NULL;
+  }
+  return fd->file->map(fd->file, new_bhead->file_offset, (size_t)new_bhead->bhead.len);
+}
+
+/** Check that no IO error happened while accessing data from #blo_bhead_mapped_data. */
+static bool blo_bhead_mapped_data_check(FileData *fd)
+{
+  return fd->file->map(fd->file, 0, 0) != NULL;
+}
+
 static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
 {
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
@@ -1037,6 +1058,126 @@ static void decode_blender_header(FileData *fd)
   }
 }
 
+/**
+ * Read the #INDX block written at the end of the file (see #BHeadIndexHeader) into
+ * #FileData.bhead_index, it's used to find the IDs and the DNA without reading all blocks.
+ *
+ * Only used when the file can be seeked and has the same pointer size and endianness,
+ * otherwise all blocks are read as usual.
+ */
+static void read_file_index(FileData *fd)
+{
+  if (fd->file->seek == NULL ||
+      (fd->flags & (FD_FLAGS_SWITCH_ENDIAN | FD_FLAGS_POINTSIZE_DIFFERS)) != 0) {
+    return;
+  }
+
+  const off64_t offset_prev = fd->file->offset;
+  const off64_t file_end = fd->file->seek(fd->file, 0, SEEK_END);
+  BHeadIndexHeader *index = NULL;
+  uint64_t block_len;
+  BHead bhead;
+
+  /* The index is followed by the #ENDB block. */
+  const off64_t block_len_offset = file_end - (off64_t)(sizeof(BHead) + sizeof(block_len));
+  if (block_len_offset <= SIZEOFBLENDERHEADER ||
+      fd->file->seek(fd->file, block_len_offset, SEEK_SET) != block_len_offset ||
+      fd->file->read(fd->file, &block_len, sizeof(block_len)) != sizeof(block_len)) {
+    goto finally;
+  }
+  if (block_len < sizeof(BHead) + sizeof(BHeadIndexHeader) + sizeof(block_len) ||
+      block_len > (uint64_t)(block_len_offset + (off64_t)sizeof(block_len)) - SIZEOFBLENDERHEADER) {
+    goto finally;
+  }
+
+  const off64_t block_offset = block_len_offset + (off64_t)sizeof(block_len) - (off64_t)block_len;
+  if (fd->file->seek(fd->file, block_offset, SEEK_SET) != block_offset ||
+      fd->file->read(fd->file, &bhead, sizeof(bhead)) != sizeof(bhead)) {
+    goto finally;
+  }
+  if (bhead.code != INDX || (uint64_t)bhead.len != block_len - sizeof(BHead)) {
+    goto finally;
+  }
+
+  index = MEM_mallocN((size_t)bhead.len, __func__);
+  if (fd->file->read(fd->file, index, (size_t)bhead.len) != bhead.len) {
+    goto finally;
+  }
+  if (index->entries_num < 0 ||
+      (uint64_t)index->entries_num * sizeof(BHeadIndexEntry) !=
+          (uint64_t)bhead.len - sizeof(BHeadIndexHeader) - sizeof(block_len) ||
+      index->dna_offset < SIZEOFBLENDERHEADER || index->dna_offset >= (uint64_t)block_offset) {
+    goto finally;
+  }
+
+  fd->bhead_index = index;
+  index = NULL;
+
+finally:
+  MEM_SAFE_FREE(index);
+  fd->file->seek(fd->file, offset_prev, SEEK_SET);
+}
+
+/**
+ * Decode the #DNA1 block data, see #read_file_dna.
+ */
+static bool read_file_dna_decode(FileData *fd,
+                                 const void *data,
+                                 const int data_len,
+                                 const int subversion,
+                                 const char **r_error_message)
+{
+  const bool do_endian_swap = (fd->flags & FD_FLAGS_SWITCH_ENDIAN) != 0;
+
+  fd->filesdna = DNA_sdna_from_data(data, data_len, do_endian_swap, true, r_error_message);
+  if (fd->filesdna) {
+    blo_do_versions_dna(fd->filesdna, fd->fileversion, subversion);
+    fd->compflags = DNA_struct_get_compareflags(fd->filesdna, fd->memsdna);
+    fd->reconstruct_info = DNA_reconstruct_info_create(fd->filesdna, fd->memsdna, fd->compflags);
+    /* used to retrieve ID names from (bhead+1) */
+    fd->id_name_offset = DNA_elem_offset(fd->filesdna, "ID", "char", "name[]");
+    BLI_assert(fd->id_name_offset != -1);
+    fd->id_asset_data_offset = DNA_elem_offset(
+        fd->filesdna, "ID", "AssetMetaData", "*asset_data");
+
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Read the #DNA1 block at the offset stored in #FileData.bhead_index,
+ * without reading the blocks before it.
+ *
+ * \return False when the block couldn't be read (the DNA is then searched for as usual).
+ */
+static bool read_file_dna_from_index(FileData *fd,
+                                     const int subversion,
+                                     bool *r_success,
+                                     const char **r_error_message)
+{
+  const off64_t offset_prev = fd->file->offset;
+  const off64_t dna_offset = (off64_t)fd->bhead_index->dna_offset;
+  bool found = false;
+  BHead bhead;
+
+  if (fd->file->seek(fd->file, dna_offset, SEEK_SET) == dna_offset &&
+      fd->file->read(fd->file, &bhead, sizeof(bhead)) == sizeof(bhead) && bhead.code == DNA1 &&
+      bhead.len > 0) {
+    void *data = MEM_mallocN((size_t)bhead.len, __func__);
+    if (fd->file->read(fd->file, data, (size_t)bhead.len) == bhead.len) {
+      *r_success = read_file_dna_decode(fd, data, bhead.len, subversion, r_error_message);
+      found = true;
+    }
+    MEM_freeN(data);
+  }
+
+  /* Continue reading blocks after the ones already read. */
+  fd->file->seek(fd->file, offset_prev, SEEK_SET);
+  return found;
+}
+
 /**
  * \return Success if the file is read correctly, else set \a r_error_message.
  */
@@ -1060,27 +1201,16 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
       memcpy(num, fg->subvstr, 4);
       num[4] = 0;
       subversion = atoi(num);
-    }
-    else if (bhead->code == DNA1) {
-      const bool do_endian_swap = (fd->flags & FD_FLAGS_SWITCH_ENDIAN) != 0;
 
-      fd->filesdna = DNA_sdna_from_data(
-          &bhead[1], bhead->len, do_endian_swap, true, r_error_message);
-      if (fd->filesdna) {
-        blo_do_versions_dna(fd->filesdna, fd->fileversion, subversion);
-        fd->compflags = DNA_struct_get_compareflags(fd->filesdna, fd->memsdna);
-        fd->reconstruct_info = DNA_reconstruct_info_create(
-            fd->filesdna, fd->memsdna, fd->compflags);
-        /* used to retrieve ID names from (bhead+1) */
-        fd->id_name_offset = DNA_elem_offset(fd->filesdna, "ID", "char", "name[]");
-        BLI_assert(fd->id_name_offset != -1);
-        fd->id_asset_data_offset = DNA_elem_offset(
-            fd->filesdna, "ID", "AssetMetaData", "*asset_data");
-
-        return true;
+      /* The index is only written by versions that store the subversion in #GLOB. */
+      bool success;
+      if (fd->bhead_index != NULL &&
+          read_file_dna_from_index(fd, subversion, &success, r_error_message)) {
+        return success;
       }
-
-      return false;
+    }
+    else if (bhead->code == DNA1) {
+      return read_file_dna_decode(fd, &bhead[1], bhead->len, subversion, r_error_message);
     }
     else if (bhead->code == ENDB) {
       break;
@@ -1160,6 +1290,7 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 
   if (fd->flags & FD_FLAGS_FILE_OK) {
     const char *error_message = NULL;
+    read_file_index(fd);
     if (read_file_dna(fd, &error_message) == false) {
       BKE_reportf(
           reports, RPT_ERROR, "Failed to read blend file '%s': %s", fd->relabase, error_message);
@@ -1361,6 +1492,9 @@ void blo_filedata_free(FileData *fd)
     if (fd->reconstruct_info) {
       DNA_reconstruct_info_free(fd->reconstruct_info);
     }
+    if (fd->bhead_index) {
+      MEM_freeN(fd->bhead_index);
+    }
 
     if (fd->datamap) {
       oldnewmap_free(fd->datamap);
@@ -1883,23 +2017,51 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
 #ifdef USE_BHEAD_READ_ON_DEMAND
+        const void *mapped_data = NULL;
         if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
+          /* Reconstruct directly from the memory-mapped file when possible,
+           * instead of reading a temporary copy of the whole block first. */
+          mapped_data = blo_bhead_mapped_data(fd, bh);
+          if (mapped_data == NULL) {
+            bh = blo_bhead_read_full(fd, bh);
+            if (UNLIKELY(bh == NULL)) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              return NULL;
+            }
+          }
+        }
+        if (mapped_data) {
+          temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, mapped_data);
+          if (UNLIKELY(!blo_bhead_mapped_data_check(fd))) {
             fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
+            MEM_freeN(temp);
+            temp = NULL;
           }
         }
-#endif
+        else {
+          temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+        }
+#else
         temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+#endif
       }
       else {
         /* SDNA_CMP_EQUAL */
         temp = MEM_mallocN(bh->len, blockname);
 #ifdef USE_BHEAD_READ_ON_DEMAND
+        const void *mapped_data = NULL;
         if (BHEADN_FROM_BHEAD(bh)->has_data) {
           memcpy(temp, (bh + 1), bh->len);
         }
+        else if ((mapped_data = blo_bhead_mapped_data(fd, bh))) {
+          /* Copy from the memory-mapped file, avoids seeking back and forth. */
+          memcpy(temp, mapped_data, bh->len);
+          if (UNLIKELY(!blo_bhead_mapped_data_check(fd))) {
+            fd->flags &= ~FD_FLAGS_FILE_OK;
+            MEM_freeN(temp);
+            temp = NULL;
+          }
+        }
         else {
           /* Instead of allocating the bhead, then copying it,
            * read the data from the file directly into the memory. */
@@ -2907,6 +3069,30 @@ static ID *create_placeholder(Main *mainvar, const short idcode, const char *idn
   return ph_id;
 }
 
+/**
+ * Data-block types which can be linked lazily, these typically hold most of the data of asset
+ * libraries, and can be replaced by empty place-holders without affecting their users.
+ */
+static bool lazy_link_idcode_supported(const short idcode)
+{
+  return ELEM(idcode, ID_ME, ID_IM, ID_NT);
+}
+
+/**
+ * Create a place-holder for a linked data-block that is only read once needed,
+ * see #BKE_blendfile_lazy_link_load_tagged.
+ */
+static ID *create_lazy_link_placeholder(FileData *fd, Main *mainvar, BHead *bhead, const int tag)
+{
+  const char *idname = blo_bhead_id_name(fd, bhead);
+  ID *ph_id = create_placeholder(mainvar, GS(idname), idname + 2, tag | LIB_TAG_LAZY_LINK);
+  /* Unlike missing data, the actual data-block still exists, don't let users treat it as lost. */
+  ph_id->tag &= ~LIB_TAG_MISSING;
+
+  oldnewmap_insert(fd->libmap, bhead->old, ph_id, bhead->code);
+  return ph_id;
+}
+
 static void placeholders_ensure_valid(Main *bmain)
 {
   /* Placeholder ObData IDs won't have any material, we have to update their objects for that,
@@ -3556,6 +3742,34 @@ static void do_versions_userdef(FileData *UNUSED(fd), BlendFileData *bfd)
   blo_do_versions_userdef(user);
 }
 
+/**
+ * Add the time spent in a versioning step to \a reports,
+ * each step is logged with `--log "blo.readfile" --log-level 1`.
+ */
+static void do_versions_step_duration_add(BlendFileReadReport *reports,
+                                          const char *step_name,
+                                          const Main *main,
+                                          const double duration)
+{
+  reports->duration.versioning += duration;
+  CLOG_INFO(&LOG,
+            1,
+            "%s (%s): %.3fms",
+            step_name,
+            main->curlib ? main->curlib->filepath : main->filepath,
+            duration * 1000.0);
+}
+
+/** Call a versioning function, timing it with #do_versions_step_duration_add. */
+#define DO_VERSIONS_STEP(reports, main, func, ...) \
+  { \
+    const double _step_time_start = PIL_check_seconds_timer(); \
+    func(__VA_ARGS__); \
+    do_versions_step_duration_add( \
+        reports, #func, main, PIL_check_seconds_timer() - _step_time_start); \
+  } \
+  ((void)0)
+
 static void do_versions(FileData *fd, Library *lib, Main *main)
 {
   /* WATCH IT!!!: pointers from libdata have not been converted */
@@ -3584,14 +3798,14 @@ static void do_versions(FileData *fd, Library *lib, Main *main)
               main->build_hash);
   }
 
-  blo_do_versions_pre250(fd, lib, main);
-  blo_do_versions_250(fd, lib, main);
-  blo_do_versions_260(fd, lib, main);
-  blo_do_versions_270(fd, lib, main);
-  blo_do_versions_280(fd, lib, main);
-  blo_do_versions_290(fd, lib, main);
-  blo_do_versions_300(fd, lib, main);
-  blo_do_versions_cycles(fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_pre250, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_250, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_260, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_270, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_280, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_290, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_300, fd, lib, main);
+  DO_VERSIONS_STEP(fd->reports, main, blo_do_versions_cycles, fd, lib, main);
 
   /* WATCH IT!!!: pointers from libdata have not been converted yet here! */
   /* WATCH IT 2!: Userdef struct init see do_versions_userdef() above! */
@@ -3601,7 +3815,7 @@ static void do_versions(FileData *fd, Library *lib, Main *main)
   main->is_locked_for_linking = false;
 }
 
-static void do_versions_after_linking(Main *main, ReportList *reports)
+static void do_versions_after_linking(Main *main, BlendFileReadReport *reports)
 {
   CLOG_INFO(&LOG,
             2,
@@ -3614,13 +3828,13 @@ static void do_versions_after_linking(Main *main, ReportList *reports)
   /* Don't allow versioning to create new data-blocks. */
   main->is_locked_for_linking = true;
 
-  do_versions_after_linking_250(main);
-  do_versions_after_linking_260(main);
-  do_versions_after_linking_270(main);
-  do_versions_after_linking_280(main, reports);
-  do_versions_after_linking_290(main, reports);
-  do_versions_after_linking_300(main, reports);
-  do_versions_after_linking_cycles(main);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_250, main);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_260, main);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_270, main);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_280, main, reports->reports);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_290, main, reports->reports);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_300, main, reports->reports);
+  DO_VERSIONS_STEP(reports, main, do_versions_after_linking_cycles, main);
 
   main->is_locked_for_linking = false;
 }
@@ -3957,7 +4171,7 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       blo_split_main(&mainlist, bfd->main);
       LISTBASE_FOREACH (Main *, mainvar, &mainlist) {
         BLI_assert(mainvar->versionfile != 0);
-        do_versions_after_linking(mainvar, fd->reports->reports);
+        do_versions_after_linking(mainvar, fd->reports);
       }
       blo_join_main(&mainlist);
 
@@ -4254,7 +4468,11 @@ static void expand_doit_library(void *fdhandle, Main *mainvar, void *old)
     }
 
     ID *id = is_yet_read(fd, mainvar, bhead);
-    if (id == NULL) {
+    if (id == NULL && (fd->flags & FD_FLAGS_LAZY_LINK) &&
+        lazy_link_idcode_supported(bhead->code)) {
+      create_lazy_link_placeholder(fd, mainvar, bhead, fd->id_tag_extra | LIB_TAG_INDIRECT);
+    }
+    else if (id == NULL) {
       read_libblock(fd,
                     mainvar,
                     bhead,
@@ -4532,8 +4750,14 @@ static void library_link_end(Main *mainl, FileData **fd, const int flag)
   /* expander now is callback function */
   BLO_main_expander(expand_doit_library);
 
+  if (flag & BLO_LIBLINK_USE_LAZY) {
+    mainl->curlib->flag |= LIBRARY_FLAG_LAZY_LINK;
+  }
+
   /* make main consistent */
+  SET_FLAG_FROM_TEST((*fd)->flags, flag & BLO_LIBLINK_USE_LAZY, FD_FLAGS_LAZY_LINK);
   BLO_expand_main(*fd, mainl);
+  (*fd)->flags &= ~FD_FLAGS_LAZY_LINK;
 
   /* do this when expand found other libs */
   read_libraries(*fd, (*fd)->mainlist);
@@ -4573,7 +4797,7 @@ static void library_link_end(Main *mainl, FileData **fd, const int flag)
      * or they will go again through do_versions - bad, very bad! */
     split_main_newid(mainvar, main_newid);
 
-    do_versions_after_linking(main_newid, (*fd)->reports->reports);
+    do_versions_after_linking(main_newid, (*fd)->reports);
 
     add_main_to_main(mainvar, main_newid);
   }
@@ -4893,8 +5117,16 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
         read_library_linked_ids(basefd, fd, mainlist, mainptr);
 
         /* Test if linked data-locks need to read further linked data-locks
-         * and create link placeholders for them. */
+         * and create link placeholders for them. Libraries that were linked lazily only get
+         * lazy place-holders for their own dependencies, like when they were linked. */
+        const bool use_lazy_link = fd && (mainptr->curlib->flag & LIBRARY_FLAG_LAZY_LINK);
+        if (use_lazy_link) {
+          fd->flags |= FD_FLAGS_LAZY_LINK;
+        }
         BLO_expand_main(fd, mainptr);
+        if (use_lazy_link) {
+          fd->flags &= ~FD_FLAGS_LAZY_LINK;
+        }
       }
     }
   }
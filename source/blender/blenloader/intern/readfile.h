@@ -37,6 +37,8 @@ enum eFileDataFlag {
   FD_FLAGS_IS_MEMFILE = 1 << 4,
   /* XXX Unused in practice (checked once but never set). */
   FD_FLAGS_NOT_MY_LIBMAP = 1 << 5,
+  /** Dependencies are linked lazily, see #BLO_LIBLINK_USE_LAZY. */
+  FD_FLAGS_LAZY_LINK = 1 << 6,
 };
 
 /* Disallow since it's 32bit on ms-windows. */
@@ -44,6 +46,37 @@ enum eFileDataFlag {
 #  pragma GCC poison off_t
 #endif
 
+/**
+ * Data of the #INDX block: the header is followed by #BHeadIndexHeader.entries_num entries,
+ * the block ends with the total size of the block (including its #BHead) as a `uint64_t`.
+ *
+ * Offsets are relative to the start of the uncompressed file.
+ */
+typedef struct BHeadIndexHeader {
+  /** Offset of the #BHead of the #DNA1 block. */
+  uint64_t dna_offset;
+  int entries_num;
+  char _pad[4];
+} BHeadIndexHeader;
+
+enum {
+  /** The ID has #ID.asset_data. */
+  BHEAD_INDEX_ENTRY_IS_ASSET = 1 << 0,
+};
+
+typedef struct BHeadIndexEntry {
+  /** Offset of the #BHead of the ID. */
+  uint64_t offset;
+  /** Same as #BHead.code. */
+  int code;
+  int flag;
+  /** #ID.name, including the ID code. */
+  char name[MAX_ID_NAME];
+  char _pad[6];
+} BHeadIndexEntry;
+
+#define BHEAD_INDEX_ENTRIES(index) ((BHeadIndexEntry *)((BHeadIndexHeader *)(index) + 1))
+
 typedef struct FileData {
   /** Linked list of BHeadN's. */
   ListBase bhead_list;
@@ -98,6 +131,9 @@ typedef struct FileData {
   /** See: #USE_GHASH_BHEAD. */
   struct GHash *bhead_idname_hash;
 
+  /** Data of the #INDX block when available, see #BHeadIndexHeader. */
+  BHeadIndexHeader *bhead_index;
+
   ListBase *mainlist;
   /** Used for undo. */
   ListBase *old_mainlist;
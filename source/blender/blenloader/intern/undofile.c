@@ -43,7 +43,7 @@ void BLO_memfile_free(MemFile *memfile)
   MemFileChunk *chunk;
 
   while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_shared == false) {
       MEM_freeN((void *)chunk->buf);
     }
     MEM_freeN(chunk);
@@ -58,22 +58,27 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
   GHash *buffer_to_second_memchunk = BLI_ghash_new(
       BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, __func__);
 
-  /* First, detect all memchunks in second memfile that are not owned by it. */
+  /* First, detect all memchunks in second memfile that are not owned by it.
+   * A buffer can be shared by several of them (see #BLO_memfile_chunk_add_ex),
+   * only one of them takes ownership. */
   for (MemFileChunk *sc = second->chunks.first; sc != NULL; sc = sc->next) {
-    if (sc->is_identical) {
-      BLI_ghash_insert(buffer_to_second_memchunk, (void *)sc->buf, sc);
+    if (sc->is_shared) {
+      void **entry;
+      if (!BLI_ghash_ensure_p(buffer_to_second_memchunk, (void *)sc->buf, &entry)) {
+        *entry = sc;
+      }
     }
   }
 
   /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
    * it is also used by the second memfile, transfer the ownership. */
   for (MemFileChunk *fc = first->chunks.first; fc != NULL; fc = fc->next) {
-    if (!fc->is_identical) {
+    if (!fc->is_shared) {
       MemFileChunk *sc = BLI_ghash_lookup(buffer_to_second_memchunk, fc->buf);
       if (sc != NULL) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
+        BLI_assert(sc->is_shared);
+        sc->is_shared = false;
+        fc->is_shared = true;
       }
       /* Note that if the second memfile does not use that chunk, we assume that the first one
        * fully owns it without sharing it with any other memfile, and hence it should be freed with
@@ -124,6 +129,22 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
         }
       }
     }
+
+    LISTBASE_FOREACH (MemFileChunk *, mem_chunk, &reference_memfile->chunks) {
+      if (mem_chunk->content_hash == 0) {
+        continue;
+      }
+      if (mem_data->content_hash_mapping == NULL) {
+        mem_data->content_hash_mapping = BLI_ghash_new(
+            BLI_ghashutil_inthash_p_simple, BLI_ghashutil_intcmp, __func__);
+      }
+      void **entry;
+      if (!BLI_ghash_ensure_p(mem_data->content_hash_mapping,
+                              POINTER_FROM_UINT(mem_chunk->content_hash),
+                              &entry)) {
+        *entry = mem_chunk;
+      }
+    }
   }
 }
 
@@ -132,9 +153,20 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
   if (mem_data->id_session_uuid_mapping != NULL) {
     BLI_ghash_free(mem_data->id_session_uuid_mapping, NULL, NULL);
   }
+  if (mem_data->content_hash_mapping != NULL) {
+    BLI_ghash_free(mem_data->content_hash_mapping, NULL, NULL);
+  }
 }
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size)
+{
+  BLO_memfile_chunk_add_ex(mem_data, buf, size, 0);
+}
+
+void BLO_memfile_chunk_add_ex(MemFileWriteData *mem_data,
+                              const char *buf,
+                              size_t size,
+                              uint content_hash)
 {
   MemFile *memfile = mem_data->written_memfile;
   MemFileChunk **compchunk_step = &mem_data->reference_current_chunk;
@@ -142,12 +174,14 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   MemFileChunk *curchunk = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
   curchunk->size = size;
   curchunk->buf = NULL;
+  curchunk->is_shared = false;
   curchunk->is_identical = false;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
   curchunk->is_identical_future = true;
   curchunk->id_session_uuid = mem_data->current_id_session_uuid;
+  curchunk->content_hash = content_hash;
   BLI_addtail(&memfile->chunks, curchunk);
 
   /* we compare compchunk with buf */
@@ -156,6 +190,7 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
         curchunk->buf = compchunk->buf;
+        curchunk->is_shared = true;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
       }
@@ -163,6 +198,23 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     *compchunk_step = compchunk->next;
   }
 
+  /* Elements were inserted or removed before this part of an array, search for it by content.
+   * The matched chunk may come from another place or even another ID, so only its memory is
+   * shared. It is not identical in the sense of undo, which would skip reading the ID. */
+  if (curchunk->buf == NULL && content_hash != 0 && mem_data->content_hash_mapping != NULL) {
+    MemFileChunk *compchunk = BLI_ghash_lookup(mem_data->content_hash_mapping,
+                                               POINTER_FROM_UINT(content_hash));
+    if (compchunk != NULL && compchunk->size == curchunk->size &&
+        memcmp(compchunk->buf, buf, size) == 0) {
+      curchunk->buf = compchunk->buf;
+      curchunk->is_shared = true;
+      /* Following chunks of the same ID are expected to match again. */
+      if (compchunk->id_session_uuid == curchunk->id_session_uuid) {
+        *compchunk_step = compchunk->next;
+      }
+    }
+  }
+
   /* not equal... */
   if (curchunk->buf == NULL) {
     char *buf_new = MEM_mallocN(size, "Chunk buffer");
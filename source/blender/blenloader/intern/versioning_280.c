@@ -1763,6 +1763,11 @@ static bool seq_update_flags_cb(Sequence *seq, void *UNUSED(user_data))
   return true;
 }
 
+static void do_versions_mesh_calc_edges_loose(ID *id, void *UNUSED(user_data))
+{
+  BKE_mesh_calc_edges_loose((Mesh *)id);
+}
+
 /* NOLINTNEXTLINE: readability-function-size */
 void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
 {
@@ -2966,9 +2971,7 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
   }
 
   if (!MAIN_VERSION_ATLEAST(bmain, 280, 28)) {
-    for (Mesh *mesh = bmain->meshes.first; mesh; mesh = mesh->id.next) {
-      BKE_mesh_calc_edges_loose(mesh);
-    }
+    version_foreach_id_parallel(&bmain->meshes, do_versions_mesh_calc_edges_loose, NULL);
   }
 
   if (!MAIN_VERSION_ATLEAST(bmain, 280, 29)) {
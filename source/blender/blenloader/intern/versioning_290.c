@@ -808,6 +808,32 @@ static void version_node_join_geometry_for_multi_input_socket(bNodeTree *ntree)
   }
 }
 
+static void do_versions_mesh_remove_degenerate_faces(ID *id, void *UNUSED(user_data))
+{
+  Mesh *me = (Mesh *)id;
+  for (MPoly *mp = me->mpoly, *mp_end = mp + me->totpoly; mp < mp_end; mp++) {
+    if (mp->totloop == 2) {
+      bool changed;
+      BKE_mesh_validate_arrays(me,
+                               me->mvert,
+                               me->totvert,
+                               me->medge,
+                               me->totedge,
+                               me->mface,
+                               me->totface,
+                               me->mloop,
+                               me->totloop,
+                               me->mpoly,
+                               me->totpoly,
+                               me->dvert,
+                               false,
+                               true,
+                               &changed);
+      break;
+    }
+  }
+}
+
 /* NOLINTNEXTLINE: readability-function-size */
 void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
 {
@@ -815,29 +841,7 @@ void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
 
   if (MAIN_VERSION_ATLEAST(bmain, 290, 2) && MAIN_VERSION_OLDER(bmain, 291, 1)) {
     /* In this range, the extrude manifold could generate meshes with degenerated face. */
-    LISTBASE_FOREACH (Mesh *, me, &bmain->meshes) {
-      for (MPoly *mp = me->mpoly, *mp_end = mp + me->totpoly; mp < mp_end; mp++) {
-        if (mp->totloop == 2) {
-          bool changed;
-          BKE_mesh_validate_arrays(me,
-                                   me->mvert,
-                                   me->totvert,
-                                   me->medge,
-                                   me->totedge,
-                                   me->mface,
-                                   me->totface,
-                                   me->mloop,
-                                   me->totloop,
-                                   me->mpoly,
-                                   me->totpoly,
-                                   me->dvert,
-                                   false,
-                                   true,
-                                   &changed);
-          break;
-        }
-      }
-    }
+    version_foreach_id_parallel(&bmain->meshes, do_versions_mesh_remove_degenerate_faces, NULL);
   }
 
   /** Repair files from duplicate brushes added to blend files, see: T76738. */
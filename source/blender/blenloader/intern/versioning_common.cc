@@ -14,6 +14,8 @@
 #include "BLI_listbase.h"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_animsys.h"
 #include "BKE_lib_id.h"
@@ -232,3 +234,18 @@ ARegion *do_versions_add_region(int regiontype, const char *name)
   region->regiontype = regiontype;
   return region;
 }
+
+void version_foreach_id_parallel(ListBase *lb,
+                                 void (*fn)(ID *id, void *user_data),
+                                 void *user_data)
+{
+  blender::Vector<ID *> ids;
+  LISTBASE_FOREACH (ID *, id, lb) {
+    ids.append(id);
+  }
+  blender::threading::parallel_for(ids.index_range(), 1, [&](blender::IndexRange range) {
+    for (const int i : range) {
+      fn(ids[i], user_data);
+    }
+  });
+}
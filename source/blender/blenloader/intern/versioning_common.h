@@ -7,6 +7,7 @@
 #pragma once
 
 struct ARegion;
+struct ID;
 struct ListBase;
 struct Main;
 struct bNodeTree;
@@ -90,6 +91,16 @@ struct bNodeSocket *version_node_add_socket_if_not_exist(struct bNodeTree *ntree
 void version_socket_update_is_used(bNodeTree *ntree);
 ARegion *do_versions_add_region(int regiontype, const char *name);
 
+/**
+ * Call \a fn for every ID in \a lb, in parallel.
+ *
+ * Only for versioning code that changes nothing but the ID it's called for and the data owned
+ * by it, so it can't touch other IDs, #Main or globals (such as #G_MAIN).
+ */
+void version_foreach_id_parallel(struct ListBase *lb,
+                                 void (*fn)(struct ID *id, void *user_data),
+                                 void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
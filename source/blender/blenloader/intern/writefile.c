@@ -85,10 +85,13 @@
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_link_utils.h"
 #include "BLI_linklist.h"
 #include "BLI_math_base.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
@@ -128,14 +131,24 @@
 #define MEM_BUFFER_SIZE (MEM_SIZE_OPTIMAL(1 << 17)) /* 128kb */
 #define MEM_CHUNK_SIZE (MEM_SIZE_OPTIMAL(1 << 15))  /* ~32kb */
 
+/**
+ * Large arrays written to a #MemFile are split where the content matches a pattern instead of at
+ * fixed sizes, so inserting or removing elements only changes the chunks around the edit.
+ * The following chunks are found again in the previous #MemFile by their content hash,
+ * see #BLO_memfile_chunk_add_ex.
+ */
+#define MEM_CHUNK_SPLIT_SIZE_MIN (MEM_CHUNK_SIZE / 4)
+#define MEM_CHUNK_SPLIT_SIZE_MAX (MEM_CHUNK_SIZE * 2)
+/** Number of bytes the rolling hash depends on. */
+#define MEM_CHUNK_SPLIT_WINDOW 32
+/** Split where these bits of the rolling hash are zero (every 16kb on average). */
+#define MEM_CHUNK_SPLIT_MASK 0xfffc0000u
+
 #define ZSTD_BUFFER_SIZE (1 << 21) /* 2mb */
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
 #define ZSTD_COMPRESSION_LEVEL 3
 
-/** Use if we want to store how many bytes have been written to the file. */
-// #define USE_WRITE_DATA_LEN
-
 /* -------------------------------------------------------------------- */
 /** \name Internal Write Wrapper's (Abstracts Compression)
  * \{ */
@@ -405,18 +418,28 @@ typedef struct {
     size_t chunk_size;
   } buffer;
 
-#ifdef USE_WRITE_DATA_LEN
   /** Total number of bytes written. */
   size_t write_len;
-#endif
+
+  /** Written ID blocks, stored in the #INDX block at the end of the file. */
+  struct {
+    bool use;
+    BHeadIndexEntry *entries;
+    int entries_num;
+    int entries_len_alloc;
+  } index;
 
   /** Set on unlikely case of an error (ignores further file writing). */
   bool error;
 
-  /** #MemFile writing (used for undo). */
+  /** #MemFile writing (used for undo and incremental saving). */
   MemFileWriteData mem;
-  /** When true, write to #WriteData.current, could also call 'is_undo'. */
+  /** When true, write to #WriteData.current. */
   bool use_memfile;
+  /** When true, an undo step is written (always uses #WriteData.current). */
+  bool is_undo;
+  /** Split large arrays written to the #MemFile by content, see #MEM_CHUNK_SPLIT_MASK. */
+  bool use_memfile_split;
 
   /**
    * Wrap writing, so we can use zstd or
@@ -484,6 +507,7 @@ static void writedata_free(WriteData *wd)
   if (wd->buffer.buf) {
     MEM_freeN(wd->buffer.buf);
   }
+  MEM_SAFE_FREE(wd->index.entries);
   MEM_freeN(wd);
 }
 
@@ -505,6 +529,46 @@ static void mywrite_flush(WriteData *wd)
   }
 }
 
+BLI_INLINE uint32_t mywrite_memfile_split_gear(const uchar value)
+{
+  return ((uint32_t)value + 1u) * 0x9e3779b1u;
+}
+
+/**
+ * \return The size of the next chunk of \a data when splitting it by content.
+ */
+static size_t mywrite_memfile_split_size(const uchar *data, const size_t len)
+{
+  if (len <= MEM_CHUNK_SPLIT_SIZE_MAX) {
+    return len;
+  }
+
+  uint32_t hash = 0;
+  for (size_t i = MEM_CHUNK_SPLIT_SIZE_MIN - MEM_CHUNK_SPLIT_WINDOW; i < MEM_CHUNK_SPLIT_SIZE_MAX;
+       i++) {
+    hash = (hash << 1) + mywrite_memfile_split_gear(data[i]);
+    if (i >= MEM_CHUNK_SPLIT_SIZE_MIN && (hash & MEM_CHUNK_SPLIT_MASK) == 0) {
+      return i + 1;
+    }
+  }
+  return MEM_CHUNK_SPLIT_SIZE_MAX;
+}
+
+/**
+ * Write a large array to the #MemFile, split in chunks by content.
+ */
+static void mywrite_memfile_split(WriteData *wd, const uchar *data, size_t len)
+{
+  while (len > 0) {
+    const size_t chunk_len = mywrite_memfile_split_size(data, len);
+    /* Zero is used for chunks without a hash. */
+    const uint content_hash = max_uu(BLI_hash_mm2(data, chunk_len, 0), 1);
+    BLO_memfile_chunk_add_ex(&wd->mem, (const char *)data, chunk_len, content_hash);
+    data += chunk_len;
+    len -= chunk_len;
+  }
+}
+
 /**
  * Low level WRITE(2) wrapper that buffers data
  * \param adr: Pointer to new chunk of data
@@ -521,9 +585,7 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
     return;
   }
 
-#ifdef USE_WRITE_DATA_LEN
   wd->write_len += len;
-#endif
 
   if (wd->buffer.buf == NULL) {
     writedata_do_write(wd, adr, len);
@@ -537,6 +599,11 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
         wd->buffer.used_len = 0;
       }
 
+      if (wd->use_memfile_split) {
+        mywrite_memfile_split(wd, adr, len);
+        return;
+      }
+
       do {
         size_t writelen = MIN2(len, wd->buffer.chunk_size);
         writedata_do_write(wd, adr, writelen);
@@ -564,9 +631,10 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
  * \param ww: File write wrapper.
  * \param compare: Previous memory file (can be NULL).
  * \param current: The current memory file (can be NULL).
+ * \param is_undo: Write an undo step, otherwise data is written as for a file on disk.
  * \warning Talks to other functions with global parameters
  */
-static WriteData *mywrite_begin(WriteWrap *ww, MemFile *compare, MemFile *current)
+static WriteData *mywrite_begin(WriteWrap *ww, MemFile *compare, MemFile *current, bool is_undo)
 {
   WriteData *wd = writedata_new(ww);
 
@@ -574,6 +642,7 @@ static WriteData *mywrite_begin(WriteWrap *ww, MemFile *compare, MemFile *curren
     BLO_memfile_write_init(&wd->mem, current, compare);
     wd->use_memfile = true;
   }
+  wd->is_undo = is_undo;
 
   return wd;
 }
@@ -604,7 +673,7 @@ static bool mywrite_end(WriteData *wd)
 /**
  * Start writing of data related to a single ID.
  *
- * Only does something when storing an undo step.
+ * Only does something when writing to a #MemFile.
  */
 static void mywrite_id_begin(WriteData *wd, ID *id)
 {
@@ -632,9 +701,9 @@ static void mywrite_id_begin(WriteData *wd, ID *id)
 }
 
 /**
- * Start writing of data related to a single ID.
+ * End writing of data related to a single ID.
  *
- * Only does something when storing an undo step.
+ * Only does something when writing to a #MemFile.
  */
 static void mywrite_id_end(WriteData *wd, ID *UNUSED(id))
 {
@@ -646,6 +715,34 @@ static void mywrite_id_end(WriteData *wd, ID *UNUSED(id))
   }
 }
 
+/**
+ * Add the ID about to be written to the #INDX block.
+ *
+ * Only does something for the #WriteData of a file (not for undo).
+ */
+static void mywrite_id_index_add(WriteData *wd, const ID *id)
+{
+  if (!wd->index.use) {
+    return;
+  }
+
+  if (wd->index.entries_num == wd->index.entries_len_alloc) {
+    wd->index.entries_len_alloc = max_ii(wd->index.entries_len_alloc * 2, 256);
+    wd->index.entries = MEM_reallocN(wd->index.entries,
+                                     sizeof(*wd->index.entries) *
+                                         (size_t)wd->index.entries_len_alloc);
+  }
+
+  BHeadIndexEntry *entry = &wd->index.entries[wd->index.entries_num++];
+  memset(entry, 0, sizeof(*entry));
+  entry->offset = (uint64_t)wd->write_len;
+  entry->code = GS(id->name);
+  if (id->asset_data != NULL) {
+    entry->flag |= BHEAD_INDEX_ENTRY_IS_ASSET;
+  }
+  STRNCPY(entry->name, id->name);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -715,6 +812,46 @@ static void writedata(WriteData *wd, int filecode, size_t len, const void *adr)
   mywrite(wd, adr, len);
 }
 
+/**
+ * Write the #INDX block from the IDs added with #mywrite_id_index_add,
+ * must be the last block before #ENDB.
+ */
+static void write_index(WriteData *wd, const size_t dna_offset)
+{
+  BLI_STATIC_ASSERT((sizeof(BHeadIndexEntry) % 8) == 0, "Must be 8 byte aligned")
+
+  if (!wd->index.use) {
+    return;
+  }
+
+  const size_t entries_len = sizeof(BHeadIndexEntry) * (size_t)wd->index.entries_num;
+  const uint64_t block_len = sizeof(BHead) + sizeof(BHeadIndexHeader) + entries_len +
+                             sizeof(uint64_t);
+  if (block_len - sizeof(BHead) > INT_MAX) {
+    return;
+  }
+
+  BHead bh = {
+      .code = INDX,
+      .len = (int)(block_len - sizeof(BHead)),
+      .old = NULL,
+      .SDNAnr = 0,
+      .nr = 1,
+  };
+  BHeadIndexHeader header = {
+      .dna_offset = (uint64_t)dna_offset,
+      .entries_num = wd->index.entries_num,
+  };
+
+  mywrite(wd, &bh, sizeof(BHead));
+  mywrite(wd, &header, sizeof(header));
+  if (entries_len != 0) {
+    mywrite(wd, wd->index.entries, entries_len);
+  }
+  /* Allows finding the start of the block from the end of the file. */
+  mywrite(wd, &block_len, sizeof(block_len));
+}
+
 /* use this to force writing of lists in same order as reading (using link_list) */
 static void writelist_nr(WriteData *wd, int filecode, const int struct_nr, const ListBase *lb)
 {
@@ -940,7 +1077,7 @@ static void write_libraries(WriteData *wd, Main *main)
     if (main->curlib && main->curlib->packedfile) {
       found_one = true;
     }
-    else if (wd->use_memfile) {
+    else if (wd->is_undo) {
       /* When writing undo step we always write all existing libraries, makes reading undo step
        * much easier when dealing with purely indirectly used libraries. */
       found_one = true;
@@ -972,7 +1109,7 @@ static void write_libraries(WriteData *wd, Main *main)
 
       if (main->curlib->packedfile) {
         BKE_packedfile_blend_write(&writer, main->curlib->packedfile);
-        if (wd->use_memfile == false) {
+        if (wd->is_undo == false) {
           printf("write packed .blend: %s\n", main->curlib->filepath);
         }
       }
@@ -1006,7 +1143,7 @@ static void write_libraries(WriteData *wd, Main *main)
  * - for undofile, curscene needs to be saved */
 static void write_global(WriteData *wd, int fileflags, Main *mainvar)
 {
-  const bool is_undo = wd->use_memfile;
+  const bool is_undo = wd->is_undo;
   FileGlobal fg;
   bScreen *screen;
   Scene *scene;
@@ -1073,7 +1210,272 @@ static void write_thumb(WriteData *wd, const BlendThumbnail *thumb)
 /** \name File Writing (Private)
  * \{ */
 
-/* if MemFile * there's filesave to memory */
+/** Size of the stack buffers for the copy of an ID struct that is written, see #write_id. */
+#define ID_BUFFER_STATIC_SIZE 8192
+
+/**
+ * Write a single data-block, \a id_buffer is used to store a copy of the ID struct
+ * with runtime data cleared.
+ */
+static void write_id(WriteData *wd, ID *id, void *id_buffer, const size_t idtype_struct_size)
+{
+  BlendWriter writer = {wd};
+
+  mywrite_id_begin(wd, id);
+  mywrite_id_index_add(wd, id);
+
+  memcpy(id_buffer, id, idtype_struct_size);
+
+  /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
+  ((ID *)id_buffer)->tag = 0;
+  ((ID *)id_buffer)->us = 0;
+  ((ID *)id_buffer)->icon_id = 0;
+  /* Those listbase data change every time we add/remove an ID, and also often when
+   * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
+   * detections between undo steps. */
+  ((ID *)id_buffer)->prev = NULL;
+  ((ID *)id_buffer)->next = NULL;
+  /* Those runtime pointers should never be set during writing stage, but just in case clear
+   * them too. */
+  ((ID *)id_buffer)->orig_id = NULL;
+  ((ID *)id_buffer)->newid = NULL;
+  /* Even though in theory we could be able to preserve this python instance across undo even
+   * when we need to re-read the ID into its original address, this is currently cleared in
+   * #direct_link_id_common in `readfile.c` anyway, */
+  ((ID *)id_buffer)->py_instance = NULL;
+
+  const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id);
+  if (id_type->blend_write != NULL) {
+    id_type->blend_write(&writer, (ID *)id_buffer, id);
+  }
+
+  mywrite_id_end(wd, id);
+}
+
+/**
+ * Amount of serialized data that worker threads may keep in memory ahead of the data-block that
+ * is written next. The data-block that is written next is always serialized, even when it is
+ * larger.
+ */
+#define WRITE_IDS_PARALLEL_MAX_PENDING_SIZE (16 * 1024 * 1024)
+
+/**
+ * Data-blocks are serialized by worker threads into their own #MemFile, in the order of the
+ * list. The calling thread writes them to the file in the same order and frees every buffer as
+ * soon as it is written. Data-blocks that no worker started yet when they are next are written
+ * by the calling thread directly.
+ *
+ * The `blend_write` callbacks of all ID types were checked to only modify the ID copy in the
+ * write buffer or data that is owned by the written ID (e.g. `wmWindow.screen` of the window
+ * manager, or the selection flags of pose channels). Shared data they read, like the DNA and the
+ * armature of a pose, is not modified during writing. Since all data-blocks that are written in
+ * parallel have the same type, they never write the same data.
+ */
+typedef struct WriteIDsParallelData {
+  ID **ids;
+  int ids_num;
+  /** Serialized data of each ID that is not written by the calling thread directly. */
+  MemFile *memfiles;
+  size_t idtype_struct_size;
+  /** Library overrides need to store their operations in a shared #Main while being written,
+   * they are written on the calling thread instead. */
+  bool use_override;
+
+  /** Protects all members below. */
+  ThreadMutex mutex;
+  /** Notified when a data-block is serialized or written. */
+  ThreadCondition condition;
+  /** Index of the next data-block that is not serialized or written by any thread yet. */
+  int next_index;
+  /** Index of the next data-block to write to the file. */
+  int write_index;
+  /** Whether the data-block is serialized into its #MemFile. */
+  bool *is_serialized;
+  /** Total size of the serialized data-blocks that are not written yet. */
+  size_t pending_size;
+} WriteIDsParallelData;
+
+static bool write_ids_parallel_needs_override(const WriteIDsParallelData *data, const ID *id)
+{
+  return data->use_override && ID_IS_OVERRIDE_LIBRARY_REAL(id);
+}
+
+static void write_ids_parallel_task(TaskPool *__restrict pool, void *UNUSED(taskdata))
+{
+  WriteIDsParallelData *data = BLI_task_pool_user_data(pool);
+  /* Writes into the #MemFile of the current ID, created on first use. */
+  WriteData *wd = NULL;
+
+  char id_buffer_static[ID_BUFFER_STATIC_SIZE];
+  void *id_buffer = id_buffer_static;
+  if (data->idtype_struct_size > ID_BUFFER_STATIC_SIZE) {
+    BLI_assert(0);
+    id_buffer = MEM_mallocN(data->idtype_struct_size, __func__);
+  }
+
+  BLI_mutex_lock(&data->mutex);
+  while (true) {
+    /* Don't serialize too far ahead of the writer, unless the data-block is needed next. */
+    while (data->next_index < data->ids_num && data->next_index != data->write_index &&
+           data->pending_size >= WRITE_IDS_PARALLEL_MAX_PENDING_SIZE) {
+      BLI_condition_wait(&data->condition, &data->mutex);
+    }
+    if (data->next_index >= data->ids_num) {
+      break;
+    }
+    const int i = data->next_index++;
+    BLI_mutex_unlock(&data->mutex);
+
+    ID *id = data->ids[i];
+    if (!write_ids_parallel_needs_override(data, id)) {
+      if (wd == NULL) {
+        wd = mywrite_begin(NULL, NULL, &data->memfiles[i], false);
+      }
+      else {
+        BLO_memfile_write_init(&wd->mem, &data->memfiles[i], NULL);
+      }
+      write_id(wd, id, id_buffer, data->idtype_struct_size);
+      mywrite_flush(wd);
+    }
+
+    BLI_mutex_lock(&data->mutex);
+    data->is_serialized[i] = true;
+    data->pending_size += data->memfiles[i].size;
+    BLI_condition_notify_all(&data->condition);
+  }
+  BLI_mutex_unlock(&data->mutex);
+
+  if (wd != NULL) {
+    mywrite_end(wd);
+  }
+  if (id_buffer != id_buffer_static) {
+    MEM_freeN(id_buffer);
+  }
+}
+
+/**
+ * Write the data-blocks starting at \a id_first, all of the same type. Data-blocks are serialized
+ * in parallel and written in order, so the file is the same as when writing on a single thread.
+ * When compressing, the written data is compressed while the next data-blocks are serialized.
+ */
+static void write_ids_parallel(WriteData *wd,
+                               Main *bmain,
+                               OverrideLibraryStorage *override_storage,
+                               ID *id_first,
+                               const size_t idtype_struct_size)
+{
+  int ids_max = 0;
+  for (ID *id = id_first; id != NULL; id = id->next) {
+    ids_max++;
+  }
+
+  WriteIDsParallelData data = {
+      .ids = MEM_mallocN(sizeof(*data.ids) * (size_t)ids_max, __func__),
+      .ids_num = 0,
+      .memfiles = MEM_callocN(sizeof(*data.memfiles) * (size_t)ids_max, __func__),
+      .idtype_struct_size = idtype_struct_size,
+      .use_override = !ELEM(override_storage, NULL, bmain),
+      .is_serialized = MEM_callocN(sizeof(*data.is_serialized) * (size_t)ids_max, __func__),
+  };
+  BLI_mutex_init(&data.mutex);
+  BLI_condition_init(&data.condition);
+
+  for (ID *id = id_first; id != NULL; id = id->next) {
+    /* We should never attempt to write non-regular IDs
+     * (i.e. all kind of temp/runtime ones). */
+    BLI_assert(
+        (id->tag & (LIB_TAG_NO_MAIN | LIB_TAG_NO_USER_REFCOUNT | LIB_TAG_NOT_ALLOCATED)) == 0);
+
+    /* Unused IDs are only written in undo case, see #write_file_handle. */
+    if (id->us == 0) {
+      BLI_assert(!ELEM(GS(id->name), ID_SCE, ID_WM, ID_WS));
+      continue;
+    }
+    data.ids[data.ids_num++] = id;
+  }
+
+  /* Without worker threads, tasks would run immediately when they are pushed. Then all
+   * data-blocks are written by the calling thread below. */
+  TaskPool *task_pool = NULL;
+  const int threads_num = BLI_task_scheduler_num_threads();
+  if (threads_num > 1 && data.ids_num > 1) {
+    task_pool = BLI_task_pool_create(&data, TASK_PRIORITY_HIGH);
+    for (int i = 0; i < min_ii(threads_num, data.ids_num); i++) {
+      BLI_task_pool_push(task_pool, write_ids_parallel_task, NULL, false, NULL);
+    }
+  }
+
+  char id_buffer_static[ID_BUFFER_STATIC_SIZE];
+  void *id_buffer = id_buffer_static;
+  if (idtype_struct_size > ID_BUFFER_STATIC_SIZE) {
+    BLI_assert(0);
+    id_buffer = MEM_mallocN(idtype_struct_size, __func__);
+  }
+
+  for (int i = 0; i < data.ids_num; i++) {
+    ID *id = data.ids[i];
+
+    BLI_mutex_lock(&data.mutex);
+    bool write_directly = false;
+    if (data.next_index == i) {
+      /* No worker started this data-block yet, write it without an intermediate buffer. */
+      data.next_index++;
+      write_directly = true;
+    }
+    else {
+      while (!data.is_serialized[i]) {
+        BLI_condition_wait(&data.condition, &data.mutex);
+      }
+    }
+    BLI_mutex_unlock(&data.mutex);
+
+    const size_t written_size = data.memfiles[i].size;
+    if (write_directly || write_ids_parallel_needs_override(&data, id)) {
+      const bool do_override = write_ids_parallel_needs_override(&data, id);
+      if (do_override) {
+        BKE_lib_override_library_operations_store_start(bmain, override_storage, id);
+      }
+      write_id(wd, id, id_buffer, idtype_struct_size);
+      if (do_override) {
+        BKE_lib_override_library_operations_store_end(override_storage, id);
+      }
+    }
+    else {
+      mywrite_id_index_add(wd, id);
+      LISTBASE_FOREACH (MemFileChunk *, chunk, &data.memfiles[i].chunks) {
+        mywrite(wd, chunk->buf, chunk->size);
+      }
+      BLO_memfile_free(&data.memfiles[i]);
+    }
+
+    BLI_mutex_lock(&data.mutex);
+    data.pending_size -= written_size;
+    data.write_index = i + 1;
+    BLI_condition_notify_all(&data.condition);
+    BLI_mutex_unlock(&data.mutex);
+  }
+
+  if (task_pool != NULL) {
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+  if (id_buffer != id_buffer_static) {
+    MEM_freeN(id_buffer);
+  }
+
+  BLI_condition_end(&data.condition);
+  BLI_mutex_end(&data.mutex);
+  MEM_freeN(data.ids);
+  MEM_freeN(data.memfiles);
+  MEM_freeN(data.is_serialized);
+}
+
+/**
+ * \param ww: Wrapper to write the file with, when NULL data is written to \a current.
+ * \param current: When non-NULL, write to this #MemFile (compared against \a compare),
+ * for an undo step when \a ww is NULL too.
+ */
 static bool write_file_handle(Main *mainvar,
                               WriteWrap *ww,
                               MemFile *compare,
@@ -1089,8 +1491,10 @@ static bool write_file_handle(Main *mainvar,
 
   blo_split_main(&mainlist, mainvar);
 
-  wd = mywrite_begin(ww, compare, current);
+  wd = mywrite_begin(current ? NULL : ww, compare, current, ww == NULL);
   BlendWriter writer = {wd};
+  wd->index.use = !wd->is_undo;
+  wd->use_memfile_split = wd->use_memfile;
 
   sprintf(buf,
           "BLENDER%c%c%.3d",
@@ -1108,11 +1512,10 @@ static bool write_file_handle(Main *mainvar,
    * avoid thumbnail detecting changes because of this. */
   mywrite_flush(wd);
 
-  OverrideLibraryStorage *override_storage = wd->use_memfile ?
+  OverrideLibraryStorage *override_storage = wd->is_undo ?
                                                  NULL :
                                                  BKE_lib_override_library_operations_store_init();
 
-#define ID_BUFFER_STATIC_SIZE 8192
   /* This outer loop allows to save first data-blocks from real mainvar,
    * then the temp ones from override process,
    * if needed, without duplicating whole code. */
@@ -1127,9 +1530,17 @@ static bool write_file_handle(Main *mainvar,
         continue; /* Libraries are handled separately below. */
       }
 
+      const size_t idtype_struct_size = BKE_idtype_get_info_from_id(id)->struct_size;
+      if (!wd->use_memfile) {
+        /* Nothing is compared against previously written data, so the data-blocks can be
+         * serialized in parallel. */
+        write_ids_parallel(wd, bmain, override_storage, id, idtype_struct_size);
+        mywrite_flush(wd);
+        continue;
+      }
+
       char id_buffer_static[ID_BUFFER_STATIC_SIZE];
       void *id_buffer = id_buffer_static;
-      const size_t idtype_struct_size = BKE_idtype_get_info_from_id(id)->struct_size;
       if (idtype_struct_size > ID_BUFFER_STATIC_SIZE) {
         BLI_assert(0);
         id_buffer = MEM_mallocN(idtype_struct_size, __func__);
@@ -1144,7 +1555,7 @@ static bool write_file_handle(Main *mainvar,
         /* We only write unused IDs in undo case.
          * NOTE: All Scenes, WindowManagers and WorkSpaces should always be written to disk, so
          * their usercount should never be NULL currently. */
-        if (id->us == 0 && !wd->use_memfile) {
+        if (id->us == 0 && !wd->is_undo) {
           BLI_assert(!ELEM(GS(id->name), ID_SCE, ID_WM, ID_WS));
           continue;
         }
@@ -1156,7 +1567,7 @@ static bool write_file_handle(Main *mainvar,
           BKE_lib_override_library_operations_store_start(bmain, override_storage, id);
         }
 
-        if (wd->use_memfile) {
+        if (wd->is_undo) {
           /* Record the changes that happened up to this undo push in
            * recalc_up_to_undo_push, and clear recalc_after_undo_push again
            * to start accumulating for the next undo push. */
@@ -1178,38 +1589,11 @@ static bool write_file_handle(Main *mainvar,
           }
         }
 
-        mywrite_id_begin(wd, id);
-
-        memcpy(id_buffer, id, idtype_struct_size);
-
-        /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
-        ((ID *)id_buffer)->tag = 0;
-        ((ID *)id_buffer)->us = 0;
-        ((ID *)id_buffer)->icon_id = 0;
-        /* Those listbase data change every time we add/remove an ID, and also often when
-         * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
-         * detections between undo steps. */
-        ((ID *)id_buffer)->prev = NULL;
-        ((ID *)id_buffer)->next = NULL;
-        /* Those runtime pointers should never be set during writing stage, but just in case clear
-         * them too. */
-        ((ID *)id_buffer)->orig_id = NULL;
-        ((ID *)id_buffer)->newid = NULL;
-        /* Even though in theory we could be able to preserve this python instance across undo even
-         * when we need to re-read the ID into its original address, this is currently cleared in
-         * #direct_link_id_common in `readfile.c` anyway, */
-        ((ID *)id_buffer)->py_instance = NULL;
-
-        const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id);
-        if (id_type->blend_write != NULL) {
-          id_type->blend_write(&writer, (ID *)id_buffer, id);
-        }
+        write_id(wd, id, id_buffer, idtype_struct_size);
 
         if (do_override) {
           BKE_lib_override_library_operations_store_end(override_storage, id);
         }
-
-        mywrite_id_end(wd, id);
       }
 
       if (id_buffer != id_buffer_static) {
@@ -1239,8 +1623,11 @@ static bool write_file_handle(Main *mainvar,
    *
    * Note that we *borrow* the pointer to 'DNAstr',
    * so writing each time uses the same address and doesn't cause unnecessary undo overhead. */
+  const size_t dna_offset = wd->write_len;
   writedata(wd, DNA1, (size_t)wd->sdna->data_len, wd->sdna->data);
 
+  write_index(wd, dna_offset);
+
   /* end of file */
   memset(&bhead, 0, sizeof(BHead));
   bhead.code = ENDB;
@@ -1295,6 +1682,254 @@ static bool do_history(const char *name, ReportList *reports)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Incremental File Writing
+ *
+ * The data written by the previous save is kept in a #MemFile, split per ID like undo steps.
+ * Writing the next save into a #MemFile compared against it shares the buffers of data-blocks
+ * that did not change, and compressed frames only made of such buffers are written as-is,
+ * so only the changed data-blocks get copied and compressed again.
+ * \{ */
+
+typedef struct WriteCacheFrame {
+  struct WriteCacheFrame *next, *prev;
+
+  /** Buffers of the #MemFileChunk's in this frame, owned by #BlendFileWriteCache.memfile. */
+  const char **chunk_bufs;
+  int chunks_num;
+
+  void *compressed_data;
+  uint32_t compressed_size;
+  uint32_t uncompressed_size;
+
+  /** Only used while writing: first chunk of a frame that needs to be compressed. */
+  const MemFileChunk *first_chunk;
+} WriteCacheFrame;
+
+struct BlendFileWriteCache {
+  /** Uncompressed data of the previous save. */
+  MemFile memfile;
+  /** #WriteCacheFrame's of the previous save, empty when it was not compressed. */
+  ListBase frames;
+};
+
+BlendFileWriteCache *BLO_write_cache_new(void)
+{
+  return MEM_callocN(sizeof(BlendFileWriteCache), __func__);
+}
+
+static void write_cache_frames_free(ListBase *frames)
+{
+  LISTBASE_FOREACH_MUTABLE (WriteCacheFrame *, frame, frames) {
+    MEM_SAFE_FREE(frame->compressed_data);
+    MEM_freeN(frame->chunk_bufs);
+    MEM_freeN(frame);
+  }
+  BLI_listbase_clear(frames);
+}
+
+void BLO_write_cache_free(BlendFileWriteCache *cache)
+{
+  write_cache_frames_free(&cache->frames);
+  BLO_memfile_free(&cache->memfile);
+  MEM_freeN(cache);
+}
+
+/** Check whether the chunks starting at \a chunk are the unchanged content of \a frame. */
+static bool write_cache_frame_matches(const WriteCacheFrame *frame, const MemFileChunk *chunk)
+{
+  for (int i = 0; i < frame->chunks_num; i++, chunk = chunk->next) {
+    if (chunk == NULL || !chunk->is_shared || chunk->buf != frame->chunk_bufs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void write_cache_frame_compress_fn(void *__restrict userdata,
+                                          const int i,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WriteCacheFrame *frame = ((WriteCacheFrame **)userdata)[i];
+
+  char *data = MEM_mallocN(frame->uncompressed_size, __func__);
+  const MemFileChunk *chunk = frame->first_chunk;
+  size_t data_len = 0;
+  for (int j = 0; j < frame->chunks_num; j++, chunk = chunk->next) {
+    memcpy(data + data_len, chunk->buf, chunk->size);
+    data_len += chunk->size;
+  }
+
+  size_t out_buf_len = ZSTD_compressBound(data_len);
+  void *out_buf = MEM_mallocN(out_buf_len, "Zstd out buffer");
+  size_t out_size = ZSTD_compress(out_buf, out_buf_len, data, data_len, ZSTD_COMPRESSION_LEVEL);
+  MEM_freeN(data);
+
+  if (ZSTD_isError(out_size)) {
+    MEM_freeN(out_buf);
+    return;
+  }
+  /* Frames are kept around for the next save, don't waste memory. */
+  frame->compressed_data = MEM_reallocN(out_buf, out_size);
+  frame->compressed_size = (uint32_t)out_size;
+}
+
+/**
+ * Split the chunks of \a memfile into frames of at most #ZSTD_CHUNK_SIZE bytes,
+ * reusing the frames of \a cache which only contain unchanged chunks.
+ * Reused frames are moved from \a cache to \a r_frames.
+ */
+static void write_cache_frames_build(BlendFileWriteCache *cache,
+                                     const MemFile *memfile,
+                                     ListBase *r_frames)
+{
+  GHash *frame_by_first_buf = BLI_ghash_ptr_new_ex(__func__,
+                                                   BLI_listbase_count(&cache->frames));
+  LISTBASE_FOREACH (WriteCacheFrame *, frame, &cache->frames) {
+    /* Chunks can share buffers (see #BLO_memfile_chunk_add_ex), so several frames may start with
+     * the same one. Only the first of them can be reused, the others are compressed again. */
+    void **entry;
+    if (!BLI_ghash_ensure_p(frame_by_first_buf, (void *)frame->chunk_bufs[0], &entry)) {
+      *entry = frame;
+    }
+  }
+
+  const MemFileChunk *chunk = memfile->chunks.first;
+  while (chunk != NULL) {
+    WriteCacheFrame *frame = chunk->is_shared ?
+                                 BLI_ghash_lookup(frame_by_first_buf, chunk->buf) :
+                                 NULL;
+    if (frame != NULL && write_cache_frame_matches(frame, chunk)) {
+      BLI_ghash_remove(frame_by_first_buf, chunk->buf, NULL, NULL);
+      BLI_remlink(&cache->frames, frame);
+      BLI_addtail(r_frames, frame);
+      for (int i = 0; i < frame->chunks_num; i++) {
+        chunk = chunk->next;
+      }
+      continue;
+    }
+
+    /* Gather chunks for a new frame, stopping early where a reusable frame starts,
+     * so that frames following a change are aligned with the previous save again. */
+    frame = MEM_callocN(sizeof(*frame), __func__);
+    frame->first_chunk = chunk;
+    size_t frame_size = 0;
+    do {
+      frame_size += chunk->size;
+      frame->chunks_num++;
+      chunk = chunk->next;
+    } while (chunk != NULL && frame_size + chunk->size <= ZSTD_CHUNK_SIZE &&
+             !(chunk->is_shared && BLI_ghash_haskey(frame_by_first_buf, chunk->buf)));
+    frame->uncompressed_size = (uint32_t)frame_size;
+
+    frame->chunk_bufs = MEM_mallocN(sizeof(*frame->chunk_bufs) * (size_t)frame->chunks_num,
+                                    __func__);
+    const MemFileChunk *frame_chunk = frame->first_chunk;
+    for (int i = 0; i < frame->chunks_num; i++, frame_chunk = frame_chunk->next) {
+      frame->chunk_bufs[i] = frame_chunk->buf;
+    }
+    BLI_addtail(r_frames, frame);
+  }
+
+  BLI_ghash_free(frame_by_first_buf, NULL, NULL);
+}
+
+/**
+ * Write the content of \a memfile with \a ww, which was opened with #ww_open_zstd.
+ */
+static bool write_cache_write_zstd(WriteWrap *ww,
+                                   BlendFileWriteCache *cache,
+                                   const MemFile *memfile,
+                                   ListBase *r_frames)
+{
+  write_cache_frames_build(cache, memfile, r_frames);
+
+  /* Compress the new frames in parallel. */
+  int frames_new_num = 0;
+  LISTBASE_FOREACH (WriteCacheFrame *, frame, r_frames) {
+    frames_new_num += (frame->first_chunk != NULL);
+  }
+  WriteCacheFrame **frames_new = MEM_mallocN(sizeof(*frames_new) * (size_t)frames_new_num,
+                                             __func__);
+  frames_new_num = 0;
+  LISTBASE_FOREACH (WriteCacheFrame *, frame, r_frames) {
+    if (frame->first_chunk != NULL) {
+      frames_new[frames_new_num++] = frame;
+    }
+  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, frames_new_num, frames_new, write_cache_frame_compress_fn, &settings);
+  MEM_freeN(frames_new);
+
+  LISTBASE_FOREACH (WriteCacheFrame *, frame, r_frames) {
+    /* Chunks of the #MemFile are only valid while writing. */
+    frame->first_chunk = NULL;
+
+    if (frame->compressed_data == NULL ||
+        ww_write_none(ww, frame->compressed_data, frame->compressed_size) !=
+            frame->compressed_size) {
+      return false;
+    }
+    ZstdFrame *frameinfo = MEM_mallocN(sizeof(ZstdFrame), "zstd frameinfo");
+    frameinfo->uncompressed_size = frame->uncompressed_size;
+    frameinfo->compressed_size = frame->compressed_size;
+    BLI_addtail(&ww->zstd.frames, frameinfo);
+  }
+  return true;
+}
+
+/**
+ * Same as #write_file_handle, using and updating \a cache to skip unchanged data.
+ */
+static bool write_file_handle_incremental(Main *mainvar,
+                                          WriteWrap *ww,
+                                          BlendFileWriteCache *cache,
+                                          int write_flags,
+                                          bool use_userdef,
+                                          const BlendThumbnail *thumb)
+{
+  MemFile memfile = {{NULL}};
+  bool err = write_file_handle(
+      mainvar, ww, &cache->memfile, &memfile, write_flags, use_userdef, thumb);
+
+  ListBase frames = {NULL};
+  if (!err) {
+    if (write_flags & G_FILE_COMPRESS) {
+      err = !write_cache_write_zstd(ww, cache, &memfile, &frames);
+    }
+    else {
+      LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile.chunks) {
+        if (ww->write(ww, chunk->buf, chunk->size) != chunk->size) {
+          err = true;
+          break;
+        }
+      }
+    }
+  }
+
+  if (err) {
+    /* Reused frames were already moved out of the cache, simply start over on next save. */
+    write_cache_frames_free(&frames);
+    BLO_memfile_free(&memfile);
+    write_cache_frames_free(&cache->frames);
+    BLO_memfile_free(&cache->memfile);
+    return err;
+  }
+
+  /* Keep the new data for the next save, #BLO_memfile_merge transfers the ownership of shared
+   * buffers to the new #MemFile. */
+  write_cache_frames_free(&cache->frames);
+  cache->frames = frames;
+  BLO_memfile_merge(&cache->memfile, &memfile);
+  cache->memfile = memfile;
+
+  return err;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name File Writing (Public)
  * \{ */
@@ -1316,6 +1951,7 @@ bool BLO_write_file(Main *mainvar,
   const bool use_save_as_copy = params->use_save_as_copy;
   const bool use_userdef = params->use_userdef;
   const BlendThumbnail *thumb = params->thumb;
+  BlendFileWriteCache *cache = params->cache;
   const bool relbase_valid = (mainvar->filepath[0] != '\0');
 
   /* path backup/restore */
@@ -1416,7 +2052,10 @@ bool BLO_write_file(Main *mainvar,
   }
 
   /* actual file writing */
-  const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
+  const bool err = cache ? write_file_handle_incremental(
+                               mainvar, &ww, cache, write_flags, use_userdef, thumb) :
+                           write_file_handle(
+                               mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
 
   ww.close(&ww);
 
@@ -1586,7 +2225,7 @@ void BLO_write_string(BlendWriter *writer, const char *data_ptr)
 
 bool BLO_write_is_undo(BlendWriter *writer)
 {
-  return writer->wd->use_memfile;
+  return writer->wd->is_undo;
 }
 
 /** \} */
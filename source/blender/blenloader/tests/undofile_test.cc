@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLI_listbase.h"
+#include "BLI_rand.h"
+
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+/* Reuses the kernel setup of the blendfile loading tests, no file is loaded. */
+class UndofileTest : public BlendfileLoadingBaseTest {
+};
+
+static Mesh *add_mesh_with_random_positions(Main *bmain, const char *name, const int seed)
+{
+  /* Large enough to be written as several chunks split by content. */
+  const int verts_num = 100000;
+  Mesh *mesh = BKE_mesh_add(bmain, name);
+  mesh->totvert = verts_num;
+  MVert *mvert = static_cast<MVert *>(
+      CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, verts_num));
+  RNG *rng = BLI_rng_new(seed);
+  for (int i = 0; i < verts_num; i++) {
+    BLI_rng_get_float_unit_v3(rng, mvert[i].co);
+  }
+  BLI_rng_free(rng);
+  BKE_mesh_update_customdata_pointers(mesh, false);
+  return mesh;
+}
+
+/** Whether all chunks written for the ID are flagged as unchanged, so that undo skips reading it. */
+static bool memfile_id_is_identical(const MemFile &memfile, const ID &id, const bool future)
+{
+  bool found = false;
+  LISTBASE_FOREACH (const MemFileChunk *, chunk, &memfile.chunks) {
+    if (chunk->id_session_uuid != id.session_uuid) {
+      continue;
+    }
+    found = true;
+    if (!(future ? chunk->is_identical_future : chunk->is_identical)) {
+      return false;
+    }
+  }
+  EXPECT_TRUE(found);
+  return true;
+}
+
+TEST_F(UndofileTest, SwappedArraysAreNotIdentical)
+{
+  Main *bmain = BKE_main_new();
+  Mesh *mesh_a = add_mesh_with_random_positions(bmain, "A", 1);
+  Mesh *mesh_b = add_mesh_with_random_positions(bmain, "B", 2);
+  const size_t array_size = sizeof(MVert) * size_t(mesh_a->totvert);
+
+  MemFile memfile_1 = {{nullptr}};
+  ASSERT_TRUE(BLO_write_file_mem(bmain, nullptr, &memfile_1, 0));
+
+  /* Nothing changed, both meshes can be reused. */
+  MemFile memfile_2 = {{nullptr}};
+  BLO_memfile_clear_future(&memfile_1);
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &memfile_1, &memfile_2, 0));
+  EXPECT_TRUE(memfile_id_is_identical(memfile_2, mesh_a->id, false));
+  EXPECT_TRUE(memfile_id_is_identical(memfile_2, mesh_b->id, false));
+
+  /* Swap the content of the arrays, keeping their addresses. */
+  MVert *tmp = static_cast<MVert *>(MEM_mallocN(array_size, __func__));
+  memcpy(tmp, mesh_a->mvert, array_size);
+  memcpy(mesh_a->mvert, mesh_b->mvert, array_size);
+  memcpy(mesh_b->mvert, tmp, array_size);
+  MEM_freeN(tmp);
+
+  MemFile memfile_3 = {{nullptr}};
+  BLO_memfile_clear_future(&memfile_2);
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &memfile_2, &memfile_3, 0));
+
+  /* The swapped chunks are found by content, but both meshes changed in both undo directions. */
+  EXPECT_FALSE(memfile_id_is_identical(memfile_3, mesh_a->id, false));
+  EXPECT_FALSE(memfile_id_is_identical(memfile_3, mesh_b->id, false));
+  EXPECT_FALSE(memfile_id_is_identical(memfile_2, mesh_a->id, true));
+  EXPECT_FALSE(memfile_id_is_identical(memfile_2, mesh_b->id, true));
+  /* Their memory is still shared with the previous step. */
+  EXPECT_LT(memfile_3.size, array_size);
+
+  /* Ownership of shared buffers is transferred when removing steps. */
+  BLO_memfile_merge(&memfile_1, &memfile_2);
+  BLO_memfile_merge(&memfile_2, &memfile_3);
+  BLO_memfile_free(&memfile_3);
+
+  BKE_main_free(bmain);
+}
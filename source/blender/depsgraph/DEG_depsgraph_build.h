@@ -67,6 +67,15 @@ void DEG_graph_relations_update(struct Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(struct Main *bmain);
 
+/**
+ * Tag relations of the modifier and constraint stacks of the object for update, after modifiers,
+ * grease pencil modifiers, shader effects or object constraints were added or removed.
+ *
+ * Unlike #DEG_relations_tag_update, only the relations of the stacks are rebuilt when possible,
+ * the graphs are fully rebuilt otherwise.
+ */
+void DEG_relations_tag_update_object_stacks(struct Main *bmain, struct Object *object);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
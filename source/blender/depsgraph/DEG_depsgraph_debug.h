@@ -52,6 +52,18 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Tracing */
+
+/**
+ * Start recording the evaluation of every operation of all dependency graphs, with the thread
+ * it ran on. The trace is written to the given file by #DEG_debug_trace_end, in the Chrome trace
+ * event format which can be viewed in `chrome://tracing` or Perfetto.
+ */
+void DEG_debug_trace_begin(const char *filepath);
+/** Write the recorded trace to its file and stop recording. Does nothing when not recording. */
+void DEG_debug_trace_end(void);
+
 /* ************************************************ */
 
 /** Compare two dependency graphs. */
@@ -63,6 +63,15 @@ bool DEG_id_type_any_updated(const struct Depsgraph *depsgraph);
 /** Check if given ID type is present in the depsgraph */
 bool DEG_id_type_any_exists(const struct Depsgraph *depsgraph, short id_type);
 
+/**
+ * Tag place-holders of lazily linked IDs used by the depsgraph (see #LIB_TAG_LAZY_LINK) with
+ * #LIB_TAG_DOIT, so their data can be read before evaluation.
+ * Only valid once relations are up to date.
+ *
+ * \return The number of tagged IDs.
+ */
+int DEG_graph_lazy_link_ids_tag(const struct Depsgraph *depsgraph);
+
 /** Get additional evaluation flags for the given ID. */
 uint32_t DEG_get_eval_flags_for_id(const struct Depsgraph *graph, const struct ID *id);
 
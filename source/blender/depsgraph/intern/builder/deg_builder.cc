@@ -13,12 +13,15 @@
 #include "DNA_anim_types.h"
 #include "DNA_armature_types.h"
 #include "DNA_layer_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_listbase.h"
 #include "BLI_stack.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_action.h"
+#include "BKE_modifier.h"
 
 #include "RNA_prototypes.h"
 
@@ -54,6 +57,27 @@ bool deg_check_base_in_depsgraph(const Depsgraph *graph, Base *base)
   return id_node->has_base;
 }
 
+bool deg_object_has_physics_modifiers(const Object *object)
+{
+  LISTBASE_FOREACH (const ModifierData *, md, &object->modifiers) {
+    if (ELEM(md->type,
+             eModifierType_Cloth,
+             eModifierType_Collision,
+             eModifierType_DynamicPaint,
+             eModifierType_Fluid,
+             eModifierType_ParticleSystem,
+             eModifierType_Softbody,
+             eModifierType_Surface)) {
+      return true;
+    }
+    const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+    if (mti != nullptr && (mti->flags & eModifierTypeFlag_UsesPointCache)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /*******************************************************************************
  * Base class for builders.
  */
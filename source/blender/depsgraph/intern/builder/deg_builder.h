@@ -41,6 +41,9 @@ class DepsgraphBuilder {
 
 bool deg_check_id_in_depsgraph(const Depsgraph *graph, ID *id_orig);
 bool deg_check_base_in_depsgraph(const Depsgraph *graph, Base *base);
+/* Check whether the object has modifiers which add relations outside of its own stacks, like
+ * point caches, particle systems and collision or effector lists of other objects. */
+bool deg_object_has_physics_modifiers(const Object *object);
 void deg_graph_build_finalize(Main *bmain, Depsgraph *graph);
 
 }  // namespace deg
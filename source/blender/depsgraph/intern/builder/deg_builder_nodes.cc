@@ -331,6 +331,7 @@ void DepsgraphNodeBuilder::begin_build()
 {
   /* Store existing copy-on-write versions of datablock, so we can re-use
    * them for new ID nodes. */
+  id_info_hash_.reserve(graph_->id_nodes.size());
   for (IDNode *id_node : graph_->id_nodes) {
     /* It is possible that the ID does not need to have CoW version in which case id_cow is the
      * same as id_orig. Additionally, such ID might have been removed, which makes the check
@@ -1008,6 +1009,18 @@ void DepsgraphNodeBuilder::build_object_constraints(Object *object)
                      });
 }
 
+void DepsgraphNodeBuilder::build_object_stacks_update(Scene *scene, Object *object)
+{
+  scene_ = scene;
+  /* Operations of the modifier stacks do not depend on the modifiers. The constraint stack
+   * operation is kept when the last constraint is removed, evaluating an empty stack is cheap. */
+  if (object->constraints.first != nullptr &&
+      find_operation_node(
+          &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_CONSTRAINTS) == nullptr) {
+    build_object_constraints(object);
+  }
+}
+
 void DepsgraphNodeBuilder::build_object_pointcache(Object *object)
 {
   if (!BKE_ptcache_object_has(scene_, object, 0)) {
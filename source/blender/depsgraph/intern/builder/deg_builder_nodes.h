@@ -184,6 +184,11 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_object_data_speaker(Object *object);
   virtual void build_object_transform(Object *object);
   virtual void build_object_constraints(Object *object);
+  /**
+   * Add operations needed by the modifier and constraint stacks of an object which is already in
+   * the finalized graph, keeping the rest of the graph as it is.
+   */
+  virtual void build_object_stacks_update(Scene *scene, Object *object);
   virtual void build_object_pointcache(Object *object);
   virtual void build_pose_constraints(Object *object, bPoseChannel *pchan, int pchan_index);
   virtual void build_rigidbody(Scene *scene);
@@ -233,7 +233,10 @@ bool object_have_geometry_component(const Object *object)
 DepsgraphRelationBuilder::DepsgraphRelationBuilder(Main *bmain,
                                                    Depsgraph *graph,
                                                    DepsgraphBuilderCache *cache)
-    : DepsgraphBuilder(bmain, graph, cache), scene_(nullptr), rna_node_query_(graph, this)
+    : DepsgraphBuilder(bmain, graph, cache),
+      scene_(nullptr),
+      stack_owner_(nullptr),
+      rna_node_query_(graph, this)
 {
 }
 
@@ -339,7 +342,7 @@ Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       int flags)
 {
   if (timesrc && node_to) {
-    return graph_->add_new_relation(timesrc, node_to, description, flags);
+    return add_new_relation(timesrc, node_to, description, flags);
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -367,7 +370,7 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
                                                            int flags)
 {
   if (node_from && node_to) {
-    return graph_->add_new_relation(node_from, node_to, description, flags);
+    return add_new_relation(node_from, node_to, description, flags);
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -382,6 +385,24 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
   return nullptr;
 }
 
+Relation *DepsgraphRelationBuilder::add_new_relation(Node *node_from,
+                                                     Node *node_to,
+                                                     const char *description,
+                                                     int flags)
+{
+  const int64_t num_outlinks = node_from->outlinks.size();
+  Relation *rel = graph_->add_new_relation(node_from, node_to, description, flags);
+  if (node_from->outlinks.size() != num_outlinks) {
+    rel->stack_owner = stack_owner_;
+  }
+  else if (rel->stack_owner != stack_owner_) {
+    /* Existing relation is requested again from elsewhere, it is to be kept when only the stack
+     * which added it is updated. */
+    rel->stack_owner = nullptr;
+  }
+  return rel;
+}
+
 void DepsgraphRelationBuilder::add_particle_collision_relations(const OperationKey &key,
                                                                 Object *object,
                                                                 Collection *collection,
@@ -685,9 +706,6 @@ void DepsgraphRelationBuilder::build_object(Object *object)
     return;
   }
   /* Object Transforms */
-  OperationCode base_op = (object->parent) ? OperationCode::TRANSFORM_PARENT :
-                                             OperationCode::TRANSFORM_LOCAL;
-  OperationKey base_op_key(&object->id, NodeType::TRANSFORM, base_op);
   OperationKey init_transform_key(&object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_INIT);
   OperationKey local_transform_key(
       &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_LOCAL);
@@ -696,7 +714,6 @@ void DepsgraphRelationBuilder::build_object(Object *object)
   OperationKey transform_eval_key(&object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_EVAL);
   OperationKey final_transform_key(
       &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_FINAL);
-  OperationKey ob_eval_key(&object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_EVAL);
   add_relation(init_transform_key, local_transform_key, "Transform Init");
   /* Various flags, flushing from bases/collections. */
   build_object_layer_component_relations(object);
@@ -734,31 +751,7 @@ void DepsgraphRelationBuilder::build_object(Object *object)
     BKE_constraints_id_loop(&object->constraints, constraint_walk, &data);
   }
   /* Object constraints. */
-  OperationKey object_transform_simulation_init_key(
-      &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_SIMULATION_INIT);
-  if (object->constraints.first != nullptr) {
-    OperationKey constraint_key(
-        &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_CONSTRAINTS);
-    /* Constraint relations. */
-    build_constraints(&object->id, NodeType::TRANSFORM, "", &object->constraints, nullptr);
-    /* operation order */
-    add_relation(base_op_key, constraint_key, "ObBase-> Constraint Stack");
-    add_relation(constraint_key, final_transform_key, "ObConstraints -> Done");
-    add_relation(constraint_key, ob_eval_key, "Constraint -> Transform Eval");
-    add_relation(
-        ob_eval_key, object_transform_simulation_init_key, "Transform Eval -> Simulation Init");
-    add_relation(object_transform_simulation_init_key,
-                 final_transform_key,
-                 "Simulation -> Final Transform");
-  }
-  else {
-    add_relation(base_op_key, ob_eval_key, "Eval");
-    add_relation(
-        ob_eval_key, object_transform_simulation_init_key, "Transform Eval -> Simulation Init");
-    add_relation(object_transform_simulation_init_key,
-                 final_transform_key,
-                 "Simulation -> Final Transform");
-  }
+  build_object_constraints(object);
   build_idproperties(object->id.properties);
   /* Animation data */
   build_animdata(&object->id);
@@ -1114,6 +1107,46 @@ void DepsgraphRelationBuilder::build_object_pointcache(Object *object)
   BLI_freelistN(&ptcache_id_list);
 }
 
+void DepsgraphRelationBuilder::build_object_constraints(Object *object)
+{
+  BLI_assert(stack_owner_ == nullptr);
+  stack_owner_ = graph_->find_id_node(&object->id);
+  OperationCode base_op = (object->parent) ? OperationCode::TRANSFORM_PARENT :
+                                             OperationCode::TRANSFORM_LOCAL;
+  OperationKey base_op_key(&object->id, NodeType::TRANSFORM, base_op);
+  OperationKey ob_eval_key(&object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_EVAL);
+  OperationKey final_transform_key(
+      &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_FINAL);
+  OperationKey object_transform_simulation_init_key(
+      &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_SIMULATION_INIT);
+  OperationKey constraint_key(
+      &object->id, NodeType::TRANSFORM, OperationCode::TRANSFORM_CONSTRAINTS);
+  /* NOTE: The constraint stack operation is kept when all constraints are removed from an
+   * object without rebuilding the graph. */
+  if (object->constraints.first != nullptr || has_node(constraint_key)) {
+    /* Constraint relations. */
+    build_constraints(&object->id, NodeType::TRANSFORM, "", &object->constraints, nullptr);
+    /* operation order */
+    add_relation(base_op_key, constraint_key, "ObBase-> Constraint Stack");
+    add_relation(constraint_key, final_transform_key, "ObConstraints -> Done");
+    add_relation(constraint_key, ob_eval_key, "Constraint -> Transform Eval");
+    add_relation(
+        ob_eval_key, object_transform_simulation_init_key, "Transform Eval -> Simulation Init");
+    add_relation(object_transform_simulation_init_key,
+                 final_transform_key,
+                 "Simulation -> Final Transform");
+  }
+  else {
+    add_relation(base_op_key, ob_eval_key, "Eval");
+    add_relation(
+        ob_eval_key, object_transform_simulation_init_key, "Transform Eval -> Simulation Init");
+    add_relation(object_transform_simulation_init_key,
+                 final_transform_key,
+                 "Simulation -> Final Transform");
+  }
+  stack_owner_ = nullptr;
+}
+
 void DepsgraphRelationBuilder::build_constraints(ID *id,
                                                  NodeType component_type,
                                                  const char *component_subdata,
@@ -2103,60 +2136,7 @@ void DepsgraphRelationBuilder::build_object_data_geometry(Object *object)
   Relation *rel = add_relation(scene_key, obdata_ubereval_key, "CoW Relation");
   rel->flag |= RELATION_FLAG_NO_FLUSH;
   /* Modifiers */
-  if (object->modifiers.first != nullptr) {
-    ModifierUpdateDepsgraphContext ctx = {};
-    ctx.scene = scene_;
-    ctx.object = object;
-    LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
-      const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
-      if (mti->updateDepsgraph) {
-        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
-        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
-        mti->updateDepsgraph(md, &ctx);
-      }
-      if (BKE_object_modifier_use_time(scene_, object, md)) {
-        TimeSourceKey time_src_key;
-        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
-      }
-    }
-  }
-  /* Grease Pencil Modifiers. */
-  if (object->greasepencil_modifiers.first != nullptr) {
-    ModifierUpdateDepsgraphContext ctx = {};
-    ctx.scene = scene_;
-    ctx.object = object;
-    LISTBASE_FOREACH (GpencilModifierData *, md, &object->greasepencil_modifiers) {
-      const GpencilModifierTypeInfo *mti = BKE_gpencil_modifier_get_info(
-          (GpencilModifierType)md->type);
-      if (mti->updateDepsgraph) {
-        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
-        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
-        mti->updateDepsgraph(md, &ctx, graph_->mode);
-      }
-      if (BKE_object_modifier_gpencil_use_time(object, md)) {
-        TimeSourceKey time_src_key;
-        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
-      }
-    }
-  }
-  /* Shader FX. */
-  if (object->shader_fx.first != nullptr) {
-    ModifierUpdateDepsgraphContext ctx = {};
-    ctx.scene = scene_;
-    ctx.object = object;
-    LISTBASE_FOREACH (ShaderFxData *, fx, &object->shader_fx) {
-      const ShaderFxTypeInfo *fxi = BKE_shaderfx_get_info((ShaderFxType)fx->type);
-      if (fxi->updateDepsgraph) {
-        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
-        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
-        fxi->updateDepsgraph(fx, &ctx);
-      }
-      if (BKE_object_shaderfx_use_time(object, fx)) {
-        TimeSourceKey time_src_key;
-        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
-      }
-    }
-  }
+  build_object_modifiers(object);
   /* Materials. */
   build_materials(object->mat, object->totcol);
   /* Geometry collision. */
@@ -2225,6 +2205,112 @@ void DepsgraphRelationBuilder::build_object_data_geometry(Object *object)
       geom_key, object_select_key, "Object Geometry -> Select Update", RELATION_FLAG_NO_FLUSH);
 }
 
+void DepsgraphRelationBuilder::build_object_modifiers(Object *object)
+{
+  BLI_assert(stack_owner_ == nullptr);
+  stack_owner_ = graph_->find_id_node(&object->id);
+  stack_owner_->has_physics_modifiers = deg_object_has_physics_modifiers(object);
+  OperationKey obdata_ubereval_key(&object->id, NodeType::GEOMETRY, OperationCode::GEOMETRY_EVAL);
+  /* Modifiers. */
+  if (object->modifiers.first != nullptr) {
+    ModifierUpdateDepsgraphContext ctx = {};
+    ctx.scene = scene_;
+    ctx.object = object;
+    LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+      const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+      if (mti->updateDepsgraph) {
+        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
+        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
+        mti->updateDepsgraph(md, &ctx);
+      }
+      if (BKE_object_modifier_use_time(scene_, object, md)) {
+        TimeSourceKey time_src_key;
+        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
+      }
+    }
+  }
+  /* Grease Pencil Modifiers. */
+  if (object->greasepencil_modifiers.first != nullptr) {
+    ModifierUpdateDepsgraphContext ctx = {};
+    ctx.scene = scene_;
+    ctx.object = object;
+    LISTBASE_FOREACH (GpencilModifierData *, md, &object->greasepencil_modifiers) {
+      const GpencilModifierTypeInfo *mti = BKE_gpencil_modifier_get_info(
+          (GpencilModifierType)md->type);
+      if (mti->updateDepsgraph) {
+        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
+        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
+        mti->updateDepsgraph(md, &ctx, graph_->mode);
+      }
+      if (BKE_object_modifier_gpencil_use_time(object, md)) {
+        TimeSourceKey time_src_key;
+        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
+      }
+    }
+  }
+  /* Shader FX. */
+  if (object->shader_fx.first != nullptr) {
+    ModifierUpdateDepsgraphContext ctx = {};
+    ctx.scene = scene_;
+    ctx.object = object;
+    LISTBASE_FOREACH (ShaderFxData *, fx, &object->shader_fx) {
+      const ShaderFxTypeInfo *fxi = BKE_shaderfx_get_info((ShaderFxType)fx->type);
+      if (fxi->updateDepsgraph) {
+        DepsNodeHandle handle = create_node_handle(obdata_ubereval_key);
+        ctx.node = reinterpret_cast<::DepsNodeHandle *>(&handle);
+        fxi->updateDepsgraph(fx, &ctx);
+      }
+      if (BKE_object_shaderfx_use_time(object, fx)) {
+        TimeSourceKey time_src_key;
+        add_relation(time_src_key, obdata_ubereval_key, "Time Source");
+      }
+    }
+  }
+  stack_owner_ = nullptr;
+}
+
+bool DepsgraphRelationBuilder::build_object_stacks_update(Scene *scene, Object *object)
+{
+  scene_ = scene;
+  IDNode *id_node = graph_->find_id_node(&object->id);
+  /* All relations of the stacks lead to operations of the object itself. */
+  auto stack_relations = [id_node]() {
+    Vector<Relation *> relations;
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->inlinks) {
+          if (rel->stack_owner == id_node) {
+            relations.append(rel);
+          }
+        }
+      }
+    }
+    return relations;
+  };
+  for (Relation *rel : stack_relations()) {
+    rel->unlink();
+    delete rel;
+  }
+  build_object_constraints(object);
+  OperationKey obdata_ubereval_key(&object->id, NodeType::GEOMETRY, OperationCode::GEOMETRY_EVAL);
+  if (has_node(obdata_ubereval_key)) {
+    build_object_modifiers(object);
+  }
+  /* Relations into no-op operations which are not used by anything are removed when the graph is
+   * built. Such operation does not wait for its own dependencies anymore, so new relations from it
+   * would allow to evaluate the stack too early. */
+  for (Relation *rel : stack_relations()) {
+    if (rel->from->type != NodeType::OPERATION) {
+      continue;
+    }
+    OperationNode *op_from = static_cast<OperationNode *>(rel->from);
+    if (op_from->is_noop() && op_from->inlinks.is_empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void DepsgraphRelationBuilder::build_object_data_geometry_datablock(ID *obdata)
 {
   if (built_map_.checkIsBuiltAndTag(obdata)) {
@@ -211,6 +211,8 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   virtual void build_object_data_speaker(Object *object);
   virtual void build_object_parent(Object *object);
   virtual void build_object_pointcache(Object *object);
+  virtual void build_object_constraints(Object *object);
+  virtual void build_object_modifiers(Object *object);
   virtual void build_constraints(ID *id,
                                  NodeType component_type,
                                  const char *component_subdata,
@@ -301,6 +303,12 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   virtual void build_driver_relations();
   virtual void build_driver_relations(IDNode *id_node);
 
+  /* Replace relations of the modifier and constraint stacks of an object which is already in the
+   * finalized graph, keeping the rest of the graph as it is.
+   * Returns false when the new relations can not be trusted without a full rebuild of the graph,
+   * see #deg_graph_remove_unused_noops. */
+  bool build_object_stacks_update(Scene *scene, Object *object);
+
   template<typename KeyType> OperationNode *find_operation_node(const KeyType &key);
 
   Depsgraph *getGraph();
@@ -328,6 +336,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                                    const char *description,
                                    int flags = 0);
 
+  /* Add relation to the graph, keeping track of the stack which owns it. */
+  Relation *add_new_relation(Node *node_from, Node *node_to, const char *description, int flags);
+
   template<typename KeyType>
   DepsNodeHandle create_node_handle(const KeyType &key, const char *default_name = "");
 
@@ -361,6 +372,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   /* State which demotes currently built entities. */
   Scene *scene_;
 
+  /* Object which stack relations are being built, see #Relation::stack_owner. */
+  IDNode *stack_owner_;
+
   BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
 };
@@ -14,6 +14,8 @@
 #include "deg_builder_relations.h"
 #include "deg_builder_transitive.h"
 
+#include "intern/node/deg_node_operation.h"
+
 namespace blender::deg {
 
 AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
@@ -26,18 +28,39 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
 
 void AbstractBuilderPipeline::build()
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+  const bool do_time = (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) != 0;
+  double start_time = 0.0, nodes_time = 0.0, relations_time = 0.0;
+  if (do_time) {
     start_time = PIL_check_seconds_timer();
   }
 
   build_step_sanity_check();
   build_step_nodes();
+  if (do_time) {
+    nodes_time = PIL_check_seconds_timer();
+  }
   build_step_relations();
+  if (do_time) {
+    relations_time = PIL_check_seconds_timer();
+  }
   build_step_finalize();
 
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
+  if (do_time) {
+    const double end_time = PIL_check_seconds_timer();
+    deg_graph_->debug.last_full_build_time = end_time - start_time;
+    int64_t relations_num = 0;
+    for (const OperationNode *op_node : deg_graph_->operations) {
+      relations_num += op_node->inlinks.size();
+    }
+    printf("Depsgraph built in %f seconds.\n", end_time - start_time);
+    printf("  Nodes: %f seconds (%d IDs, %d operations)\n",
+           nodes_time - start_time,
+           int(deg_graph_->id_nodes.size()),
+           int(deg_graph_->operations.size()));
+    printf("  Relations: %f seconds (%d relations between operations)\n",
+           relations_time - nodes_time,
+           int(relations_num));
+    printf("  Finalize: %f seconds\n", end_time - relations_time);
   }
 }
 
@@ -91,6 +114,7 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update = false;
+  deg_graph_->need_update_stacks.clear();
 }
 
 unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2020 Blender Foundation. All rights reserved. */
+
+#include "pipeline_object_stacks.h"
+
+#include "PIL_time.h"
+
+#include "BKE_constraint.h"
+#include "BKE_global.h"
+#include "BKE_gpencil_modifier.h"
+#include "BKE_modifier.h"
+#include "BKE_shader_fx.h"
+
+#include "DNA_object_types.h"
+
+#include "intern/builder/deg_builder.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/debug/deg_debug.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace blender::deg {
+
+namespace {
+
+struct StackIDsCheckData {
+  const Depsgraph *graph;
+  bool all_ids_in_graph;
+};
+
+void stack_id_check_walk(void *user_data, Object * /*object*/, ID **idpoin, int /*cb_flag*/)
+{
+  StackIDsCheckData *data = static_cast<StackIDsCheckData *>(user_data);
+  if (*idpoin != nullptr && data->graph->find_id_node(*idpoin) == nullptr) {
+    data->all_ids_in_graph = false;
+  }
+}
+
+void constraint_id_check_walk(bConstraint * /*con*/,
+                              ID **idpoin,
+                              bool /*is_reference*/,
+                              void *user_data)
+{
+  stack_id_check_walk(user_data, nullptr, idpoin, 0);
+}
+
+/* Nodes are not built for the IDs used by the stacks, so they are to be in the graph already. */
+bool object_stacks_ids_in_graph(const Depsgraph *graph, Object *object)
+{
+  StackIDsCheckData data = {graph, true};
+  BKE_modifiers_foreach_ID_link(object, stack_id_check_walk, &data);
+  BKE_gpencil_modifiers_foreach_ID_link(object, stack_id_check_walk, &data);
+  BKE_shaderfx_foreach_ID_link(object, stack_id_check_walk, &data);
+  BKE_constraints_id_loop(&object->constraints, constraint_id_check_walk, &data);
+  return data.all_ids_in_graph;
+}
+
+}  // namespace
+
+ObjectStacksBuilderPipeline::ObjectStacksBuilderPipeline(::Depsgraph *graph)
+    : ViewLayerBuilderPipeline(graph)
+{
+}
+
+void ObjectStacksBuilderPipeline::update()
+{
+  const Vector<Object *> objects = tagged_objects_in_graph();
+  if (!can_update_stacks(objects)) {
+    DEG_DEBUG_PRINTF((::Depsgraph *)deg_graph_,
+                     BUILD,
+                     "Object stacks can not be updated on their own, rebuilding the graph\n");
+    build();
+    return;
+  }
+
+  const bool do_time = (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) != 0;
+  const int objects_num = int(objects.size());
+  double start_time = 0.0;
+  if (do_time) {
+    start_time = PIL_check_seconds_timer();
+  }
+
+  build_step_sanity_check();
+  if (!build_step_stacks(objects)) {
+    DEG_DEBUG_PRINTF((::Depsgraph *)deg_graph_,
+                     BUILD,
+                     "Object stacks use operations removed from the graph, rebuilding the graph\n");
+    build();
+    return;
+  }
+  build_step_finalize();
+
+  if (do_time) {
+    printf("Depsgraph relations of %d object stacks updated in %f seconds "
+           "(last full build took %f seconds).\n",
+           objects_num,
+           PIL_check_seconds_timer() - start_time,
+           deg_graph_->debug.last_full_build_time);
+  }
+}
+
+Vector<Object *> ObjectStacksBuilderPipeline::tagged_objects_in_graph() const
+{
+  /* Stacks of objects which are not in the graph do not affect it. Looking objects up through the
+   * ID nodes also skips tagged objects which were freed since, removing IDs which are still used
+   * by the graph requires a full relations update anyway. */
+  Vector<Object *> objects;
+  for (const IDNode *id_node : deg_graph_->id_nodes) {
+    if (id_node->id_type == ID_OB &&
+        deg_graph_->need_update_stacks.contains(id_node->id_orig_session_uuid)) {
+      objects.append(reinterpret_cast<Object *>(id_node->id_orig));
+    }
+  }
+  return objects;
+}
+
+bool ObjectStacksBuilderPipeline::can_update_stacks(const Span<Object *> objects) const
+{
+  /* Relations removed by the transitive reduction might not be redundant anymore. */
+  if (G.debug_value == 799) {
+    return false;
+  }
+  for (Object *object : objects) {
+    const IDNode *id_node = deg_graph_->find_id_node(&object->id);
+    if (id_node->has_physics_modifiers || deg_object_has_physics_modifiers(object)) {
+      return false;
+    }
+    if (!object_stacks_ids_in_graph(deg_graph_, object)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ObjectStacksBuilderPipeline::build_step_stacks(const Span<Object *> objects)
+{
+  /* Changes of evaluation flags and custom data masks are detected against the current state of
+   * the graph, see #deg_graph_build_finalize. */
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+  }
+  unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+  unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+  for (Object *object : objects) {
+    node_builder->build_object_stacks_update(scene_, object);
+    if (!relation_builder->build_object_stacks_update(scene_, object)) {
+      return false;
+    }
+  }
+  /* Cycles are detected from scratch, the relations which were breaking cycles might not be part
+   * of any cycle anymore. */
+  for (OperationNode *op_node : deg_graph_->operations) {
+    for (Relation *rel : op_node->inlinks) {
+      rel->flag &= ~RELATION_FLAG_CYCLIC;
+    }
+  }
+  return true;
+}
+
+}  // namespace blender::deg
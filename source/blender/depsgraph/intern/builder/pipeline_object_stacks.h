@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2020 Blender Foundation. All rights reserved. */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "pipeline_view_layer.h"
+
+struct Object;
+
+namespace blender {
+namespace deg {
+
+/* Updates relations of the modifier and constraint stacks of objects tagged with
+ * #DEG_relations_tag_update_object_stacks, keeping the rest of the graph as it is.
+ *
+ * Only objects which are already in the graph and which stacks only use IDs from the graph are
+ * handled this way. Otherwise, or when an object has physics modifiers before or after the
+ * change, the whole graph is rebuilt from the view layer. */
+class ObjectStacksBuilderPipeline : public ViewLayerBuilderPipeline {
+ public:
+  ObjectStacksBuilderPipeline(::Depsgraph *graph);
+
+  void update();
+
+ protected:
+  /* Original objects in the graph which stacks are tagged for update. */
+  Vector<Object *> tagged_objects_in_graph() const;
+  bool can_update_stacks(Span<Object *> objects) const;
+  bool build_step_stacks(Span<Object *> objects);
+};
+
+}  // namespace deg
+}  // namespace blender
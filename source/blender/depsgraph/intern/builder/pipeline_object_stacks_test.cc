@@ -0,0 +1,215 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "BLI_listbase.h"
+#include "BLI_set.hh"
+
+#include "BKE_collection.h"
+#include "BKE_constraint.h"
+#include "BKE_layer.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_modifier.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "DEG_depsgraph_build.h"
+
+#include "DNA_constraint_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace blender::deg::tests {
+
+/* Reuses the kernel setup of the blendfile loading tests, no file is loaded. */
+class ObjectStacksBuilderPipelineTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  Object *target = nullptr;
+  Object *object_a = nullptr;
+  Object *object_b = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    target = add_object(OB_EMPTY, "Target");
+    object_a = add_object(OB_MESH, "A");
+    object_b = add_object(OB_EMPTY, "B");
+    depsgraph = build_graph();
+  }
+
+  void TearDown() override
+  {
+    /* Frees #depsgraph, which uses the main database. */
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  Object *add_object(const int type, const char *name)
+  {
+    Object *object = BKE_object_add_only_object(bmain, type, name);
+    object->data = BKE_object_obdata_add_from_type(bmain, type, name);
+    BKE_collection_object_add(bmain, scene->master_collection, object);
+    return object;
+  }
+
+  ::Depsgraph *build_graph()
+  {
+    ::Depsgraph *graph = DEG_graph_new(
+        bmain, scene, BKE_view_layer_default_view(scene), DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(graph);
+    return graph;
+  }
+
+  static void add_hook(Object *object, Object *hook_object)
+  {
+    HookModifierData *hmd = reinterpret_cast<HookModifierData *>(
+        BKE_modifier_new(eModifierType_Hook));
+    hmd->object = hook_object;
+    BLI_addtail(&object->modifiers, hmd);
+  }
+
+  static void add_copy_location(Object *object, Object *target_object)
+  {
+    bConstraint *con = BKE_constraint_add_for_object(
+        object, "Copy Location", CONSTRAINT_TYPE_LOCLIKE);
+    static_cast<bLocateLikeConstraint *>(con->data)->tar = target_object;
+  }
+};
+
+static std::string node_identifier(const Node *node)
+{
+  if (node->get_class() == NodeClass::OPERATION) {
+    return static_cast<const OperationNode *>(node)->full_identifier();
+  }
+  return node->identifier();
+}
+
+/* All operations and the relations between them, in a form that can be compared between graphs
+ * that were built separately. */
+static Set<std::string> graph_description(const ::Depsgraph *graph)
+{
+  const Depsgraph *deg_graph = reinterpret_cast<const Depsgraph *>(graph);
+  Set<std::string> description;
+  for (const OperationNode *op_node : deg_graph->operations) {
+    description.add(op_node->full_identifier());
+    for (const Relation *rel : op_node->inlinks) {
+      description.add(node_identifier(rel->from) + " -> " + op_node->full_identifier());
+    }
+  }
+  return description;
+}
+
+static bool graph_has_relation(const ::Depsgraph *graph, const Object *from, const Object *to)
+{
+  const Depsgraph *deg_graph = reinterpret_cast<const Depsgraph *>(graph);
+  for (const OperationNode *op_node : deg_graph->operations) {
+    if (op_node->owner->owner->id_orig != &to->id) {
+      continue;
+    }
+    for (const Relation *rel : op_node->inlinks) {
+      if (rel->from->get_class() == NodeClass::OPERATION &&
+          static_cast<const OperationNode *>(rel->from)->owner->owner->id_orig == &from->id) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void expect_graphs_equal(const ::Depsgraph *graph_a, const ::Depsgraph *graph_b)
+{
+  const Set<std::string> description_a = graph_description(graph_a);
+  const Set<std::string> description_b = graph_description(graph_b);
+  EXPECT_EQ(description_a.size(), description_b.size());
+  for (const std::string &item : description_a) {
+    EXPECT_TRUE(description_b.contains(item)) << item;
+  }
+}
+
+TEST_F(ObjectStacksBuilderPipelineTest, UpdateMatchesFullBuild)
+{
+  add_hook(object_a, target);
+  add_copy_location(object_b, target);
+  DEG_relations_tag_update_object_stacks(bmain, object_a);
+  DEG_relations_tag_update_object_stacks(bmain, object_b);
+  DEG_graph_relations_update(depsgraph);
+
+  EXPECT_TRUE(graph_has_relation(depsgraph, target, object_a));
+  EXPECT_TRUE(graph_has_relation(depsgraph, target, object_b));
+  ::Depsgraph *full_graph = build_graph();
+  expect_graphs_equal(depsgraph, full_graph);
+  DEG_graph_free(full_graph);
+
+  /* Removing the modifier removes its relations again. */
+  ModifierData *md = static_cast<ModifierData *>(object_a->modifiers.first);
+  BKE_modifier_remove_from_list(object_a, md);
+  BKE_modifier_free(md);
+  DEG_relations_tag_update_object_stacks(bmain, object_a);
+  DEG_graph_relations_update(depsgraph);
+
+  EXPECT_FALSE(graph_has_relation(depsgraph, target, object_a));
+  full_graph = build_graph();
+  expect_graphs_equal(depsgraph, full_graph);
+  DEG_graph_free(full_graph);
+}
+
+TEST_F(ObjectStacksBuilderPipelineTest, OnlyTaggedStacksAreUpdated)
+{
+  add_hook(object_a, target);
+  /* Not tagged, so it is only picked up by a full build. */
+  add_copy_location(object_b, target);
+  DEG_relations_tag_update_object_stacks(bmain, object_a);
+  DEG_graph_relations_update(depsgraph);
+
+  EXPECT_TRUE(graph_has_relation(depsgraph, target, object_a));
+  EXPECT_FALSE(graph_has_relation(depsgraph, target, object_b));
+}
+
+TEST_F(ObjectStacksBuilderPipelineTest, PhysicsModifierRebuildsGraph)
+{
+  BLI_addtail(&object_a->modifiers, BKE_modifier_new(eModifierType_Collision));
+  /* Not tagged, so it is only picked up by a full build. */
+  add_copy_location(object_b, target);
+  DEG_relations_tag_update_object_stacks(bmain, object_a);
+  DEG_graph_relations_update(depsgraph);
+
+  EXPECT_TRUE(graph_has_relation(depsgraph, target, object_b));
+  ::Depsgraph *full_graph = build_graph();
+  expect_graphs_equal(depsgraph, full_graph);
+  DEG_graph_free(full_graph);
+}
+
+TEST_F(ObjectStacksBuilderPipelineTest, TaggedObjectFreed)
+{
+  Object *object_c = add_object(OB_EMPTY, "C");
+  /* Stacks of objects that are not in the graph yet don't affect it. */
+  DEG_relations_tag_update_object_stacks(bmain, object_c);
+  BKE_id_delete(bmain, object_c);
+
+  add_hook(object_a, target);
+  DEG_relations_tag_update_object_stacks(bmain, object_a);
+  DEG_graph_relations_update(depsgraph);
+
+  EXPECT_TRUE(graph_has_relation(depsgraph, target, object_a));
+  ::Depsgraph *full_graph = build_graph();
+  expect_graphs_equal(depsgraph, full_graph);
+  DEG_graph_free(full_graph);
+}
+
+}  // namespace blender::deg::tests
@@ -19,7 +19,10 @@
 namespace blender::deg {
 
 DepsgraphDebug::DepsgraphDebug()
-    : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
+    : flags(G.debug),
+      is_ever_evaluated(false),
+      last_full_build_time(0.0),
+      graph_evaluation_start_time_(0)
 {
 }
 
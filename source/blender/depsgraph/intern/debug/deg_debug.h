@@ -37,6 +37,10 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* Time spent on the last full build of the graph, printed along with the time of incremental
+   * updates of its relations for comparison. Is only measured when time debug is enabled. */
+  double last_full_build_time;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
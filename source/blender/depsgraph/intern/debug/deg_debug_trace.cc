@@ -0,0 +1,191 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation trace in the Chrome trace event format, which can be opened in `chrome://tracing`
+ * or https://ui.perfetto.dev to see which operations ran on which thread and when.
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "PIL_time.h"
+
+#include "BLI_fileops.h"
+#include "BLI_string_ref.hh"
+#include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph_debug.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace blender::deg {
+namespace {
+
+struct TraceEvent {
+  std::string name;
+  std::string graph_name;
+  double start_time;
+  double end_time;
+};
+
+/* Events recorded on a single thread, so recording does not need any locking. */
+struct TraceThreadEvents {
+  int thread_index;
+  Vector<TraceEvent> events;
+};
+
+struct TraceRecorder {
+  std::string filepath;
+  /* Identifies this recording, so threads don't use buffers of a previous one. */
+  int session;
+  /* Time at which recording started, events are written relative to it. */
+  double start_time;
+
+  std::mutex mutex;
+  Vector<std::unique_ptr<TraceThreadEvents>> threads;
+};
+
+TraceRecorder *trace_recorder = nullptr;
+int trace_session_last = 0;
+
+Vector<TraceEvent> &trace_thread_events_get()
+{
+  static thread_local TraceThreadEvents *thread_events = nullptr;
+  static thread_local int thread_session = 0;
+  if (thread_session != trace_recorder->session) {
+    std::lock_guard lock{trace_recorder->mutex};
+    std::unique_ptr<TraceThreadEvents> new_events = std::make_unique<TraceThreadEvents>();
+    new_events->thread_index = int(trace_recorder->threads.size());
+    thread_events = new_events.get();
+    thread_session = trace_recorder->session;
+    trace_recorder->threads.append(std::move(new_events));
+  }
+  return thread_events->events;
+}
+
+void trace_add_event(const Depsgraph *graph,
+                     std::string name,
+                     const double start_time,
+                     const double end_time)
+{
+  trace_thread_events_get().append({std::move(name), graph->debug.name, start_time, end_time});
+}
+
+void trace_write_json_string(FILE *file, StringRef str)
+{
+  fputc('"', file);
+  for (const char c : str) {
+    if (ELEM(c, '"', '\\')) {
+      fputc('\\', file);
+      fputc(c, file);
+    }
+    else if (uchar(c) < 0x20) {
+      fprintf(file, "\\u%04x", int(c));
+    }
+    else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+bool trace_write(const TraceRecorder &recorder)
+{
+  FILE *file = BLI_fopen(recorder.filepath.c_str(), "w");
+  if (file == nullptr) {
+    return false;
+  }
+
+  fprintf(file, "{\"traceEvents\":[\n");
+  bool is_first = true;
+  for (const std::unique_ptr<TraceThreadEvents> &thread : recorder.threads) {
+    fprintf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+            "\"args\":{\"name\":\"Thread %d\"}}",
+            is_first ? "" : ",\n",
+            thread->thread_index,
+            thread->thread_index);
+    is_first = false;
+    for (const TraceEvent &event : thread->events) {
+      /* Times are in microseconds. */
+      fprintf(file, ",\n{\"name\":");
+      trace_write_json_string(file, event.name);
+      fprintf(file,
+              ",\"cat\":\"depsgraph\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,"
+              "\"dur\":%.3f,\"args\":{\"depsgraph\":",
+              thread->thread_index,
+              (event.start_time - recorder.start_time) * 1e6,
+              (event.end_time - event.start_time) * 1e6);
+      trace_write_json_string(file, event.graph_name);
+      fprintf(file, "}}");
+    }
+  }
+  fprintf(file, "\n]}\n");
+
+  const bool success = (ferror(file) == 0);
+  fclose(file);
+  return success;
+}
+
+}  // namespace
+
+bool deg_debug_trace_is_enabled()
+{
+  return trace_recorder != nullptr;
+}
+
+void deg_debug_trace_add_operation(const Depsgraph *graph,
+                                   const OperationNode *operation_node,
+                                   const double start_time,
+                                   const double end_time)
+{
+  trace_add_event(graph, operation_node->full_identifier(), start_time, end_time);
+}
+
+void deg_debug_trace_add_graph_evaluation(const Depsgraph *graph,
+                                          const double start_time,
+                                          const double end_time)
+{
+  trace_add_event(graph, "Depsgraph evaluation", start_time, end_time);
+}
+
+}  // namespace blender::deg
+
+namespace deg = blender::deg;
+
+void DEG_debug_trace_begin(const char *filepath)
+{
+  if (deg::trace_recorder != nullptr) {
+    /* Already recording. */
+    return;
+  }
+  deg::trace_recorder = new deg::TraceRecorder();
+  deg::trace_recorder->filepath = filepath;
+  deg::trace_recorder->session = ++deg::trace_session_last;
+  deg::trace_recorder->start_time = PIL_check_seconds_timer();
+}
+
+void DEG_debug_trace_end()
+{
+  if (deg::trace_recorder == nullptr) {
+    return;
+  }
+  if (!deg::trace_write(*deg::trace_recorder)) {
+    fprintf(stderr,
+            "Failed to write depsgraph trace to '%s'\n",
+            deg::trace_recorder->filepath.c_str());
+  }
+  else {
+    printf("Depsgraph trace written to '%s'\n", deg::trace_recorder->filepath.c_str());
+  }
+  delete deg::trace_recorder;
+  deg::trace_recorder = nullptr;
+}
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Recording of the evaluation of operations, see #DEG_debug_trace_begin.
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Whether evaluation is recorded, the timings passed to the functions below are only needed
+ * when this is true. */
+bool deg_debug_trace_is_enabled();
+
+/* Record the evaluation of an operation on the current thread.
+ * Times are in seconds, as returned by #PIL_check_seconds_timer. */
+void deg_debug_trace_add_operation(const Depsgraph *graph,
+                                   const OperationNode *operation_node,
+                                   double start_time,
+                                   double end_time);
+
+/* Record the evaluation of a whole dependency graph. */
+void deg_debug_trace_add_graph_evaluation(const Depsgraph *graph,
+                                          double start_time,
+                                          double end_time);
+
+}  // namespace blender::deg
@@ -48,6 +48,7 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       need_update(true),
       need_visibility_update(true),
       need_visibility_time_update(false),
+      has_lazy_link_ids(false),
       bmain(bmain),
       scene(scene),
       view_layer(view_layer),
@@ -117,6 +118,9 @@ IDNode *Depsgraph::add_id_node(ID *id, ID *id_cow_hint)
     id_nodes.append(id_node);
 
     id_type_exist[BKE_idtype_idcode_to_index(GS(id->name))] = 1;
+    if (id->tag & LIB_TAG_LAZY_LINK) {
+      has_lazy_link_ids = true;
+    }
   }
   return id_node;
 }
@@ -162,6 +166,7 @@ void Depsgraph::clear_id_nodes()
   /* Clear containers. */
   id_hash.clear();
   id_nodes.clear();
+  has_lazy_link_ids = false;
   /* Clear physics relation caches. */
   clear_physics_relations(this);
 }
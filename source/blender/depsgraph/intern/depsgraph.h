@@ -28,6 +28,7 @@
 #include "intern/depsgraph_type.h"
 
 struct ID;
+struct Object;
 struct Scene;
 struct ViewLayer;
 
@@ -92,6 +93,12 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* Session UUIDs of objects which modifier or constraint stacks changed. Only relations of these
+   * stacks are updated when possible, see #DEG_relations_tag_update_object_stacks.
+   * Not used when #need_update is set, the whole graph is rebuilt then.
+   * Objects can be freed before the relations are updated, so they are not stored as pointers. */
+  Set<uint> need_update_stacks;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_visibility_update;
@@ -103,6 +110,10 @@ struct Depsgraph {
   /* Indicates type of IDs present in the depsgraph. */
   char id_type_exist[INDEX_ID_MAX];
 
+  /* Indicates whether place-holders of lazily linked IDs are present in the depsgraph,
+   * see #DEG_graph_lazy_link_ids_tag. */
+  bool has_lazy_link_ids;
+
   /* Quick-Access Temp Data ............. */
 
   /* Nodes which have been tagged as "directly modified". */
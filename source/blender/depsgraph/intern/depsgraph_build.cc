@@ -34,6 +34,7 @@
 #include "builder/pipeline_all_objects.h"
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_object_stacks.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -286,10 +287,15 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
 void DEG_graph_relations_update(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = (deg::Depsgraph *)graph;
-  if (!deg_graph->need_update) {
+  if (!deg_graph->need_update && deg_graph->need_update_stacks.is_empty()) {
     /* Graph is up to date, nothing to do. */
     return;
   }
+  if (!deg_graph->need_update) {
+    deg::ObjectStacksBuilderPipeline builder(graph);
+    builder.update();
+    return;
+  }
   DEG_graph_build_from_view_layer(graph);
 }
 
@@ -300,3 +306,16 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_relations_tag_update_object_stacks(Main *bmain, Object *object)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(
+      TAG, "%s: Tagging stacks relations of %s for update.\n", __func__, object->id.name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    if (depsgraph->need_update) {
+      /* The whole graph is rebuilt anyway. */
+      continue;
+    }
+    depsgraph->need_update_stacks.add(object->id.session_uuid);
+  }
+}
@@ -133,6 +133,22 @@ bool DEG_id_type_any_exists(const Depsgraph *depsgraph, short id_type)
   return deg_graph->id_type_exist[BKE_idtype_idcode_to_index(id_type)] != 0;
 }
 
+int DEG_graph_lazy_link_ids_tag(const Depsgraph *depsgraph)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(depsgraph);
+  if (!deg_graph->has_lazy_link_ids) {
+    return 0;
+  }
+  int tagged_num = 0;
+  for (deg::IDNode *id_node : deg_graph->id_nodes) {
+    if (id_node->id_orig->tag & LIB_TAG_LAZY_LINK) {
+      id_node->id_orig->tag |= LIB_TAG_DOIT;
+      tagged_num++;
+    }
+  }
+  return tagged_num;
+}
+
 uint32_t DEG_get_eval_flags_for_id(const Depsgraph *graph, const ID *id)
 {
   if (graph == nullptr) {
@@ -328,7 +344,7 @@ bool DEG_is_fully_evaluated(const struct Depsgraph *depsgraph)
 {
   const deg::Depsgraph *deg_graph = (const deg::Depsgraph *)depsgraph;
   /* Check whether relations are up to date. */
-  if (deg_graph->need_update) {
+  if (deg_graph->need_update || !deg_graph->need_update_stacks.is_empty()) {
     return false;
   }
   /* Check whether IDs are up to date. */
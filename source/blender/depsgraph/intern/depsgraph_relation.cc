@@ -15,7 +15,7 @@
 namespace blender::deg {
 
 Relation::Relation(Node *from, Node *to, const char *description)
-    : from(from), to(to), name(description), flag(0)
+    : from(from), to(to), name(description), flag(0), stack_owner(nullptr)
 {
   /* Hook it up to the nodes which use it.
    *
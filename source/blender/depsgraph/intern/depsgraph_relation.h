@@ -12,6 +12,7 @@
 namespace blender {
 namespace deg {
 
+struct IDNode;
 struct Node;
 
 /* Settings/Tags on Relationship.
@@ -46,6 +47,11 @@ struct Relation {
   const char *name; /* label for debugging */
   int flag;         /* Bitmask of RelationFlag) */
 
+  /* ID node of the object whose modifier and constraint stacks added this relation. nullptr for
+   * relations which are not added by the stacks, or which are also needed by other parts of the
+   * graph. Allows to only rebuild relations of the stacks when they change. */
+  IDNode *stack_owner;
+
   MEM_CXX_CLASS_ALLOC_FUNCS("Relation");
 };
 
@@ -13,8 +13,11 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_heap.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.h"
 
@@ -33,6 +36,7 @@
 
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_relation.h"
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph_tag.h"
 #include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/eval/deg_eval_flush.h"
@@ -57,10 +61,7 @@ void schedule_children(DepsgraphEvalState *state,
                        ScheduleFunction *schedule_function,
                        ScheduleFunctionArgs... schedule_function_args);
 
-void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
-{
-  BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
-}
+void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *pool);
 
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
@@ -84,22 +85,44 @@ struct DepsgraphEvalState {
   bool do_stats;
   EvaluationStage stage;
   bool need_single_thread_pass;
+
+  /* Operations which are ready to be evaluated, ordered by #OperationNode.eval_priority.
+   * Every task of the pool evaluates the operation with the highest priority at the time it
+   * starts, rather than the operation it was pushed for. */
+  Heap *ready_heap;
+  SpinLock ready_lock;
 };
 
+/* Added to the cost of every operation, so chains of operations which were not timed yet are
+ * still prioritized by their length. */
+#define EVAL_COST_MIN 1e-6f
+
+void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
+{
+  DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_user_data(pool);
+  BLI_spin_lock(&state->ready_lock);
+  BLI_heap_insert(state->ready_heap, -node->eval_priority, node);
+  BLI_spin_unlock(&state->ready_lock);
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
+}
+
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
+  /* Perform operation, timing it to estimate its cost for scheduling the next evaluation. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  const double duration = end_time - start_time;
+  operation_node->eval_cost = float(duration);
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += duration;
   }
-  else {
-    operation_node->evaluate(depsgraph);
+  if (deg_debug_trace_is_enabled()) {
+    deg_debug_trace_add_operation(state->graph, operation_node, start_time, end_time);
   }
 }
 
@@ -108,8 +131,13 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
+  /* Evaluate the ready node with the highest priority, there is at least one for every task. */
+  BLI_assert(taskdata == nullptr);
+  UNUSED_VARS_NDEBUG(taskdata);
+  BLI_spin_lock(&state->ready_lock);
+  OperationNode *operation_node = reinterpret_cast<OperationNode *>(
+      BLI_heap_pop_min(state->ready_heap));
+  BLI_spin_unlock(&state->ready_lock);
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
@@ -166,10 +194,71 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
+bool need_evaluate_operation(OperationNode *node)
+{
+  return (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) && check_operation_node_visible(node);
+}
+
+/* Set the #OperationNode.eval_priority of all operations which will be evaluated to the estimated
+ * cost of the longest chain of operations starting with them (the critical path), so operations
+ * which many others are waiting on are evaluated first. */
+void calculate_priorities(Depsgraph *graph)
+{
+  /* Negative values are used to mark operations which were not visited yet. */
+  const float priority_unvisited = -1.0f;
+  const float priority_in_progress = -2.0f;
+  for (OperationNode *node : graph->operations) {
+    node->eval_priority = priority_unvisited;
+    /* Copy-on-write of large geometry dominates the first evaluation of a scene, so estimate
+     * its cost before it was ever measured to start copying the largest data-blocks first. */
+    if (node->eval_cost == 0.0f && node->owner->type == NodeType::COPY_ON_WRITE) {
+      node->eval_cost = deg_copy_on_write_cost_estimate(node->owner->owner->id_orig);
+    }
+  }
+
+  /* Depth first traversal, computing the priority of operations after their children. */
+  struct StackEntry {
+    OperationNode *node;
+    int64_t outlink_index;
+  };
+  Vector<StackEntry> stack;
+  for (OperationNode *root : graph->operations) {
+    if (root->eval_priority != priority_unvisited || !need_evaluate_operation(root)) {
+      continue;
+    }
+    root->eval_priority = priority_in_progress;
+    stack.append({root, 0});
+    while (!stack.is_empty()) {
+      StackEntry &entry = stack.last();
+      OperationNode *node = entry.node;
+      if (entry.outlink_index < node->outlinks.size()) {
+        Relation *rel = node->outlinks[entry.outlink_index++];
+        OperationNode *child = (OperationNode *)rel->to;
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 &&
+            child->eval_priority == priority_unvisited && need_evaluate_operation(child)) {
+          child->eval_priority = priority_in_progress;
+          stack.append({child, 0});
+        }
+        continue;
+      }
+      float children_priority = 0.0f;
+      for (Relation *rel : node->outlinks) {
+        const OperationNode *child = (const OperationNode *)rel->to;
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0) {
+          children_priority = std::max(children_priority, child->eval_priority);
+        }
+      }
+      node->eval_priority = children_priority + node->eval_cost + EVAL_COST_MIN;
+      stack.remove_last();
+    }
+  }
+}
+
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
+  calculate_priorities(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
     if (do_stats) {
@@ -353,6 +442,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
 
   graph->debug.begin_graph_evaluation();
+  const double trace_start_time = PIL_check_seconds_timer();
 
 #ifdef WITH_PYTHON
   /* Release the GIL so that Python drivers can be evaluated. See T91046. */
@@ -366,6 +456,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
   state.need_single_thread_pass = false;
+  state.ready_heap = BLI_heap_new();
+  BLI_spin_init(&state.ready_lock);
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
 
@@ -389,6 +481,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     evaluate_graph_single_threaded(&state);
   }
 
+  BLI_assert(BLI_heap_is_empty(state.ready_heap));
+  BLI_heap_free(state.ready_heap, nullptr);
+  BLI_spin_end(&state.ready_lock);
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
@@ -403,6 +499,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   BPy_END_ALLOW_THREADS;
 #endif
 
+  if (deg_debug_trace_is_enabled()) {
+    deg_debug_trace_add_graph_evaluation(graph, trace_start_time, PIL_check_seconds_timer());
+  }
+
   graph->debug.end_graph_evaluation();
 }
 
@@ -41,11 +41,13 @@
 #include "DNA_ID.h"
 #include "DNA_anim_types.h"
 #include "DNA_armature_types.h"
+#include "DNA_curves_types.h"
 #include "DNA_gpencil_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 #include "DNA_particle_types.h"
+#include "DNA_pointcloud_types.h"
 #include "DNA_rigidbody_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
@@ -1075,4 +1077,28 @@ bool deg_copy_on_write_is_needed(const ID_Type id_type)
   return ID_TYPE_IS_COW(id_type);
 }
 
+float deg_copy_on_write_cost_estimate(const ID *id_orig)
+{
+  /* Only geometry is expected to be large enough to matter, assume a few nanoseconds for copying
+   * each element with all of its attributes. */
+  const float element_cost = 5e-9f;
+  switch (GS(id_orig->name)) {
+    case ID_ME: {
+      const Mesh *mesh = (const Mesh *)id_orig;
+      return element_cost *
+             float(int64_t(mesh->totvert) + mesh->totedge + mesh->totloop + mesh->totpoly);
+    }
+    case ID_CV: {
+      const Curves *curves = (const Curves *)id_orig;
+      return element_cost * float(int64_t(curves->geometry.point_num) + curves->geometry.curve_num);
+    }
+    case ID_PT: {
+      const PointCloud *pointcloud = (const PointCloud *)id_orig;
+      return element_cost * float(pointcloud->totpoint);
+    }
+    default:
+      return 0.0f;
+  }
+}
+
 }  // namespace blender::deg
@@ -77,5 +77,9 @@ bool deg_copy_on_write_is_expanded(const struct ID *id_cow);
 bool deg_copy_on_write_is_needed(const ID *id_orig);
 bool deg_copy_on_write_is_needed(const ID_Type id_type);
 
+/* Rough estimate of the time in seconds it takes to expand the copy-on-write version of the given
+ * data-block, used for scheduling until the actual time was measured. */
+float deg_copy_on_write_cost_estimate(const ID *id_orig);
+
 }  // namespace deg
 }  // namespace blender
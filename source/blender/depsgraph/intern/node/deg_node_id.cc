@@ -72,6 +72,7 @@ void IDNode::init(const ID *id, const char *UNUSED(subdata))
   is_directly_visible = true;
   is_collection_fully_expanded = false;
   has_base = false;
+  has_physics_modifiers = false;
   is_user_modified = false;
   id_cow_recalc_backup = 0;
 
@@ -102,6 +102,10 @@ struct IDNode : public Node {
   /* Is used to figure out whether object came to the dependency graph via a base. */
   bool has_base;
 
+  /* Object had physics modifiers when its relations were built. Their relations are not limited
+   * to the stacks of the object, so the stacks relations can not be updated on their own. */
+  bool has_physics_modifiers;
+
   /* Accumulated flag from operation. Is initialized and used during updates flush. */
   bool is_user_modified;
 
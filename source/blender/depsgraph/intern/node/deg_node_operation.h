@@ -256,6 +256,12 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Time the last evaluation took (in seconds), estimates the cost of evaluating it again. */
+  float eval_cost;
+  /* Estimated time to evaluate this operation and the longest chain of operations depending on
+   * it. Ready operations with the highest priority are evaluated first. */
+  float eval_priority;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
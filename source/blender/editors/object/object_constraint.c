@@ -1461,7 +1461,12 @@ static int constraint_delete_exec(bContext *C, wmOperator *op)
     ED_object_constraint_update(bmain, ob);
 
     /* relations */
-    DEG_relations_tag_update(bmain);
+    if (lb == &ob->constraints) {
+      DEG_relations_tag_update_object_stacks(bmain, ob);
+    }
+    else {
+      DEG_relations_tag_update(bmain);
+    }
 
     /* notifiers */
     WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_REMOVED, ob);
@@ -2066,12 +2071,11 @@ static int object_constraints_clear_exec(bContext *C, wmOperator *UNUSED(op))
   CTX_DATA_BEGIN (C, Object *, ob, selected_editable_objects) {
     BKE_constraints_free(&ob->constraints);
     DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+    /* force depsgraph to get recalculated since relationships removed */
+    DEG_relations_tag_update_object_stacks(bmain, ob);
   }
   CTX_DATA_END;
 
-  /* force depsgraph to get recalculated since relationships removed */
-  DEG_relations_tag_update(bmain);
-
   /* do updates */
   WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_REMOVED, NULL);
 
@@ -2446,7 +2450,12 @@ static int constraint_add_exec(
   }
 
   /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
+  if (pchan) {
+    DEG_relations_tag_update(bmain);
+  }
+  else {
+    DEG_relations_tag_update_object_stacks(bmain, ob);
+  }
 
   if ((ob->type == OB_ARMATURE) && (pchan)) {
     BKE_pose_tag_recalc(bmain, ob->pose); /* sort pose channels */
@@ -93,7 +93,7 @@ GpencilModifierData *ED_object_gpencil_modifier_add(
   DEG_id_tag_update(&gpd->id, ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   return new_md;
 }
@@ -110,7 +110,7 @@ static bool gpencil_object_modifier_remove(Main *bmain,
     return false;
   }
 
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   BLI_remlink(&ob->greasepencil_modifiers, md);
   BKE_gpencil_modifier_free(md);
@@ -135,7 +135,7 @@ bool ED_object_gpencil_modifier_remove(ReportList *reports,
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   return true;
 }
@@ -160,7 +160,7 @@ void ED_object_gpencil_modifier_clear(Main *bmain, Object *ob)
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 }
 
 bool ED_object_gpencil_modifier_move_up(ReportList *UNUSED(reports),
@@ -88,7 +88,7 @@ ShaderFxData *ED_object_shaderfx_add(
   DEG_id_tag_update(&gpd->id, ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   return new_fx;
 }
@@ -122,7 +122,7 @@ static bool object_shaderfx_remove(Main *bmain,
     return 0;
   }
 
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   BLI_remlink(&ob->shader_fx, fx);
   BKE_shaderfx_free(fx);
@@ -144,7 +144,7 @@ bool ED_object_shaderfx_remove(ReportList *reports, Main *bmain, Object *ob, Sha
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 
   return 1;
 }
@@ -169,7 +169,7 @@ void ED_object_shaderfx_clear(Main *bmain, Object *ob)
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_object_stacks(bmain, ob);
 }
 
 int ED_object_shaderfx_move_up(ReportList *UNUSED(reports), Object *ob, ShaderFxData *fx)
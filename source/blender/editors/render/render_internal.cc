@@ -961,6 +961,9 @@ static int screen_render_invoke(bContext *C, wmOperator *op, const wmEvent *even
   /* flush sculpt and editmode changes */
   ED_editors_flush_edits_ex(bmain, true, false);
 
+  /* The render job can't modify main, read lazily linked data now. */
+  RE_lazy_link_load(bmain, scene, single_layer, op->reports);
+
   /* cleanup sequencer caches before starting user triggered render.
    * otherwise, invalidated cache entries can make their way into
    * the output rendering. We can't put that into RE_RenderFrame,
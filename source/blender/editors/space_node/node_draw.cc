@@ -1684,6 +1684,16 @@ static std::string node_get_execution_time_label(const SpaceNode &snode, const b
   return stream.str() + " ms";
 }
 
+static bool node_result_is_cached(const SpaceNode &snode, const bNode &node)
+{
+  if (ELEM(node.type, NODE_GROUP, NODE_FRAME, NODE_GROUP_OUTPUT)) {
+    return false;
+  }
+  const geo_log::NodeLog *node_log = geo_log::ModifierLog::find_node_by_node_editor_context(snode,
+                                                                                           node);
+  return node_log != nullptr && node_log->result_is_cached();
+}
+
 struct NodeExtraInfoRow {
   std::string text;
   int icon;
@@ -1841,9 +1851,13 @@ static Vector<NodeExtraInfoRow> node_get_extra_info(const SpaceNode &snode, cons
     NodeExtraInfoRow row;
     row.text = node_get_execution_time_label(snode, node);
     if (!row.text.empty()) {
+      if (node_result_is_cached(snode, node)) {
+        row.text += " (cached)";
+      }
       row.tooltip = TIP_(
           "The execution time from the node tree's latest evaluation. For frame and group nodes, "
-          "the time for all sub-nodes");
+          "the time for all sub-nodes. Cached nodes reused their result from a previous "
+          "evaluation");
       row.icon = ICON_PREVIEW_RANGE;
       rows.append(std::move(row));
     }
@@ -55,6 +55,26 @@ class MultiFunction {
   void call_auto(IndexMask mask, MFParams params, MFContext context) const;
   virtual void call(IndexMask mask, MFParams params, MFContext context) const = 0;
 
+  /**
+   * Functions that only have single inputs and outputs of trivially copyable and destructible
+   * types can support #call_block. It processes contiguous arrays without any indirection, which
+   * allows combining many functions into one loop over small blocks that stay in the CPU cache.
+   * See #procedure_optimization::fuse_block_calls.
+   */
+  virtual bool supports_block_call() const
+  {
+    return false;
+  }
+
+  /**
+   * Compute \a size elements. There is one buffer per parameter, which contains \a size elements.
+   * Output buffers are uninitialized. Only called when #supports_block_call returns true.
+   */
+  virtual void call_block(int64_t UNUSED(size), Span<void *> UNUSED(buffers)) const
+  {
+    BLI_assert_unreachable();
+  }
+
   virtual uint64_t hash() const
   {
     return get_default_hash(this);
@@ -315,10 +315,16 @@ void execute_materialized(TypeSequence<ParamTags...> /* param_tags */,
 template<typename... ParamTags> class CustomMF : public MultiFunction {
  private:
   std::function<void(IndexMask mask, MFParams params)> fn_;
+  /** Only set when all parameter types support #MultiFunction::call_block. */
+  std::function<void(int64_t size, Span<void *> buffers)> block_fn_;
   MFSignature signature_;
 
   using TagsSequence = TypeSequence<ParamTags...>;
 
+  static constexpr bool types_support_block_call =
+      ((std::is_trivially_copyable_v<typename ParamTags::base_type> &&
+        std::is_trivially_destructible_v<typename ParamTags::base_type>)&&...);
+
  public:
   template<typename ElementFn, typename ExecPreset = CustomMF_presets::Materialized>
   CustomMF(const char *name,
@@ -334,6 +340,25 @@ template<typename... ParamTags> class CustomMF : public MultiFunction {
       execute(
           element_fn, exec_preset, mask, params, std::make_index_sequence<TagsSequence::size()>());
     };
+    if constexpr (types_support_block_call) {
+      block_fn_ = [element_fn](const int64_t size, Span<void *> buffers) {
+        execute_block(element_fn, size, buffers, std::make_index_sequence<TagsSequence::size()>());
+      };
+    }
+  }
+
+  /** Loop over contiguous buffers, which is easy to vectorize for the compiler. */
+  template<typename ElementFn, size_t... I>
+  static void execute_block(ElementFn element_fn,
+                            const int64_t size,
+                            Span<void *> buffers,
+                            std::index_sequence<I...> /* indices */)
+  {
+    detail::execute_array(TagsSequence(),
+                          std::index_sequence<I...>(),
+                          element_fn,
+                          IndexRange(size),
+                          static_cast<typename ParamTags::base_type *>(buffers[I])...);
   }
 
   template<typename ElementFn, typename ExecPreset, size_t... I>
@@ -412,6 +437,16 @@ template<typename... ParamTags> class CustomMF : public MultiFunction {
   {
     fn_(mask, params);
   }
+
+  bool supports_block_call() const override
+  {
+    return types_support_block_call;
+  }
+
+  void call_block(const int64_t size, Span<void *> buffers) const override
+  {
+    block_fn_(size, buffers);
+  }
 };
 
 /**
@@ -587,10 +622,18 @@ class CustomMF_GenericConstant : public MultiFunction {
 
   template<typename T> friend class CustomMF_Constant;
 
+  /**
+   * Trivial types are compared bitwise, so that e.g. `-0.0f` and `0.0f` are not merged when
+   * eliminating common subexpressions. They behave differently in functions like `atan2`.
+   */
+  static bool values_are_equal(const CPPType &type, const void *a, const void *b);
+
  public:
   CustomMF_GenericConstant(const CPPType &type, const void *value, bool make_value_copy);
   ~CustomMF_GenericConstant();
   void call(IndexMask mask, MFParams params, MFContext context) const override;
+  bool supports_block_call() const override;
+  void call_block(int64_t size, Span<void *> buffers) const override;
   uint64_t hash() const override;
   bool equals(const MultiFunction &other) const override;
 };
@@ -645,14 +688,15 @@ template<typename T> class CustomMF_Constant : public MultiFunction {
   {
     const CustomMF_Constant *other1 = dynamic_cast<const CustomMF_Constant *>(&other);
     if (other1 != nullptr) {
-      return value_ == other1->value_;
+      return CustomMF_GenericConstant::values_are_equal(
+          CPPType::get<T>(), &value_, &other1->value_);
     }
     const CustomMF_GenericConstant *other2 = dynamic_cast<const CustomMF_GenericConstant *>(
         &other);
     if (other2 != nullptr) {
       const CPPType &type = CPPType::get<T>();
       if (type == other2->type_) {
-        return type.is_equal_or_false(static_cast<const void *>(&value_), other2->value_);
+        return CustomMF_GenericConstant::values_are_equal(type, &value_, other2->value_);
       }
     }
     return false;
@@ -270,6 +270,17 @@ class MFProcedure : NonCopyable, NonMovable {
   MFDummyInstruction &new_dummy_instruction();
   MFReturnInstruction &new_return_instruction();
 
+  /**
+   * Remove an instruction from the procedure. No other instruction may point to it anymore. The
+   * instruction stops using its variables and its successor.
+   */
+  void delete_instruction(MFInstruction &instruction);
+  /**
+   * Remove a variable that is not used by any instruction and is not a parameter. The ids of the
+   * remaining variables change.
+   */
+  void delete_variable(MFVariable &variable);
+
   void add_parameter(MFParamType::InterfaceType interface_type, MFVariable &variable);
   Span<ConstMFParameter> params() const;
 
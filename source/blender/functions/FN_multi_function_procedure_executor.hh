@@ -10,18 +10,36 @@
 
 namespace blender::fn {
 
-/** A multi-function that executes a procedure internally. */
+/**
+ * A multi-function that executes a procedure internally.
+ *
+ * Large masks are split into chunks that are small enough for the temporary buffers of all
+ * variables to stay in the CPU cache. The entire procedure is executed for one chunk before the
+ * next one, instead of executing every instruction for all indices at once. Chunks are processed
+ * in parallel and buffers are reused between the chunks on the same thread.
+ */
 class MFProcedureExecutor : public MultiFunction {
  private:
   MFSignature signature_;
   const MFProcedure &procedure_;
+  /** Number of indices per chunk, zero when the procedure can't be executed in chunks. */
+  int64_t chunk_size_ = 0;
 
  public:
+  static constexpr int64_t min_chunk_size = 1024;
+  static constexpr int64_t max_chunk_size = 16384;
+  /**
+   * Buffers that are reused by all chunks on the same thread are at most this many times larger
+   * than the chunk size. Sparse chunks whose indices span more get their own buffers.
+   */
+  static constexpr int64_t max_chunk_span_factor = 4;
+
   MFProcedureExecutor(const MFProcedure &procedure);
 
   void call(IndexMask mask, MFParams params, MFContext context) const override;
 
  private:
+  void call_chunked(IndexMask full_mask, MFParams params, MFContext context) const;
   ExecutionHints get_execution_hints() const override;
 };
 
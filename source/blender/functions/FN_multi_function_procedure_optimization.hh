@@ -44,4 +44,42 @@ namespace blender::fn::procedure_optimization {
  */
 void move_destructs_up(MFProcedure &procedure, MFInstruction &block_end_instr);
 
+/**
+ * Procedures that are generated from node trees often contain the same computation multiple times,
+ * e.g. when the same constant or the same operation on an input is used in different places.
+ *
+ * This optimization pass removes calls that compute the same outputs as an earlier call, because
+ * they use an equal function (see #MultiFunction::equals) with the same input variables. Later
+ * instructions use the outputs of the earlier call instead.
+ *
+ * Like the other passes, this only looks at the chain of instructions starting at the entry of the
+ * procedure. Calls with mutable parameters are never removed.
+ */
+void eliminate_common_subexpressions(MFProcedure &procedure);
+
+/**
+ * Outputs of call instructions that are not used by any other instruction are not computed at all.
+ * Calls that don't have any used output anymore are removed, which can make outputs of earlier
+ * calls unused as well.
+ *
+ * This only looks at the chain of instructions starting at the entry of the procedure.
+ */
+void remove_unused_outputs(MFProcedure &procedure);
+
+/**
+ * Every call instruction is executed for all indices before the next instruction starts. For long
+ * chains of cheap functions, like math operations, most time is spent writing and reading the
+ * full-size arrays of the intermediate variables.
+ *
+ * This optimization pass replaces consecutive calls to functions that support
+ * #MultiFunction::call_block with a single call to a function that executes all of them on small
+ * blocks of elements, which stay in the CPU cache. Intermediate variables that are only used by
+ * the fused calls are removed. The fused loops over contiguous buffers can also be vectorized by
+ * the compiler.
+ *
+ * This only looks at the chain of instructions starting at the entry of the procedure, up to the
+ * first branch or return instruction. It should run before #move_destructs_up.
+ */
+void fuse_block_calls(MFProcedure &procedure);
+
 }  // namespace blender::fn::procedure_optimization
@@ -138,13 +138,42 @@ static Set<GFieldRef> find_varying_fields(const FieldTreeInfo &field_tree_info,
   return found_fields;
 }
 
+/**
+ * \return Fields that don't depend on varying inputs, but are used by fields that do. Those can be
+ * computed once and then be used as constants when evaluating the varying fields.
+ */
+static VectorSet<GFieldRef> find_fields_to_fold(const Set<GFieldRef> &varying_fields)
+{
+  VectorSet<GFieldRef> fields_to_fold;
+  for (const GFieldRef &field : varying_fields) {
+    if (field.node().node_type() != FieldNodeType::Operation) {
+      continue;
+    }
+    const FieldOperation &operation = static_cast<const FieldOperation &>(field.node());
+    for (const GFieldRef operation_input : operation.inputs()) {
+      if (varying_fields.contains(operation_input)) {
+        continue;
+      }
+      /* Inputs and constants are passed to the procedure directly already. */
+      if (operation_input.node().node_type() == FieldNodeType::Operation) {
+        fields_to_fold.add(operation_input);
+      }
+    }
+  }
+  return fields_to_fold;
+}
+
 /**
  * Builds the #procedure so that it computes the fields.
+ * \param folded_values: Values of fields that have been computed already, they are used as
+ * constants instead of computing them again.
  */
-static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
-                                                      ResourceScope &scope,
-                                                      const FieldTreeInfo &field_tree_info,
-                                                      Span<GFieldRef> output_fields)
+static void build_multi_function_procedure_for_fields(
+    MFProcedure &procedure,
+    ResourceScope &scope,
+    const FieldTreeInfo &field_tree_info,
+    Span<GFieldRef> output_fields,
+    const Map<GFieldRef, GPointer> &folded_values = {})
 {
   MFProcedureBuilder builder{procedure};
   /* Every input, intermediate and output field corresponds to a variable in the procedure. */
@@ -176,6 +205,13 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
         fields_to_check.pop();
         continue;
       }
+      if (const GPointer *folded_value = folded_values.lookup_ptr(field)) {
+        const MultiFunction &fn = procedure.construct_function<CustomMF_GenericConstant>(
+            *folded_value->type(), folded_value->get(), false);
+        MFVariable &new_variable = *builder.add_call<1>(fn)[0];
+        variable_by_field.add_new(field, &new_variable);
+        continue;
+      }
       const FieldNode &field_node = field.node();
       switch (field_node.node_type()) {
         case FieldNodeType::Input: {
@@ -269,6 +305,9 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
 
   MFReturnInstruction &return_instr = builder.add_return();
 
+  procedure_optimization::eliminate_common_subexpressions(procedure);
+  procedure_optimization::remove_unused_outputs(procedure);
+  procedure_optimization::fuse_block_calls(procedure);
   procedure_optimization::move_destructs_up(procedure, return_instr);
 
   // std::cout << procedure.to_dot() << "\n";
@@ -362,12 +401,61 @@ Vector<GVArray> evaluate_fields(ResourceScope &scope,
     }
   }
 
+  /* Parts of the varying fields that are the same for all indices are folded into constants. */
+  const VectorSet<GFieldRef> fields_to_fold = find_fields_to_fold(varying_fields);
+  Map<GFieldRef, GPointer> folded_values;
+
+  /* Evaluate constant fields if necessary. */
+  if (!constant_fields_to_evaluate.is_empty() || !fields_to_fold.is_empty()) {
+    Vector<GFieldRef> fields_to_evaluate_once = constant_fields_to_evaluate;
+    fields_to_evaluate_once.extend(fields_to_fold.as_span());
+
+    /* Build the procedure for those fields. */
+    MFProcedure procedure;
+    build_multi_function_procedure_for_fields(
+        procedure, scope, field_tree_info, fields_to_evaluate_once);
+    MFProcedureExecutor procedure_executor{procedure};
+    MFParamsBuilder mf_params{procedure_executor, 1};
+    MFContextBuilder mf_context;
+
+    /* Provide inputs to the procedure executor. */
+    for (const GVArray &varray : field_context_inputs) {
+      mf_params.add_readonly_single_input(varray);
+    }
+
+    for (const int i : fields_to_evaluate_once.index_range()) {
+      const GFieldRef &field = fields_to_evaluate_once[i];
+      const CPPType &type = field.cpp_type();
+      /* Allocate memory where the computed value will be stored in. */
+      void *buffer = scope.linear_allocator().allocate(type.size(), type.alignment());
+
+      if (!type.is_trivially_destructible()) {
+        /* Destruct value in the end. */
+        scope.add_destruct_call([buffer, &type]() { type.destruct(buffer); });
+      }
+
+      /* Pass output buffer to the procedure executor. */
+      mf_params.add_uninitialized_single_output({type, buffer, 1});
+
+      if (i < constant_fields_to_evaluate.size()) {
+        /* Create virtual array that can be used after the procedure has been executed below. */
+        const int out_index = constant_field_indices[i];
+        r_varrays[out_index] = GVArray::ForSingleRef(type, array_size, buffer);
+      }
+      else {
+        folded_values.add(field, {type, buffer});
+      }
+    }
+
+    procedure_executor.call(IndexRange(1), mf_params, mf_context);
+  }
+
   /* Evaluate varying fields if necessary. */
   if (!varying_fields_to_evaluate.is_empty()) {
     /* Build the procedure for those fields. */
     MFProcedure procedure;
     build_multi_function_procedure_for_fields(
-        procedure, scope, field_tree_info, varying_fields_to_evaluate);
+        procedure, scope, field_tree_info, varying_fields_to_evaluate, folded_values);
     MFProcedureExecutor procedure_executor{procedure};
 
     MFParamsBuilder mf_params{procedure_executor, &mask};
@@ -414,43 +502,6 @@ Vector<GVArray> evaluate_fields(ResourceScope &scope,
     procedure_executor.call_auto(mask, mf_params, mf_context);
   }
 
-  /* Evaluate constant fields if necessary. */
-  if (!constant_fields_to_evaluate.is_empty()) {
-    /* Build the procedure for those fields. */
-    MFProcedure procedure;
-    build_multi_function_procedure_for_fields(
-        procedure, scope, field_tree_info, constant_fields_to_evaluate);
-    MFProcedureExecutor procedure_executor{procedure};
-    MFParamsBuilder mf_params{procedure_executor, 1};
-    MFContextBuilder mf_context;
-
-    /* Provide inputs to the procedure executor. */
-    for (const GVArray &varray : field_context_inputs) {
-      mf_params.add_readonly_single_input(varray);
-    }
-
-    for (const int i : constant_fields_to_evaluate.index_range()) {
-      const GFieldRef &field = constant_fields_to_evaluate[i];
-      const CPPType &type = field.cpp_type();
-      /* Allocate memory where the computed value will be stored in. */
-      void *buffer = scope.linear_allocator().allocate(type.size(), type.alignment());
-
-      if (!type.is_trivially_destructible()) {
-        /* Destruct value in the end. */
-        scope.add_destruct_call([buffer, &type]() { type.destruct(buffer); });
-      }
-
-      /* Pass output buffer to the procedure executor. */
-      mf_params.add_uninitialized_single_output({type, buffer, 1});
-
-      /* Create virtual array that can be used after the procedure has been executed below. */
-      const int out_index = constant_field_indices[i];
-      r_varrays[out_index] = GVArray::ForSingleRef(type, array_size, buffer);
-    }
-
-    procedure_executor.call(IndexRange(1), mf_params, mf_context);
-  }
-
   /* Copy data to supplied destination arrays if necessary. In some cases the evaluation above
    * has written the computed data in the right place already. */
   if (!dst_varrays.is_empty()) {
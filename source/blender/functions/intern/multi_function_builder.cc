@@ -40,6 +40,16 @@ void CustomMF_GenericConstant::call(IndexMask mask,
   type_.fill_construct_indices(value_, output.data(), mask);
 }
 
+bool CustomMF_GenericConstant::supports_block_call() const
+{
+  return type_.is_trivial();
+}
+
+void CustomMF_GenericConstant::call_block(const int64_t size, Span<void *> buffers) const
+{
+  type_.fill_construct_n(value_, buffers[0], size);
+}
+
 uint64_t CustomMF_GenericConstant::hash() const
 {
   return type_.hash_or_fallback(value_, (uintptr_t)this);
@@ -54,7 +64,17 @@ bool CustomMF_GenericConstant::equals(const MultiFunction &other) const
   if (type_ != _other->type_) {
     return false;
   }
-  return type_.is_equal(value_, _other->value_);
+  return values_are_equal(type_, value_, _other->value_);
+}
+
+bool CustomMF_GenericConstant::values_are_equal(const CPPType &type,
+                                                const void *a,
+                                                const void *b)
+{
+  if (type.is_trivial()) {
+    return memcmp(a, b, type.size()) == 0;
+  }
+  return type.is_equal_or_false(a, b);
 }
 
 CustomMF_GenericConstantArray::CustomMF_GenericConstantArray(GSpan array) : array_(array)
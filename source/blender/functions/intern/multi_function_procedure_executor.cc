@@ -2,7 +2,9 @@
 
 #include "FN_multi_function_procedure_executor.hh"
 
+#include "BLI_enumerable_thread_specific.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 
 namespace blender::fn {
 
@@ -16,6 +18,26 @@ MFProcedureExecutor::MFProcedureExecutor(const MFProcedure &procedure) : procedu
 
   signature_ = signature.build();
   this->set_signature(&signature_);
+
+  /* Procedures with vector parameters are not split up, because vector arrays can't be sliced. */
+  for (const ConstMFParameter &param : procedure.params()) {
+    if (param.variable->data_type().is_vector()) {
+      return;
+    }
+  }
+  /* Estimate the memory that the variables need per index, to find a chunk size for which the
+   * temporary buffers fit into the L2 cache. This overestimates the memory, because usually only a
+   * few variables are alive at the same time. Vectors are only counted with one element. */
+  int64_t bytes_per_index = 0;
+  for (const MFVariable *variable : procedure.variables()) {
+    const MFDataType data_type = variable->data_type();
+    bytes_per_index += data_type.is_single() ? data_type.single_type().size() :
+                                               data_type.vector_base_type().size();
+  }
+  const int64_t l2_cache_size = 1024 * 1024;
+  chunk_size_ = std::clamp<int64_t>(l2_cache_size / std::max<int64_t>(bytes_per_index, 1),
+                                    min_chunk_size,
+                                    max_chunk_size);
 }
 
 using IndicesSplitVectors = std::array<Vector<int64_t>, 2>;
@@ -134,6 +156,12 @@ class ValueAllocator : NonCopyable, NonMovable {
   /** All buffers in the free-lists below have been allocated with this allocator. */
   LinearAllocator<> &linear_allocator_;
 
+  /**
+   * All span buffers have this number of elements, so that they can be reused for every
+   * execution that uses this allocator.
+   */
+  int64_t span_buffer_size_;
+
   /**
    * Use stacks so that the most recently used buffers are reused first. This improves cache
    * efficiency.
@@ -153,7 +181,8 @@ class ValueAllocator : NonCopyable, NonMovable {
   Stack<void *> variable_state_free_list_;
 
  public:
-  ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator)
+  ValueAllocator(LinearAllocator<> &linear_allocator, const int64_t span_buffer_size)
+      : linear_allocator_(linear_allocator), span_buffer_size_(span_buffer_size)
   {
   }
 
@@ -178,6 +207,8 @@ class ValueAllocator : NonCopyable, NonMovable {
 
   VariableValue_Span *obtain_Span(const CPPType &type, int size)
   {
+    BLI_assert(size <= span_buffer_size_);
+    UNUSED_VARS_NDEBUG(size);
     void *buffer = nullptr;
 
     const int64_t element_size = type.size();
@@ -185,12 +216,12 @@ class ValueAllocator : NonCopyable, NonMovable {
 
     if (alignment > min_alignment) {
       /* In this rare case we fallback to not reusing existing buffers. */
-      buffer = linear_allocator_.allocate(element_size * size, alignment);
+      buffer = linear_allocator_.allocate(element_size * span_buffer_size_, alignment);
     }
     else {
       Stack<void *> *stack = span_buffers_free_list_.lookup_ptr(element_size);
       if (stack == nullptr || stack->is_empty()) {
-        buffer = linear_allocator_.allocate(element_size * size, min_alignment);
+        buffer = linear_allocator_.allocate(element_size * span_buffer_size_, min_alignment);
       }
       else {
         /* Reuse existing buffer. */
@@ -807,13 +838,13 @@ void ValueAllocator::release_variable_state(VariableState *state)
 /** Keeps track of the states of all variables during evaluation. */
 class VariableStates {
  private:
-  ValueAllocator value_allocator_;
+  ValueAllocator &value_allocator_;
   Map<const MFVariable *, VariableState *> variable_states_;
   IndexMask full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator, IndexMask full_mask)
-      : value_allocator_(linear_allocator), full_mask_(full_mask)
+  VariableStates(ValueAllocator &value_allocator, IndexMask full_mask)
+      : value_allocator_(value_allocator), full_mask_(full_mask)
   {
   }
 
@@ -1156,17 +1187,18 @@ class InstructionScheduler {
   }
 };
 
-void MFProcedureExecutor::call(IndexMask full_mask, MFParams params, MFContext context) const
+static void execute_procedure(const MFProcedureExecutor &fn,
+                              const MFProcedure &procedure,
+                              const IndexMask full_mask,
+                              MFParams params,
+                              const MFContext &context,
+                              ValueAllocator &value_allocator)
 {
-  BLI_assert(procedure_.validate());
-
-  LinearAllocator<> linear_allocator;
-
-  VariableStates variable_states{linear_allocator, full_mask};
-  variable_states.add_initial_variable_states(*this, procedure_, params);
+  VariableStates variable_states{value_allocator, full_mask};
+  variable_states.add_initial_variable_states(fn, procedure, params);
 
   InstructionScheduler scheduler;
-  scheduler.add_referenced_indices(*procedure_.entry(), full_mask);
+  scheduler.add_referenced_indices(*procedure.entry(), full_mask);
 
   /* Loop until all indices got to a return instruction. */
   while (NextInstructionInfo instr_info = scheduler.pop_next()) {
@@ -1212,9 +1244,9 @@ void MFProcedureExecutor::call(IndexMask full_mask, MFParams params, MFContext c
     }
   }
 
-  for (const int param_index : this->param_indices()) {
-    const MFParamType param_type = this->param_type(param_index);
-    const MFVariable *variable = procedure_.params()[param_index].variable;
+  for (const int param_index : fn.param_indices()) {
+    const MFParamType param_type = fn.param_type(param_index);
+    const MFVariable *variable = procedure.params()[param_index].variable;
     VariableState &variable_state = variable_states.get_variable_state(*variable);
     switch (param_type.interface_type()) {
       case MFParamType::Input: {
@@ -1235,9 +1267,122 @@ void MFProcedureExecutor::call(IndexMask full_mask, MFParams params, MFContext c
   }
 }
 
+void MFProcedureExecutor::call(IndexMask full_mask, MFParams params, MFContext context) const
+{
+  BLI_assert(procedure_.validate());
+
+  if (chunk_size_ > 0 && full_mask.size() > chunk_size_) {
+    this->call_chunked(full_mask, params, context);
+    return;
+  }
+
+  LinearAllocator<> linear_allocator;
+  ValueAllocator value_allocator{linear_allocator, full_mask.min_array_size()};
+  execute_procedure(*this, procedure_, full_mask, params, context, value_allocator);
+}
+
+void MFProcedureExecutor::call_chunked(const IndexMask full_mask,
+                                       MFParams params,
+                                       const MFContext context) const
+{
+  const int64_t chunks_num = (full_mask.size() + chunk_size_ - 1) / chunk_size_;
+  auto get_chunk_range = [&](const int64_t chunk_index) {
+    const int64_t start = chunk_index * chunk_size_;
+    return IndexRange(start, std::min(chunk_size_, full_mask.size() - start));
+  };
+
+  /* Every chunk is offset so that its indices start at zero. Buffers are reused by all chunks
+   * that run on the same thread, so they have to be large enough for the largest chunk. Sparse
+   * chunks that span more indices get their own buffers, otherwise the buffers of every thread
+   * could become as large as the entire mask. */
+  const int64_t max_reused_span_size = chunk_size_ * max_chunk_span_factor;
+  int64_t reused_span_size = chunk_size_;
+  if (!full_mask.is_range()) {
+    for (const int64_t chunk_index : IndexRange(chunks_num)) {
+      const IndexRange chunk_range = get_chunk_range(chunk_index);
+      const int64_t span_size = full_mask[chunk_range.last()] - full_mask[chunk_range.first()] +
+                                1;
+      reused_span_size = std::max(reused_span_size, std::min(span_size, max_reused_span_size));
+    }
+  }
+
+  struct ThreadLocalAllocators {
+    LinearAllocator<> linear_allocator;
+    std::unique_ptr<ValueAllocator> value_allocator;
+  };
+  threading::EnumerableThreadSpecific<ThreadLocalAllocators> allocators_by_thread;
+
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+    for (const int64_t chunk_index : chunks) {
+      const IndexRange chunk_range = get_chunk_range(chunk_index);
+      const IndexMask sliced_mask = full_mask.slice(chunk_range);
+      const int64_t input_slice_start = sliced_mask[0];
+      const int64_t input_slice_size = sliced_mask.last() - input_slice_start + 1;
+      const IndexRange input_slice_range{input_slice_start, input_slice_size};
+
+      Vector<int64_t> offset_mask_indices;
+      const IndexMask offset_mask = full_mask.slice_and_offset(chunk_range, offset_mask_indices);
+
+      MFParamsBuilder chunk_params{*this, offset_mask.min_array_size()};
+      for (const int param_index : this->param_indices()) {
+        const MFParamType param_type = this->param_type(param_index);
+        switch (param_type.category()) {
+          case MFParamCategory::SingleInput: {
+            const GVArray &varray = params.readonly_single_input(param_index);
+            chunk_params.add_readonly_single_input(varray.slice(input_slice_range));
+            break;
+          }
+          case MFParamCategory::SingleMutable: {
+            const GMutableSpan span = params.single_mutable(param_index);
+            chunk_params.add_single_mutable(span.slice(input_slice_range));
+            break;
+          }
+          case MFParamCategory::SingleOutput: {
+            const GMutableSpan span = params.uninitialized_single_output_if_required(param_index);
+            if (span.is_empty()) {
+              chunk_params.add_ignored_single_output();
+            }
+            else {
+              chunk_params.add_uninitialized_single_output(span.slice(input_slice_range));
+            }
+            break;
+          }
+          case MFParamCategory::VectorInput:
+          case MFParamCategory::VectorMutable:
+          case MFParamCategory::VectorOutput: {
+            BLI_assert_unreachable();
+            break;
+          }
+        }
+      }
+
+      if (input_slice_size > reused_span_size) {
+        LinearAllocator<> linear_allocator;
+        ValueAllocator value_allocator{linear_allocator, input_slice_size};
+        execute_procedure(*this, procedure_, offset_mask, chunk_params, context, value_allocator);
+        continue;
+      }
+
+      ThreadLocalAllocators &allocators = allocators_by_thread.local();
+      if (!allocators.value_allocator) {
+        allocators.value_allocator = std::make_unique<ValueAllocator>(allocators.linear_allocator,
+                                                                      reused_span_size);
+      }
+      execute_procedure(
+          *this, procedure_, offset_mask, chunk_params, context, *allocators.value_allocator);
+    }
+  });
+}
+
 MultiFunction::ExecutionHints MFProcedureExecutor::get_execution_hints() const
 {
   ExecutionHints hints;
+  if (chunk_size_ > 0) {
+    /* The mask is split up into cache friendly chunks in #call already, splitting it up before
+     * would only reduce the reuse of buffers between chunks. */
+    hints.min_grain_size = INT64_MAX;
+    return hints;
+  }
   hints.allocates_array = true;
   hints.min_grain_size = 10000;
   return hints;
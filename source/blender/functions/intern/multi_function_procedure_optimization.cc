@@ -2,8 +2,94 @@
 
 #include "FN_multi_function_procedure_optimization.hh"
 
+#include "BLI_array.hh"
+#include "BLI_linear_allocator.hh"
+#include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
+#include "BLI_vector_set.hh"
+
 namespace blender::fn::procedure_optimization {
 
+/**
+ * Remove an instruction that has a single successor from the procedure. All instructions that
+ * pointed to it point to its successor afterwards.
+ */
+static void remove_instruction(MFProcedure &procedure,
+                               MFInstruction &instruction,
+                               MFInstruction *next_instr)
+{
+  while (!instruction.prev().is_empty()) {
+    /* Do a copy of the cursor here, because `instruction.prev()` changes when #set_next is called
+     * below. */
+    const MFInstructionCursor cursor = instruction.prev()[0];
+    cursor.set_next(procedure, next_instr);
+  }
+  procedure.delete_instruction(instruction);
+}
+
+static void remove_destruct_instruction(MFProcedure &procedure, MFDestructInstruction &instruction)
+{
+  remove_instruction(procedure, instruction, instruction.next());
+}
+
+static void remove_call_instruction(MFProcedure &procedure, MFCallInstruction &instruction)
+{
+  remove_instruction(procedure, instruction, instruction.next());
+}
+
+/** Remove a variable that is only used by destruct instructions, together with them. */
+static void remove_variable_and_destructs(MFProcedure &procedure, MFVariable &variable)
+{
+  const Vector<MFInstruction *> users = variable.users();
+  for (MFInstruction *user : users) {
+    BLI_assert(user->type() == MFInstructionType::Destruct);
+    remove_destruct_instruction(procedure, static_cast<MFDestructInstruction &>(*user));
+  }
+  procedure.delete_variable(variable);
+}
+
+static bool variable_is_parameter(const MFProcedure &procedure, const MFVariable &variable)
+{
+  return std::any_of(
+      procedure.params().begin(), procedure.params().end(), [&](const ConstMFParameter &param) {
+        return param.variable == &variable;
+      });
+}
+
+/**
+ * Find the calls in the chain of instructions that starts at the entry of the procedure, up to the
+ * first branch or return instruction.
+ */
+static Vector<MFCallInstruction *> find_calls_in_entry_chain(MFProcedure &procedure)
+{
+  Vector<MFCallInstruction *> calls;
+  MFInstruction *current_instr = procedure.entry();
+  while (current_instr != nullptr) {
+    switch (current_instr->type()) {
+      case MFInstructionType::Call: {
+        MFCallInstruction &call_instr = static_cast<MFCallInstruction &>(*current_instr);
+        calls.append(&call_instr);
+        current_instr = call_instr.next();
+        break;
+      }
+      case MFInstructionType::Destruct: {
+        current_instr = static_cast<MFDestructInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Dummy: {
+        current_instr = static_cast<MFDummyInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Branch:
+      case MFInstructionType::Return: {
+        current_instr = nullptr;
+        break;
+      }
+    }
+  }
+  return calls;
+}
+
 void move_destructs_up(MFProcedure &procedure, MFInstruction &block_end_instr)
 {
   /* A mapping from a variable to its destruct instruction. */
@@ -73,4 +159,699 @@ void move_destructs_up(MFProcedure &procedure, MFInstruction &block_end_instr)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Eliminate Common Subexpressions
+ * \{ */
+
+static bool call_has_mutable_params(const MFCallInstruction &call)
+{
+  const MultiFunction &fn = call.fn();
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).interface_type() == MFParamType::Mutable) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static uint64_t hash_call(const MFCallInstruction &call)
+{
+  const MultiFunction &fn = call.fn();
+  uint64_t hash = fn.hash();
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).interface_type() == MFParamType::Input) {
+      hash = get_default_hash_2(hash, call.params()[param_index]);
+    }
+  }
+  return hash;
+}
+
+static bool functions_are_equal(const MultiFunction &a, const MultiFunction &b)
+{
+  return &a == &b || a.equals(b);
+}
+
+static bool calls_compute_same_values(const MFCallInstruction &a, const MFCallInstruction &b)
+{
+  const MultiFunction &fn = a.fn();
+  if (!functions_are_equal(fn, b.fn())) {
+    return false;
+  }
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).interface_type() == MFParamType::Input) {
+      if (a.params()[param_index] != b.params()[param_index]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/** Find the destruct instructions in the linear chain after the given call. */
+static Vector<MFDestructInstruction *> find_later_destructs(MFCallInstruction &call_instr)
+{
+  Vector<MFDestructInstruction *> destructs;
+  MFInstruction *current_instr = call_instr.next();
+  while (current_instr != nullptr) {
+    switch (current_instr->type()) {
+      case MFInstructionType::Call: {
+        current_instr = static_cast<MFCallInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Destruct: {
+        MFDestructInstruction *destruct_instr = static_cast<MFDestructInstruction *>(
+            current_instr);
+        destructs.append(destruct_instr);
+        current_instr = destruct_instr->next();
+        break;
+      }
+      case MFInstructionType::Dummy: {
+        current_instr = static_cast<MFDummyInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Branch:
+      case MFInstructionType::Return: {
+        current_instr = nullptr;
+        break;
+      }
+    }
+  }
+  return destructs;
+}
+
+/**
+ * Returns the index of the only destruct instruction of the variable in the given destructs, or
+ * -1 when the variable is destructed somewhere else or more than once.
+ */
+static int64_t find_only_destruct(MFVariable &variable,
+                                  const Span<MFDestructInstruction *> destructs)
+{
+  int64_t destructs_num = 0;
+  for (const MFInstruction *user : variable.users()) {
+    destructs_num += int(user->type() == MFInstructionType::Destruct);
+  }
+  if (destructs_num != 1) {
+    return -1;
+  }
+  for (const int64_t i : destructs.index_range()) {
+    if (destructs[i]->variable() == &variable) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Use the outputs of \a earlier_call instead of the outputs of \a call_instr, which is removed.
+ * Returns false when that's not possible, because the lifetime of the variables could not be
+ * merged. Otherwise \a r_next_instr is set to the instruction that came after the removed call.
+ */
+static bool try_replace_call(MFProcedure &procedure,
+                             MFCallInstruction &call_instr,
+                             MFCallInstruction &earlier_call,
+                             MFInstruction *&r_next_instr)
+{
+  const MultiFunction &fn = call_instr.fn();
+  struct ReplacedVariable {
+    MFVariable *variable;
+    MFVariable *earlier_variable;
+    /** The destruct instruction of the variable that is kept, if any. */
+    MFDestructInstruction *kept_destruct;
+    MFDestructInstruction *removed_destruct;
+  };
+  Vector<ReplacedVariable> replaced_variables;
+  const Vector<MFDestructInstruction *> later_destructs = find_later_destructs(call_instr);
+
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).interface_type() != MFParamType::Output) {
+      continue;
+    }
+    MFVariable *variable = call_instr.params()[param_index];
+    MFVariable *earlier_variable = earlier_call.params()[param_index];
+    if (variable == nullptr) {
+      continue;
+    }
+    if (earlier_variable == nullptr) {
+      /* The earlier call did not compute this output. */
+      return false;
+    }
+    if (variable_is_parameter(procedure, *variable)) {
+      /* Every output parameter needs its own variable. */
+      return false;
+    }
+    const int64_t destruct_index = find_only_destruct(*variable, later_destructs);
+    if (destruct_index == -1) {
+      return false;
+    }
+    if (variable_is_parameter(procedure, *earlier_variable)) {
+      /* The earlier variable is never destructed. */
+      replaced_variables.append(
+          {variable, earlier_variable, nullptr, later_destructs[destruct_index]});
+      continue;
+    }
+    const int64_t earlier_destruct_index = find_only_destruct(*earlier_variable, later_destructs);
+    if (earlier_destruct_index == -1) {
+      return false;
+    }
+    /* Keep the destruct instruction that comes later, so that the earlier variable lives as long
+     * as both variables did before. */
+    if (earlier_destruct_index < destruct_index) {
+      replaced_variables.append({variable,
+                                 earlier_variable,
+                                 later_destructs[destruct_index],
+                                 later_destructs[earlier_destruct_index]});
+    }
+    else {
+      replaced_variables.append({variable,
+                                 earlier_variable,
+                                 later_destructs[earlier_destruct_index],
+                                 later_destructs[destruct_index]});
+    }
+  }
+
+  for (const ReplacedVariable &replaced : replaced_variables) {
+    remove_destruct_instruction(procedure, *replaced.removed_destruct);
+    if (replaced.kept_destruct != nullptr) {
+      replaced.kept_destruct->set_variable(replaced.earlier_variable);
+    }
+  }
+  r_next_instr = call_instr.next();
+  remove_call_instruction(procedure, call_instr);
+
+  for (const ReplacedVariable &replaced : replaced_variables) {
+    const Vector<MFInstruction *> users = replaced.variable->users();
+    for (MFInstruction *user : users) {
+      switch (user->type()) {
+        case MFInstructionType::Call: {
+          MFCallInstruction &user_call = static_cast<MFCallInstruction &>(*user);
+          for (const int param_index : user_call.params().index_range()) {
+            if (user_call.params()[param_index] == replaced.variable) {
+              user_call.set_param_variable(param_index, replaced.earlier_variable);
+            }
+          }
+          break;
+        }
+        case MFInstructionType::Branch: {
+          static_cast<MFBranchInstruction &>(*user).set_condition(replaced.earlier_variable);
+          break;
+        }
+        case MFInstructionType::Destruct:
+        case MFInstructionType::Dummy:
+        case MFInstructionType::Return: {
+          BLI_assert_unreachable();
+          break;
+        }
+      }
+    }
+    procedure.delete_variable(*replaced.variable);
+  }
+  return true;
+}
+
+void eliminate_common_subexpressions(MFProcedure &procedure)
+{
+  /* Calls whose outputs can still be used by later instructions, grouped by their hash. */
+  MultiValueMap<uint64_t, MFCallInstruction *> available_calls;
+  /* Calls whose inputs or outputs changed since they were executed. */
+  Set<const MFInstruction *> outdated_calls;
+  auto variable_changed = [&](MFVariable &variable) {
+    for (const MFInstruction *user : variable.users()) {
+      if (user->type() == MFInstructionType::Call) {
+        outdated_calls.add(user);
+      }
+    }
+  };
+
+  MFInstruction *current_instr = procedure.entry();
+  while (current_instr != nullptr) {
+    switch (current_instr->type()) {
+      case MFInstructionType::Call: {
+        MFCallInstruction &call_instr = static_cast<MFCallInstruction &>(*current_instr);
+        if (call_has_mutable_params(call_instr)) {
+          for (const int param_index : call_instr.params().index_range()) {
+            if (call_instr.fn().param_type(param_index).interface_type() ==
+                MFParamType::Mutable) {
+              variable_changed(*call_instr.params()[param_index]);
+            }
+          }
+          current_instr = call_instr.next();
+          break;
+        }
+        const uint64_t hash = hash_call(call_instr);
+        MFInstruction *next_instr = nullptr;
+        bool is_replaced = false;
+        for (MFCallInstruction *available_call : available_calls.lookup(hash)) {
+          if (outdated_calls.contains(available_call) ||
+              !calls_compute_same_values(call_instr, *available_call)) {
+            continue;
+          }
+          is_replaced = try_replace_call(procedure, call_instr, *available_call, next_instr);
+          break;
+        }
+        if (!is_replaced) {
+          available_calls.add(hash, &call_instr);
+          next_instr = call_instr.next();
+        }
+        current_instr = next_instr;
+        break;
+      }
+      case MFInstructionType::Destruct: {
+        MFDestructInstruction &destruct_instr = static_cast<MFDestructInstruction &>(
+            *current_instr);
+        variable_changed(*destruct_instr.variable());
+        current_instr = destruct_instr.next();
+        break;
+      }
+      case MFInstructionType::Dummy: {
+        current_instr = static_cast<MFDummyInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Branch:
+      case MFInstructionType::Return: {
+        current_instr = nullptr;
+        break;
+      }
+    }
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Remove Unused Outputs
+ * \{ */
+
+static bool variable_is_used(const MFProcedure &procedure,
+                             MFVariable &variable,
+                             const MFInstruction &initializing_instr)
+{
+  if (variable_is_parameter(procedure, variable)) {
+    return true;
+  }
+  return std::any_of(
+      variable.users().begin(), variable.users().end(), [&](const MFInstruction *user) {
+        return user != &initializing_instr && user->type() != MFInstructionType::Destruct;
+      });
+}
+
+void remove_unused_outputs(MFProcedure &procedure)
+{
+  const Vector<MFCallInstruction *> calls = find_calls_in_entry_chain(procedure);
+  /* Iterate backwards, so that the inputs of removed calls can be removed as well. */
+  for (int64_t i = calls.size() - 1; i >= 0; i--) {
+    MFCallInstruction *call_instr = calls[i];
+    if (call_has_mutable_params(*call_instr)) {
+      continue;
+    }
+    const MultiFunction &fn = call_instr->fn();
+    bool has_outputs = false;
+    bool has_used_outputs = false;
+    for (const int param_index : fn.param_indices()) {
+      const MFParamType param_type = fn.param_type(param_index);
+      if (param_type.interface_type() != MFParamType::Output) {
+        continue;
+      }
+      has_outputs = true;
+      if (param_type.category() != MFParamCategory::SingleOutput) {
+        /* Only single outputs may be ignored by the called function, vector outputs are always
+         * computed. Keep them and the call. */
+        has_used_outputs = true;
+        continue;
+      }
+      MFVariable *variable = call_instr->params()[param_index];
+      if (variable == nullptr) {
+        continue;
+      }
+      if (variable_is_used(procedure, *variable, *call_instr)) {
+        has_used_outputs = true;
+        continue;
+      }
+      call_instr->set_param_variable(param_index, nullptr);
+      remove_variable_and_destructs(procedure, *variable);
+    }
+    if (has_outputs && !has_used_outputs) {
+      remove_call_instruction(procedure, *call_instr);
+    }
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Fuse Block Calls
+ * \{ */
+
+/**
+ * Executes multiple functions that support #MultiFunction::call_block one after another on small
+ * blocks of elements. Every value is stored in a slot. The first slots are the inputs of the fused
+ * function, the other slots are outputs of the fused functions.
+ */
+class FusedBlockFunction : public MultiFunction {
+ public:
+  struct Step {
+    const MultiFunction *fn;
+    /** The slot for every parameter of the function. */
+    Vector<int> slots;
+    /**
+     * The step has no inputs and all its outputs are only used within the fused function. So it
+     * only has to be computed once for all blocks.
+     */
+    bool is_constant = false;
+  };
+
+ private:
+  Vector<const CPPType *> slot_types_;
+  int inputs_num_;
+  /** The slot for every output parameter. */
+  Vector<int> output_slots_;
+  Vector<Step> steps_;
+  /** Chosen so that the buffers for all slots fit into the L1 cache. */
+  int64_t max_block_size_;
+  MFSignature signature_;
+
+ public:
+  FusedBlockFunction(Vector<const CPPType *> slot_types,
+                     const int inputs_num,
+                     Vector<int> output_slots,
+                     Vector<Step> steps)
+      : slot_types_(std::move(slot_types)),
+        inputs_num_(inputs_num),
+        output_slots_(std::move(output_slots)),
+        steps_(std::move(steps))
+  {
+    MFSignatureBuilder signature{"Fused"};
+    for (const int slot : IndexRange(inputs_num_)) {
+      signature.single_input("Value", *slot_types_[slot]);
+    }
+    for (const int slot : output_slots_) {
+      signature.single_output("Value", *slot_types_[slot]);
+    }
+    signature_ = signature.build();
+    this->set_signature(&signature_);
+
+    for (Step &step : steps_) {
+      /* Steps that read other slots have to run for every block, even when those slots are only
+       * used within the fused function. */
+      const MultiFunction &fn = *step.fn;
+      const bool has_inputs = std::any_of(
+          fn.param_indices().begin(), fn.param_indices().end(), [&](const int param_index) {
+            return fn.param_type(param_index).interface_type() == MFParamType::Input;
+          });
+      step.is_constant = !has_inputs &&
+                         std::none_of(step.slots.begin(), step.slots.end(), [&](const int slot) {
+                           return output_slots_.contains(slot);
+                         });
+    }
+
+    int64_t element_size = 0;
+    for (const CPPType *type : slot_types_) {
+      element_size += type->size();
+    }
+    max_block_size_ = std::clamp<int64_t>(
+        16 * 1024 / std::max<int64_t>(element_size, 1), 64, 1024);
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext UNUSED(context)) const override
+  {
+    if (mask.is_empty()) {
+      return;
+    }
+    const int64_t block_size = std::min(max_block_size_, mask.size());
+
+    LinearAllocator<> allocator;
+    Array<void *, 16> block_buffers(slot_types_.size());
+    for (const int slot : slot_types_.index_range()) {
+      const CPPType &type = *slot_types_[slot];
+      block_buffers[slot] = allocator.allocate(type.size() * block_size, type.alignment());
+    }
+    /* Points to the data of every slot in the current block. Outputs and inputs can reference the
+     * arrays of the caller directly when the block is a range. */
+    Array<void *, 16> slot_buffers = block_buffers;
+
+    Array<const GVArray *, 16> inputs(inputs_num_);
+    /* Data of inputs that are spans, otherwise null. */
+    Array<const void *, 16> input_span_data(inputs_num_, nullptr);
+    for (const int i : IndexRange(inputs_num_)) {
+      const GVArray &varray = params.readonly_single_input(i);
+      inputs[i] = &varray;
+      if (varray.is_single()) {
+        /* Single values are the same for every block. */
+        const CPPType &type = varray.type();
+        BUFFER_FOR_CPP_TYPE_VALUE(type, value);
+        varray.get_internal_single(value);
+        type.fill_construct_n(value, block_buffers[i], block_size);
+        type.destruct(value);
+        inputs[i] = nullptr;
+      }
+      else if (varray.is_span()) {
+        input_span_data[i] = varray.get_internal_span().data();
+      }
+    }
+    Vector<GMutableSpan, 16> outputs;
+    for (const int i : output_slots_.index_range()) {
+      outputs.append(params.uninitialized_single_output_if_required(inputs_num_ + i));
+    }
+
+    for (const Step &step : steps_) {
+      if (step.is_constant) {
+        this->call_step(step, block_size, slot_buffers);
+      }
+    }
+
+    for (int64_t start = 0; start < mask.size(); start += block_size) {
+      const IndexMask block_mask = mask.slice(start, std::min(block_size, mask.size() - start));
+      const int64_t size = block_mask.size();
+      const bool is_range = block_mask.is_range();
+
+      for (const int i : IndexRange(inputs_num_)) {
+        if (inputs[i] == nullptr) {
+          continue;
+        }
+        const CPPType &type = *slot_types_[i];
+        if (input_span_data[i] == nullptr) {
+          inputs[i]->materialize_compressed_to_uninitialized(block_mask, block_buffers[i]);
+          slot_buffers[i] = block_buffers[i];
+        }
+        else if (is_range) {
+          slot_buffers[i] = const_cast<void *>(
+              POINTER_OFFSET(input_span_data[i], block_mask[0] * type.size()));
+        }
+        else {
+          type.copy_construct_compressed(input_span_data[i], block_buffers[i], block_mask);
+          slot_buffers[i] = block_buffers[i];
+        }
+      }
+      for (const int i : output_slots_.index_range()) {
+        const int slot = output_slots_[i];
+        slot_buffers[slot] = (is_range && !outputs[i].is_empty()) ?
+                                 outputs[i][block_mask[0]] :
+                                 block_buffers[slot];
+      }
+
+      for (const Step &step : steps_) {
+        if (!step.is_constant) {
+          this->call_step(step, size, slot_buffers);
+        }
+      }
+
+      if (!is_range) {
+        for (const int i : output_slots_.index_range()) {
+          if (!outputs[i].is_empty()) {
+            scatter(block_buffers[output_slots_[i]], outputs[i], block_mask);
+          }
+        }
+      }
+    }
+  }
+
+  std::string debug_name() const override
+  {
+    std::string name = "Fused (";
+    for (const int i : steps_.index_range()) {
+      name += steps_[i].fn->debug_name();
+      if (i < steps_.size() - 1) {
+        name += ", ";
+      }
+    }
+    return name + ")";
+  }
+
+ private:
+  static void call_step(const Step &step, const int64_t size, Span<void *> slot_buffers)
+  {
+    Vector<void *, 16> buffers;
+    for (const int slot : step.slots) {
+      buffers.append(slot_buffers[slot]);
+    }
+    step.fn->call_block(size, buffers);
+  }
+
+  /** All slot types are trivially copyable, see #MultiFunction::supports_block_call. */
+  static void scatter(const void *src, GMutableSpan dst, const IndexMask mask)
+  {
+    const int64_t type_size = dst.type().size();
+    for (const int64_t i : mask.index_range()) {
+      memcpy(POINTER_OFFSET(dst.data(), mask[i] * type_size),
+             POINTER_OFFSET(src, i * type_size),
+             size_t(type_size));
+    }
+  }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    for (const Step &step : steps_) {
+      const ExecutionHints step_hints = step.fn->execution_hints();
+      hints.min_grain_size = std::min(hints.min_grain_size, step_hints.min_grain_size);
+      hints.uniform_execution_time &= step_hints.uniform_execution_time;
+    }
+    return hints;
+  }
+};
+
+static void fuse_calls(MFProcedure &procedure, Span<MFCallInstruction *> calls)
+{
+  Set<const MFInstruction *> fused_instructions;
+  for (const MFCallInstruction *call : calls) {
+    fused_instructions.add_new(call);
+  }
+
+  /* Variables that are used by the calls but are not initialized by them become inputs. */
+  VectorSet<MFVariable *> input_variables;
+  Set<MFVariable *> initialized_variables;
+  for (MFCallInstruction *call : calls) {
+    const MultiFunction &fn = call->fn();
+    for (const int param_index : fn.param_indices()) {
+      MFVariable *variable = call->params()[param_index];
+      if (fn.param_type(param_index).interface_type() == MFParamType::Input) {
+        if (!initialized_variables.contains(variable)) {
+          input_variables.add(variable);
+        }
+      }
+      else if (variable != nullptr) {
+        BLI_assert(fn.param_type(param_index).interface_type() == MFParamType::Output);
+        if (!initialized_variables.add(variable)) {
+          /* Variables that are initialized more than once are not handled. */
+          return;
+        }
+      }
+    }
+  }
+
+  Vector<const CPPType *> slot_types;
+  Map<const MFVariable *, int> slot_by_variable;
+  for (MFVariable *variable : input_variables) {
+    slot_by_variable.add_new(variable, slot_types.append_and_get_index(
+                                           &variable->data_type().single_type()));
+  }
+
+  Vector<FusedBlockFunction::Step> steps;
+  Vector<MFVariable *> output_variables;
+  Vector<int> output_slots;
+  Vector<MFVariable *> internal_variables;
+  for (MFCallInstruction *call : calls) {
+    const MultiFunction &fn = call->fn();
+    FusedBlockFunction::Step step{&fn};
+    for (const int param_index : fn.param_indices()) {
+      MFVariable *variable = call->params()[param_index];
+      const MFParamType param_type = fn.param_type(param_index);
+      if (param_type.interface_type() == MFParamType::Input) {
+        step.slots.append(slot_by_variable.lookup(variable));
+        continue;
+      }
+      /* Ignored outputs still get a slot, because the function writes to it. */
+      const int slot = slot_types.append_and_get_index(&param_type.data_type().single_type());
+      step.slots.append(slot);
+      if (variable == nullptr) {
+        continue;
+      }
+      slot_by_variable.add_new(variable, slot);
+      const bool is_parameter = variable_is_parameter(procedure, *variable);
+      const bool used_elsewhere = std::any_of(
+          variable->users().begin(), variable->users().end(), [&](const MFInstruction *user) {
+            return !fused_instructions.contains(user) &&
+                   user->type() != MFInstructionType::Destruct;
+          });
+      if (is_parameter || used_elsewhere) {
+        output_variables.append(variable);
+        output_slots.append(slot);
+      }
+      else {
+        internal_variables.append(variable);
+      }
+    }
+    steps.append(std::move(step));
+  }
+
+  const MultiFunction &fused_fn = procedure.construct_function<FusedBlockFunction>(
+      std::move(slot_types), input_variables.size(), std::move(output_slots), std::move(steps));
+  MFCallInstruction &fused_call = procedure.new_call_instruction(fused_fn);
+  Vector<MFVariable *> fused_params;
+  fused_params.extend(input_variables.as_span());
+  fused_params.extend(output_variables);
+  fused_call.set_params(fused_params);
+
+  /* Replace the calls with the fused call. */
+  fused_call.set_next(calls.last()->next());
+  remove_instruction(procedure, *calls.first(), &fused_call);
+  for (MFCallInstruction *call : calls.drop_front(1)) {
+    procedure.delete_instruction(*call);
+  }
+
+  /* Intermediate variables only exist within the fused function now. */
+  for (MFVariable *variable : internal_variables) {
+    remove_variable_and_destructs(procedure, *variable);
+  }
+}
+
+void fuse_block_calls(MFProcedure &procedure)
+{
+  /* Find all chains of consecutive calls that can be fused first, because fusing them deletes
+   * instructions. */
+  Vector<Vector<MFCallInstruction *>> call_chains;
+  Vector<MFCallInstruction *> current_chain;
+  MFInstruction *current_instr = procedure.entry();
+  while (current_instr != nullptr) {
+    MFInstruction *next_instr = nullptr;
+    switch (current_instr->type()) {
+      case MFInstructionType::Call: {
+        MFCallInstruction &call_instr = static_cast<MFCallInstruction &>(*current_instr);
+        if (call_instr.fn().supports_block_call()) {
+          current_chain.append(&call_instr);
+          current_instr = call_instr.next();
+          continue;
+        }
+        next_instr = call_instr.next();
+        break;
+      }
+      case MFInstructionType::Destruct: {
+        next_instr = static_cast<MFDestructInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Dummy: {
+        next_instr = static_cast<MFDummyInstruction *>(current_instr)->next();
+        break;
+      }
+      case MFInstructionType::Branch:
+      case MFInstructionType::Return: {
+        break;
+      }
+    }
+    if (current_chain.size() >= 2) {
+      call_chains.append(std::move(current_chain));
+    }
+    current_chain.clear();
+    current_instr = next_instr;
+  }
+  if (current_chain.size() >= 2) {
+    call_chains.append(std::move(current_chain));
+  }
+
+  for (const Vector<MFCallInstruction *> &chain : call_chains) {
+    fuse_calls(procedure, chain);
+  }
+}
+
+/** \} */
+
 }  // namespace blender::fn::procedure_optimization
@@ -2,6 +2,8 @@
 
 #include "testing/testing.h"
 
+#include <atomic>
+
 #include "BLI_cpp_type.hh"
 #include "FN_field.hh"
 #include "FN_multi_function_builder.hh"
@@ -289,4 +291,69 @@ TEST(field, IgnoredOutput)
   EXPECT_EQ(results.get(3), 5);
 }
 
+TEST(field, ConstantSubtreeIsFolded)
+{
+  std::atomic<int64_t> square_calls = 0;
+  const int value = 3;
+  GField constant_field{std::make_shared<FieldConstant>(CPPType::get<int>(), &value)};
+  GField square_field{std::make_shared<FieldOperation>(
+                          std::make_unique<CustomMF_SI_SO<int, int>>("square",
+                                                                     [&](int a) {
+                                                                       square_calls++;
+                                                                       return a * a;
+                                                                     }),
+                          Vector<GField>{constant_field}),
+                      0};
+  GField index_field{std::make_shared<IndexFieldInput>()};
+  GField output_field{
+      std::make_shared<FieldOperation>(std::make_unique<CustomMF_SI_SI_SO<int, int, int>>(
+                                           "add", [](int a, int b) { return a + b; }),
+                                       Vector<GField>{index_field, square_field}),
+      0};
+
+  /* Use a mask that is larger than a chunk of the procedure executor. */
+  const int64_t size = 100000;
+  Array<int> result(size);
+  FieldContext context;
+  const IndexMask mask{IndexRange(size)};
+  FieldEvaluator evaluator{context, &mask};
+  evaluator.add_with_destination(output_field, result.as_mutable_span());
+  evaluator.evaluate();
+
+  EXPECT_EQ(square_calls, 1);
+  EXPECT_EQ(result[0], 9);
+  EXPECT_EQ(result[size - 1], size - 1 + 9);
+}
+
+TEST(field, CommonSubexpressionsAreEvaluatedOnce)
+{
+  std::atomic<int64_t> add_calls = 0;
+  std::shared_ptr<MultiFunction> add_fn = std::make_shared<CustomMF_SI_SI_SO<int, int, int>>(
+      "add", [&](int a, int b) {
+        add_calls++;
+        return a + b;
+      });
+  /* Two separate nodes that compute the same value, with two separate but equal index inputs. */
+  GField index_field_1{std::make_shared<fn::IndexFieldInput>()};
+  GField index_field_2{std::make_shared<fn::IndexFieldInput>()};
+  GField sum_field_1{
+      std::make_shared<FieldOperation>(add_fn, Vector<GField>{index_field_1, index_field_1}), 0};
+  GField sum_field_2{
+      std::make_shared<FieldOperation>(add_fn, Vector<GField>{index_field_2, index_field_2}), 0};
+  GField output_field{
+      std::make_shared<FieldOperation>(add_fn, Vector<GField>{sum_field_1, sum_field_2}), 0};
+
+  const int64_t size = 100;
+  Array<int> result(size);
+  FieldContext context;
+  const IndexMask mask{IndexRange(size)};
+  FieldEvaluator evaluator{context, &mask};
+  evaluator.add_with_destination(output_field, result.as_mutable_span());
+  evaluator.evaluate();
+
+  EXPECT_EQ(add_calls, size * 2);
+  EXPECT_EQ(result[0], 0);
+  EXPECT_EQ(result[10], 40);
+}
+
 }  // namespace blender::fn::tests
@@ -5,6 +5,7 @@
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_procedure_builder.hh"
 #include "FN_multi_function_procedure_executor.hh"
+#include "FN_multi_function_procedure_optimization.hh"
 #include "FN_multi_function_test_common.hh"
 
 namespace blender::fn::tests {
@@ -408,4 +409,297 @@ TEST(multi_function_procedure, OutputBufferReplaced)
   EXPECT_EQ(output[2], output_value);
 }
 
+TEST(multi_function_procedure, ChunkedExecution)
+{
+  /**
+   * procedure(int &var1, bool var2, int *var3) {
+   *   if (var2) {
+   *     var1 += 100;
+   *   }
+   *   var3 = var1 + 10;
+   * }
+   */
+
+  CustomMF_SM<int> add_100_fn{"add_100", [](int &a) { a += 100; }};
+  CustomMF_SI_SO<int, int> add_10_fn{"add 10", [](int a) { return a + 10; }};
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var1 = &builder.add_single_mutable_parameter<int>();
+  MFVariable *var2 = &builder.add_single_input_parameter<bool>();
+
+  MFProcedureBuilder::Branch branch = builder.add_branch(*var2);
+  branch.branch_true.add_call(add_100_fn, {var1});
+  builder.set_cursor_after_branch(branch);
+  auto [var3] = builder.add_call<1>(add_10_fn, {var1});
+  builder.add_destruct({var2});
+  builder.add_return();
+  builder.add_output_parameter(*var3);
+
+  EXPECT_TRUE(procedure.validate());
+
+  MFProcedureExecutor procedure_fn{procedure};
+
+  /* Use more indices than fit into a single chunk. */
+  const int64_t size = MFProcedureExecutor::max_chunk_size * 5 + 7;
+  Vector<int64_t> every_third_index;
+  for (int64_t i = 0; i < size; i += 3) {
+    every_third_index.append(i);
+  }
+
+  /* Too sparse to reuse the buffers of other chunks. */
+  Vector<int64_t> sparse_indices;
+  for (int64_t i = 0; i < size; i += (i < MFProcedureExecutor::max_chunk_size * 2) ? 1 : 64) {
+    sparse_indices.append(i);
+  }
+
+  for (const IndexMask mask :
+       {IndexMask(size), IndexMask(every_third_index), IndexMask(sparse_indices)}) {
+    Array<int> values_a(size);
+    Array<bool> values_cond(size);
+    for (const int64_t i : IndexRange(size)) {
+      values_a[i] = int(i);
+      values_cond[i] = i % 2 == 0;
+    }
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(procedure_fn, size);
+    params.add_single_mutable(values_a.as_mutable_span());
+    params.add_readonly_single_input(values_cond.as_span());
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+    procedure_fn.call(mask, params, context);
+
+    Array<bool> in_mask(size, false);
+    mask.foreach_index([&](const int64_t i) { in_mask[i] = true; });
+    for (const int64_t i : IndexRange(size)) {
+      if (in_mask[i]) {
+        const int expected = int(i) + (i % 2 == 0 ? 100 : 0);
+        EXPECT_EQ(values_a[i], expected);
+        EXPECT_EQ(results[i], expected + 10);
+      }
+      else {
+        EXPECT_EQ(values_a[i], int(i));
+        EXPECT_EQ(results[i], -1);
+      }
+    }
+  }
+}
+
+TEST(multi_function_procedure, EliminateCommonSubexpressions)
+{
+  /**
+   * procedure(int a, int *out) {
+   *   int b = a + 10;
+   *   int c = a + 10;
+   *   destruct b;
+   *   out = c + c;
+   *   destruct a;
+   *   destruct c;
+   * }
+   */
+
+  CustomMF_SI_SO<int, int> add_10_fn{"add 10", [](int a) { return a + 10; }};
+  CustomMF_SI_SI_SO<int, int, int> add_fn{"add", [](int a, int b) { return a + b; }};
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var_a = &builder.add_single_input_parameter<int>();
+  auto [var_b] = builder.add_call<1>(add_10_fn, {var_a});
+  auto [var_c] = builder.add_call<1>(add_10_fn, {var_a});
+  builder.add_destruct(*var_b);
+  auto [var_out] = builder.add_call<1>(add_fn, {var_c, var_c});
+  builder.add_destruct({var_a, var_c});
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+
+  EXPECT_TRUE(procedure.validate());
+  procedure_optimization::eliminate_common_subexpressions(procedure);
+  /* The second call is removed, and the first variable lives until the end. */
+  EXPECT_TRUE(procedure.validate());
+  EXPECT_EQ(procedure.variables().size(), 3);
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<int> inputs = {1, 2, 3};
+  Array<int> results(3, -1);
+  MFParamsBuilder params{procedure_fn, 3};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(3), params, context);
+
+  EXPECT_EQ(results[0], 22);
+  EXPECT_EQ(results[1], 24);
+  EXPECT_EQ(results[2], 26);
+}
+
+TEST(multi_function_procedure, RemoveUnusedOutputs)
+{
+  /**
+   * procedure(int a, int *out) {
+   *   int b = a + 10;
+   *   int c = b + 10;
+   *   out = a + 10;
+   *   destruct a;
+   *   destruct b;
+   *   destruct c;
+   * }
+   */
+
+  CustomMF_SI_SO<int, int> add_10_fn{"add 10", [](int a) { return a + 10; }};
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var_a = &builder.add_single_input_parameter<int>();
+  auto [var_b] = builder.add_call<1>(add_10_fn, {var_a});
+  auto [var_c] = builder.add_call<1>(add_10_fn, {var_b});
+  auto [var_out] = builder.add_call<1>(add_10_fn, {var_a});
+  builder.add_destruct({var_a, var_b, var_c});
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+
+  EXPECT_TRUE(procedure.validate());
+  procedure_optimization::remove_unused_outputs(procedure);
+  EXPECT_TRUE(procedure.validate());
+  /* Only the input and output variables remain. */
+  EXPECT_EQ(procedure.variables().size(), 2);
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<int> inputs = {1, 2};
+  Array<int> results(2, -1);
+  MFParamsBuilder params{procedure_fn, 2};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(2), params, context);
+
+  EXPECT_EQ(results[0], 11);
+  EXPECT_EQ(results[1], 12);
+}
+
+TEST(multi_function_procedure, RemoveUnusedOutputsKeepsVectorOutputs)
+{
+  /**
+   * procedure(int a, int *out) {
+   *   int[] range = create_range(a);
+   *   out = a + 10;
+   *   destruct a;
+   *   destruct range;
+   * }
+   */
+
+  CreateRangeFunction create_range_fn;
+  CustomMF_SI_SO<int, int> add_10_fn{"add 10", [](int a) { return a + 10; }};
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var_a = &builder.add_single_input_parameter<int>();
+  auto [var_range] = builder.add_call<1>(create_range_fn, {var_a});
+  auto [var_out] = builder.add_call<1>(add_10_fn, {var_a});
+  builder.add_destruct({var_a, var_range});
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+
+  EXPECT_TRUE(procedure.validate());
+  procedure_optimization::remove_unused_outputs(procedure);
+  EXPECT_TRUE(procedure.validate());
+  /* Vector outputs can't be ignored by the called function, so the unused range is kept. */
+  EXPECT_EQ(procedure.variables().size(), 3);
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<int> inputs = {1, 2};
+  Array<int> results(2, -1);
+  MFParamsBuilder params{procedure_fn, 2};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(2), params, context);
+
+  EXPECT_EQ(results[0], 11);
+  EXPECT_EQ(results[1], 12);
+}
+
+TEST(multi_function_procedure, FuseBlockCalls)
+{
+  /**
+   * procedure(float var1, float *var3, float *var5) {
+   *   var2 = 2.0f;
+   *   var3 = var1 * var2;
+   *   var4 = var3 + var1;
+   *   var6 = var4 * var4;
+   *   var5 = var6 + var1;
+   * }
+   */
+
+  const float two = 2.0f;
+  CustomMF_GenericConstant constant_fn{CPPType::get<float>(), &two, false};
+  CustomMF_SI_SI_SO<float, float, float> add_fn{"Add", [](float a, float b) { return a + b; }};
+  CustomMF_SI_SI_SO<float, float, float> mul_fn{"Multiply",
+                                                [](float a, float b) { return a * b; }};
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+
+  MFVariable *var1 = &builder.add_single_input_parameter<float>();
+  auto [var2] = builder.add_call<1>(constant_fn);
+  auto [var3] = builder.add_call<1>(mul_fn, {var1, var2});
+  auto [var4] = builder.add_call<1>(add_fn, {var3, var1});
+  /* Only uses variables that exist within the fused call, but still has to run for every block. */
+  auto [var6] = builder.add_call<1>(mul_fn, {var4, var4});
+  auto [var5] = builder.add_call<1>(add_fn, {var6, var1});
+  builder.add_destruct({var1, var2, var4, var6});
+  builder.add_return();
+  builder.add_output_parameter(*var3);
+  builder.add_output_parameter(*var5);
+
+  EXPECT_TRUE(procedure.validate());
+  procedure_optimization::fuse_block_calls(procedure);
+  EXPECT_TRUE(procedure.validate());
+
+  /* All calls are fused and the variables that are only used within the fused call are removed. */
+  const MFInstruction *entry = procedure.entry();
+  ASSERT_EQ(entry->type(), MFInstructionType::Call);
+  const MFCallInstruction &fused_call = static_cast<const MFCallInstruction &>(*entry);
+  EXPECT_EQ(fused_call.fn().param_amount(), 3);
+  EXPECT_EQ(procedure.variables().size(), 3);
+
+  MFProcedureExecutor executor{procedure};
+
+  const int64_t size = 5000;
+  Array<float> input_array(size);
+  for (const int64_t i : IndexRange(size)) {
+    input_array[i] = float(i % 100);
+  }
+  Vector<int64_t> mask_indices;
+  for (int64_t i = 0; i < size; i += 3) {
+    mask_indices.append(i);
+  }
+
+  for (const IndexMask mask : {IndexMask(size), IndexMask(mask_indices)}) {
+    Array<float> output_array1(size, -1.0f);
+    Array<float> output_array2(size, -1.0f);
+    MFParamsBuilder params{executor, &mask};
+    MFContextBuilder context;
+    params.add_readonly_single_input(input_array.as_span());
+    params.add_uninitialized_single_output(output_array1.as_mutable_span());
+    params.add_uninitialized_single_output(output_array2.as_mutable_span());
+    executor.call(mask, params, context);
+
+    for (const int64_t i : mask) {
+      const float value = input_array[i];
+      EXPECT_EQ(output_array1[i], value * 2.0f);
+      EXPECT_EQ(output_array2[i], (value * 3.0f) * (value * 3.0f) + value);
+    }
+    if (!mask.is_range()) {
+      EXPECT_EQ(output_array1[1], -1.0f);
+      EXPECT_EQ(output_array2[1], -1.0f);
+    }
+  }
+}
+
 }  // namespace blender::fn::tests
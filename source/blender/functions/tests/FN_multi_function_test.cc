@@ -280,6 +280,23 @@ TEST(multi_function, CustomMF_GenericConstant)
   EXPECT_EQ(outputs[3], 0);
 }
 
+TEST(multi_function, CustomMF_ConstantSignedZerosAreNotEqual)
+{
+  const float negative_zero = -0.0f;
+  const float positive_zero = 0.0f;
+  CustomMF_GenericConstant negative_fn{CPPType::get<float>(), &negative_zero, false};
+  CustomMF_GenericConstant positive_fn{CPPType::get<float>(), &positive_zero, false};
+  CustomMF_GenericConstant positive_copy_fn{CPPType::get<float>(), &positive_zero, true};
+  CustomMF_Constant<float> negative_typed_fn{-0.0f};
+  CustomMF_Constant<float> positive_typed_fn{0.0f};
+
+  EXPECT_TRUE(positive_fn.equals(positive_copy_fn));
+  EXPECT_TRUE(positive_typed_fn.equals(positive_fn));
+  EXPECT_FALSE(negative_fn.equals(positive_fn));
+  EXPECT_FALSE(negative_typed_fn.equals(positive_typed_fn));
+  EXPECT_FALSE(negative_typed_fn.equals(positive_fn));
+}
+
 TEST(multi_function, CustomMF_GenericConstantArray)
 {
   std::array<int, 4> values = {3, 4, 5, 6};
@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_benchmark.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "FN_multi_function_builder.hh"
+#include "FN_multi_function_procedure_builder.hh"
+#include "FN_multi_function_procedure_executor.hh"
+
+/**
+ * Compares executing every instruction of a procedure for all indices at once, with the chunked
+ * execution of #MFProcedureExecutor. Besides the time, the peak size of the temporary buffers is
+ * printed, which is the amount of memory that is streamed through the caches for every
+ * instruction.
+ *
+ * Run with `--benchmark-out=<file>.json` to write the results in the format of Google Benchmark.
+ */
+
+DEFINE_string(benchmark_out, "", "Write benchmark results to this JSON file.");
+DEFINE_double(benchmark_min_time, 0.1, "Minimum time in seconds per benchmark repetition.");
+DEFINE_int32(benchmark_repetitions, 3, "Number of repetitions for every benchmark.");
+DEFINE_int64(benchmark_size, 4000000, "Number of indices the procedure is evaluated for.");
+
+namespace blender::fn::benchmark::tests {
+
+using namespace blender::benchmark;
+
+class BenchmarkEnvironment : public ::testing::Environment {
+ public:
+  void SetUp() override
+  {
+    options().min_time = FLAGS_benchmark_min_time;
+    options().repetitions = FLAGS_benchmark_repetitions;
+  }
+
+  void TearDown() override
+  {
+    if (!FLAGS_benchmark_out.empty()) {
+      if (!write_json(FLAGS_benchmark_out)) {
+        ADD_FAILURE() << "Could not write benchmark results to " << FLAGS_benchmark_out;
+      }
+    }
+  }
+};
+
+static ::testing::Environment *const benchmark_environment =
+    ::testing::AddGlobalTestEnvironment(new BenchmarkEnvironment());
+
+static int64_t temporary_memory_peak(FunctionRef<void()> fn)
+{
+  const size_t memory_before = MEM_get_memory_in_use();
+  MEM_reset_peak_memory();
+  fn();
+  return int64_t(MEM_get_peak_memory()) - int64_t(memory_before);
+}
+
+TEST(multi_function_procedure_benchmark, MathChain)
+{
+  const int instructions_num = 20;
+  const int64_t size = FLAGS_benchmark_size;
+
+  CustomMF_SI_SI_SO<float, float, float> add_fn{
+      "Add", [](float a, float b) { return a + b; }, CustomMF_presets::AllSpanOrSingle()};
+  CustomMF_SI_SI_SO<float, float, float> mul_fn{
+      "Multiply", [](float a, float b) { return a * b; }, CustomMF_presets::AllSpanOrSingle()};
+  auto get_fn = [&](const int i) -> const MultiFunction & {
+    return i % 2 == 0 ? static_cast<const MultiFunction &>(mul_fn) : add_fn;
+  };
+
+  /**
+   * procedure(float in, float *out) {
+   *   float value = in;
+   *   value = value * in;
+   *   value = value + in;
+   *   ...
+   *   out = value;
+   * }
+   */
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+  MFVariable *var_in = &builder.add_single_input_parameter<float>();
+  MFVariable *var_value = var_in;
+  for (const int i : IndexRange(instructions_num)) {
+    auto [var_new_value] = builder.add_call<1>(get_fn(i), {var_value, var_in});
+    if (var_value != var_in) {
+      builder.add_destruct(*var_value);
+    }
+    var_value = var_new_value;
+  }
+  builder.add_destruct(*var_in);
+  builder.add_return();
+  builder.add_output_parameter(*var_value);
+  BLI_assert(procedure.validate());
+
+  const MFProcedureExecutor procedure_fn{procedure};
+
+  const Array<float> inputs(size, 1.0001f);
+  Array<float> outputs(size);
+
+  auto execute_per_instruction = [&]() {
+    /* Like a procedure that evaluates every instruction for all indices before the next. */
+    Array<float> buffer_a(size);
+    Array<float> buffer_b(size);
+    Span<float> value = inputs;
+    for (const int i : IndexRange(instructions_num)) {
+      MutableSpan<float> new_value = i == instructions_num - 1 ? outputs.as_mutable_span() :
+                                     (i % 2 == 0)             ? buffer_a.as_mutable_span() :
+                                                                buffer_b.as_mutable_span();
+      const MultiFunction &fn = get_fn(i);
+      MFParamsBuilder params{fn, size};
+      params.add_readonly_single_input(value);
+      params.add_readonly_single_input(inputs.as_span());
+      params.add_uninitialized_single_output(new_value);
+      MFContextBuilder context;
+      fn.call_auto(IndexRange(size), params, context);
+      value = new_value;
+    }
+  };
+  auto execute_procedure = [&]() {
+    MFParamsBuilder params{procedure_fn, size};
+    params.add_readonly_single_input(inputs.as_span());
+    params.add_uninitialized_single_output(outputs.as_mutable_span());
+    MFContextBuilder context;
+    procedure_fn.call_auto(IndexRange(size), params, context);
+  };
+
+  const std::string suffix = "/" + std::to_string(size);
+  run("MFProcedure/per_instruction" + suffix, size, [&]() {
+    execute_per_instruction();
+    do_not_optimize(outputs.last());
+  });
+  const float expected = outputs.last();
+  run("MFProcedure/chunked" + suffix, size, [&]() {
+    execute_procedure();
+    do_not_optimize(outputs.last());
+  });
+  EXPECT_EQ(outputs.last(), expected);
+
+  std::cout << "Temporary memory per instruction: "
+            << temporary_memory_peak(execute_per_instruction) / 1024 << " KiB\n";
+  std::cout << "Temporary memory chunked: " << temporary_memory_peak(execute_procedure) / 1024
+            << " KiB\n";
+}
+
+}  // namespace blender::fn::benchmark::tests
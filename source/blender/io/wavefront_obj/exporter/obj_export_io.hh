@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdio>
+#include <mutex>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -352,4 +353,52 @@ class FormatHandler : NonCopyable, NonMovable {
   }
 };
 
+/**
+ * Output buffers for items (e.g. objects) that are formatted in parallel, each into its own
+ * #FormatHandler. A buffer is written into the file as soon as it and all the buffers before it
+ * are finished, so the file contents are identical to formatting the items serially, while file
+ * writing overlaps with formatting and memory of written buffers is released early.
+ */
+template<eFileType filetype, size_t buffer_chunk_size = 64 * 1024>
+class OrderedFormatHandlers : NonCopyable, NonMovable {
+ private:
+  FILE *outfile_;
+  std::vector<FormatHandler<filetype, buffer_chunk_size>> buffers_;
+  /** Which buffers are complete, protected by #mutex_. */
+  std::vector<bool> finished_;
+  size_t next_to_write_ = 0;
+  std::mutex mutex_;
+
+ public:
+  OrderedFormatHandlers(FILE *outfile, size_t count)
+      : outfile_(outfile), buffers_(count), finished_(count, false)
+  {
+  }
+
+  ~OrderedFormatHandlers()
+  {
+    BLI_assert(next_to_write_ == buffers_.size());
+  }
+
+  FormatHandler<filetype, buffer_chunk_size> &buffer(size_t index)
+  {
+    return buffers_[index];
+  }
+
+  /**
+   * Mark the buffer as complete. It is written into the file when all preceding buffers are
+   * written, possibly together with the completed buffers that follow it.
+   * Thread-safe, but a buffer must not be modified after it is finished.
+   */
+  void finish(size_t index)
+  {
+    std::lock_guard lock{mutex_};
+    finished_[index] = true;
+    while (next_to_write_ < finished_.size() && finished_[next_to_write_]) {
+      buffers_[next_to_write_].write_to_file(outfile_);
+      next_to_write_++;
+    }
+  }
+};
+
 }  // namespace blender::io::obj
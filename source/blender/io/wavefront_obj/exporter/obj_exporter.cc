@@ -143,7 +143,6 @@ static void write_mesh_objects(Vector<std::unique_ptr<OBJMesh>> exportable_as_me
    * we have to have the output text buffer for each object,
    * and write them all into the file at the end. */
   size_t count = exportable_as_mesh.size();
-  std::vector<FormatHandler<eFileType::OBJ>> buffers(count);
 
   /* Serial: gather material indices, ensure normals & edges. */
   Vector<Vector<int>> mtlindices;
@@ -188,11 +187,13 @@ static void write_mesh_objects(Vector<std::unique_ptr<OBJMesh>> exportable_as_me
     offsets.normal_offset += obj.tot_normal_indices();
   }
 
-  /* Parallel over meshes: main result writing. */
+  /* Parallel over meshes: main result writing. Object text buffers are written into
+   * the output file in order, as soon as all preceding objects are done. */
+  OrderedFormatHandlers<eFileType::OBJ> buffers(obj_writer.get_outfile(), count);
   blender::threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
     for (const int i : range) {
       OBJMesh &obj = *exportable_as_mesh[i];
-      auto &fh = buffers[i];
+      auto &fh = buffers.buffer(i);
 
       obj_writer.write_object_name(fh, obj);
       obj_writer.write_vertex_coords(fh, obj);
@@ -226,14 +227,10 @@ static void write_mesh_objects(Vector<std::unique_ptr<OBJMesh>> exportable_as_me
       /* Nothing will need this object's data after this point, release
        * various arrays here. */
       obj.clear();
+
+      buffers.finish(i);
     }
   });
-
-  /* Write all the object text buffers into the output file. */
-  FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
-  }
 }
 
 /**
@@ -242,13 +239,17 @@ static void write_mesh_objects(Vector<std::unique_ptr<OBJMesh>> exportable_as_me
 static void write_nurbs_curve_objects(const Vector<std::unique_ptr<OBJCurve>> &exportable_as_nurbs,
                                       const OBJWriter &obj_writer)
 {
-  FormatHandler<eFileType::OBJ> fh;
+  /* Curves only use relative vertex indices, so they can be formatted independently. */
+  const size_t count = exportable_as_nurbs.size();
+  OrderedFormatHandlers<eFileType::OBJ> buffers(obj_writer.get_outfile(), count);
   /* #OBJCurve doesn't have any dynamically allocated memory, so it's fine
    * to wait for #blender::Vector to clean the objects up. */
-  for (const std::unique_ptr<OBJCurve> &obj_curve : exportable_as_nurbs) {
-    obj_writer.write_nurbs_curve(fh, *obj_curve);
-  }
-  fh.write_to_file(obj_writer.get_outfile());
+  blender::threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      obj_writer.write_nurbs_curve(buffers.buffer(i), *exportable_as_nurbs[i]);
+      buffers.finish(i);
+    }
+  });
 }
 
 void export_frame(Depsgraph *depsgraph, const OBJExportParams &export_params, const char *filepath)
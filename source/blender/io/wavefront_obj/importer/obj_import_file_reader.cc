@@ -6,6 +6,7 @@
 
 #include "BLI_map.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "obj_import_file_reader.hh"
@@ -15,6 +16,53 @@ namespace blender::io::obj {
 
 using std::string;
 
+/**
+ * A face corner as written in the file. The indices are converted to zero-based indices into
+ * the global vertex lists only when stitching, since that depends on all the preceding lines.
+ */
+struct RawPolyCorner {
+  int vert_index = INT32_MAX;
+  int uv_vert_index = -1;
+  int vertex_normal_index = -1;
+  bool got_uv = false;
+  bool got_normal = false;
+};
+
+enum class eChunkElement : uint8_t {
+  /** A run of consecutive `v` lines. */
+  Vertices,
+  /** A run of consecutive `vn` lines. */
+  VertexNormals,
+  /** A run of consecutive `vt` lines. */
+  UVVertices,
+  /** A single `f` line. */
+  Face,
+  /** Any other line (objects, groups, materials, curves...), handled while stitching. */
+  Line,
+};
+
+struct ChunkElement {
+  eChunkElement type;
+  /** Amount of consecutive vertices, or amount of face corners. */
+  int count;
+  /** Line contents without leading white-space, only for #eChunkElement::Line. */
+  StringRef line;
+};
+
+/**
+ * Result of parsing a line-aligned part of the read buffer, independently of all other parts.
+ * Vertex data and faces are fully tokenized, their order relative to the remaining lines is kept
+ * in #elements.
+ */
+struct ParsedChunk {
+  Vector<float3> vertices;
+  Vector<float3> vertex_normals;
+  Vector<float2> uv_vertices;
+  Vector<RawPolyCorner> face_corners;
+  Vector<ChunkElement> elements;
+  size_t line_count = 0;
+};
+
 /**
  * Based on the properties of the given Geometry instance, create a new Geometry instance
  * or return the previous one.
@@ -65,35 +113,6 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(Geometry *geom,
-                            const char *p,
-                            const char *end,
-                            GlobalVertices &r_global_vertices)
-{
-  float3 vert;
-  parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
-  geom->vertex_count_++;
-}
-
-static void geom_add_vertex_normal(Geometry *geom,
-                                   const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
-{
-  float3 normal;
-  parse_floats(p, end, 0.0f, normal, 3);
-  r_global_vertices.vertex_normals.append(normal);
-  geom->has_vertex_normals_ = true;
-}
-
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
-{
-  float2 uv;
-  parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
-}
-
 static void geom_add_edge(Geometry *geom,
                           const char *p,
                           const char *end,
@@ -111,8 +130,7 @@ static void geom_add_edge(Geometry *geom,
 }
 
 static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
+                             Span<RawPolyCorner> raw_corners,
                              const GlobalVertices &global_vertices,
                              const VertexIndexOffset &offsets,
                              const int material_index,
@@ -131,27 +149,13 @@ static void geom_add_polygon(Geometry *geom,
   curr_face.start_index_ = orig_corners_size;
 
   bool face_valid = true;
-  p = drop_whitespace(p, end);
-  while (p < end && face_valid) {
+  for (const RawPolyCorner &raw_corner : raw_corners) {
+    if (!face_valid) {
+      break;
+    }
     PolyCorner corner;
-    bool got_uv = false, got_normal = false;
-    /* Parse vertex index. */
-    p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
+    corner.vert_index = raw_corner.vert_index;
     face_valid &= corner.vert_index != INT32_MAX;
-    if (p < end && *p == '/') {
-      /* Parse UV index. */
-      ++p;
-      if (p < end && *p != '/') {
-        p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
-        got_uv = corner.uv_vert_index != INT32_MAX;
-      }
-      /* Parse normal index. */
-      if (p < end && *p == '/') {
-        ++p;
-        p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
-        got_normal = corner.uv_vert_index != INT32_MAX;
-      }
-    }
     /* Always keep stored indices non-negative and zero-based. */
     corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() :
                                                  -offsets.get_index_offset() - 1;
@@ -162,7 +166,8 @@ static void geom_add_polygon(Geometry *geom,
               (size_t)global_vertices.vertices.size());
       face_valid = false;
     }
-    if (got_uv) {
+    if (raw_corner.got_uv) {
+      corner.uv_vert_index = raw_corner.uv_vert_index;
       corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
       if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
         fprintf(stderr,
@@ -172,7 +177,8 @@ static void geom_add_polygon(Geometry *geom,
         face_valid = false;
       }
     }
-    if (got_normal) {
+    if (raw_corner.got_normal) {
+      corner.vertex_normal_index = raw_corner.vertex_normal_index;
       corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
                                         global_vertices.vertex_normals.size() :
                                         -1;
@@ -187,9 +193,6 @@ static void geom_add_polygon(Geometry *geom,
     }
     geom->face_corners_.append(corner);
     curr_face.corner_count_++;
-
-    /* Skip whitespace to get to the next face corner. */
-    p = drop_whitespace(p, end);
   }
 
   if (face_valid) {
@@ -300,7 +303,7 @@ static void geom_update_smooth_group(const char *p, const char *end, bool &r_sta
   r_state_shaded_smooth = smooth != 0;
 }
 
-OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_size = 64 * 1024)
+OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_size)
     : import_params_(import_params), read_buffer_size_(read_buffer_size)
 {
   obj_file_ = BLI_fopen(import_params_.filepath, "rb");
@@ -308,6 +311,11 @@ OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_si
     fprintf(stderr, "Cannot read from OBJ file:'%s'.\n", import_params_.filepath);
     return;
   }
+  /* Don't allocate a (potentially huge) read buffer for small files. */
+  const size_t file_size = BLI_file_size(import_params_.filepath);
+  if (file_size != size_t(-1)) {
+    read_buffer_size_ = std::min(read_buffer_size_, file_size + 1);
+  }
 }
 
 OBJParser::~OBJParser()
@@ -336,6 +344,122 @@ static bool parse_keyword(const char *&p, const char *end, StringRef keyword)
   return true;
 }
 
+/**
+ * Parse the face corners of an `f` line, without resolving relative indices.
+ * Returns the amount of corners added to `r_corners`.
+ */
+static int parse_face_corners(const char *p, const char *end, Vector<RawPolyCorner> &r_corners)
+{
+  int corner_count = 0;
+  bool face_valid = true;
+  p = drop_whitespace(p, end);
+  while (p < end && face_valid) {
+    RawPolyCorner corner;
+    /* Parse vertex index. */
+    p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
+    face_valid &= corner.vert_index != INT32_MAX;
+    if (p < end && *p == '/') {
+      /* Parse UV index. */
+      ++p;
+      if (p < end && *p != '/') {
+        p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
+        corner.got_uv = corner.uv_vert_index != INT32_MAX;
+      }
+      /* Parse normal index. */
+      if (p < end && *p == '/') {
+        ++p;
+        p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
+        corner.got_normal = corner.uv_vert_index != INT32_MAX;
+      }
+    }
+    r_corners.append(corner);
+    corner_count++;
+
+    /* Skip whitespace to get to the next face corner. */
+    p = drop_whitespace(p, end);
+  }
+  return corner_count;
+}
+
+static void chunk_add_element(ParsedChunk &r_chunk, const eChunkElement type)
+{
+  if (!r_chunk.elements.is_empty() && r_chunk.elements.last().type == type) {
+    r_chunk.elements.last().count++;
+    return;
+  }
+  r_chunk.elements.append({type, 1, {}});
+}
+
+/**
+ * Tokenize the vertex data and faces of a line-aligned part of the input. This does not depend
+ * on any other part of the file, so chunks can be parsed in parallel.
+ */
+static void parse_chunk(StringRef buffer, ParsedChunk &r_chunk)
+{
+  while (!buffer.is_empty()) {
+    StringRef line = read_next_line(buffer);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    ++r_chunk.line_count;
+    if (p == end) {
+      continue;
+    }
+    /* Most common things that start with 'v': vertices, normals, UVs. */
+    if (*p == 'v') {
+      if (parse_keyword(p, end, "v")) {
+        float3 vert;
+        parse_floats(p, end, 0.0f, vert, 3);
+        r_chunk.vertices.append(vert);
+        chunk_add_element(r_chunk, eChunkElement::Vertices);
+      }
+      else if (parse_keyword(p, end, "vn")) {
+        float3 normal;
+        parse_floats(p, end, 0.0f, normal, 3);
+        r_chunk.vertex_normals.append(normal);
+        chunk_add_element(r_chunk, eChunkElement::VertexNormals);
+      }
+      else if (parse_keyword(p, end, "vt")) {
+        float2 uv;
+        parse_floats(p, end, 0.0f, uv, 2);
+        r_chunk.uv_vertices.append(uv);
+        chunk_add_element(r_chunk, eChunkElement::UVVertices);
+      }
+    }
+    /* Faces. */
+    else if (parse_keyword(p, end, "f")) {
+      const int corner_count = parse_face_corners(p, end, r_chunk.face_corners);
+      r_chunk.elements.append({eChunkElement::Face, corner_count, {}});
+    }
+    /* Comments. */
+    else if (*p == '#') {
+      /* Nothing to do. */
+    }
+    else {
+      r_chunk.elements.append({eChunkElement::Line, 0, StringRef(p, end)});
+    }
+  }
+}
+
+/**
+ * Split the buffer into parts of roughly `chunk_size` bytes, each containing whole lines only.
+ * The buffer is expected to end with a newline.
+ */
+static Vector<StringRef> split_into_line_chunks(StringRef buffer, const int64_t chunk_size)
+{
+  Vector<StringRef> chunks;
+  while (!buffer.is_empty()) {
+    int64_t chunk_end = std::min(chunk_size, buffer.size());
+    /* Extend the chunk until the end of the line, taking line continuations into account. */
+    while (chunk_end < buffer.size() &&
+           !(buffer[chunk_end - 1] == '\n' && (chunk_end < 2 || buffer[chunk_end - 2] != '\\'))) {
+      ++chunk_end;
+    }
+    chunks.append(buffer.substr(0, chunk_end));
+    buffer = buffer.drop_prefix(chunk_end);
+  }
+  return chunks;
+}
+
 void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                       GlobalVertices &r_global_vertices)
 {
@@ -359,6 +483,10 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
    * to possibly store remainder of the previous input line that got broken mid-chunk. */
   Array<char> buffer(read_buffer_size_ * 2);
 
+  /* Each read block is split into smaller line-aligned parts that are tokenized in parallel.
+   * Use enough parts per block to balance the load between threads. */
+  const int64_t parse_chunk_size = std::max<int64_t>(read_buffer_size_ / 256, 64);
+
   size_t buffer_offset = 0;
   size_t line_number = 0;
   while (true) {
@@ -401,106 +529,133 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
     }
     ++last_nl;
 
-    /* Parse the buffer (until last newline) that we have so far,
-     * line by line. */
-    StringRef buffer_str{buffer.data(), (int64_t)last_nl};
-    while (!buffer_str.is_empty()) {
-      StringRef line = read_next_line(buffer_str);
-      const char *p = line.begin(), *end = line.end();
-      p = drop_whitespace(p, end);
-      ++line_number;
-      if (p == end) {
-        continue;
-      }
-      /* Most common things that start with 'v': vertices, normals, UVs. */
-      if (*p == 'v') {
-        if (parse_keyword(p, end, "v")) {
-          geom_add_vertex(curr_geom, p, end, r_global_vertices);
+    /* Tokenize the buffer (until last newline) that we have so far in parallel. */
+    const Vector<StringRef> chunks = split_into_line_chunks(
+        StringRef(buffer.data(), (int64_t)last_nl), parse_chunk_size);
+    Array<ParsedChunk> parsed_chunks(chunks.size());
+    threading::parallel_for(chunks.index_range(), 1, [&](IndexRange range) {
+      for (const int64_t i : range) {
+        parse_chunk(chunks[i], parsed_chunks[i]);
+      }
+    });
+
+    int64_t vertices_num = 0, normals_num = 0, uvs_num = 0;
+    for (const ParsedChunk &chunk : parsed_chunks) {
+      vertices_num += chunk.vertices.size();
+      normals_num += chunk.vertex_normals.size();
+      uvs_num += chunk.uv_vertices.size();
+    }
+    r_global_vertices.vertices.reserve(r_global_vertices.vertices.size() + vertices_num);
+    r_global_vertices.vertex_normals.reserve(r_global_vertices.vertex_normals.size() +
+                                             normals_num);
+    r_global_vertices.uv_vertices.reserve(r_global_vertices.uv_vertices.size() + uvs_num);
+
+    /* Stitch the parsed chunks together, in file order, so that the result does not depend on
+     * how the buffer was split. */
+    for (const ParsedChunk &chunk : parsed_chunks) {
+      int64_t vertex_index = 0, normal_index = 0, uv_index = 0, corner_index = 0;
+      for (const ChunkElement &element : chunk.elements) {
+        if (element.type == eChunkElement::Vertices) {
+          r_global_vertices.vertices.extend(chunk.vertices.as_span().slice(vertex_index,
+                                                                           element.count));
+          curr_geom->vertex_count_ += element.count;
+          vertex_index += element.count;
         }
-        else if (parse_keyword(p, end, "vn")) {
-          geom_add_vertex_normal(curr_geom, p, end, r_global_vertices);
+        else if (element.type == eChunkElement::VertexNormals) {
+          r_global_vertices.vertex_normals.extend(
+              chunk.vertex_normals.as_span().slice(normal_index, element.count));
+          curr_geom->has_vertex_normals_ = true;
+          normal_index += element.count;
         }
-        else if (parse_keyword(p, end, "vt")) {
-          geom_add_uv_vertex(p, end, r_global_vertices);
+        else if (element.type == eChunkElement::UVVertices) {
+          r_global_vertices.uv_vertices.extend(
+              chunk.uv_vertices.as_span().slice(uv_index, element.count));
+          uv_index += element.count;
         }
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "f")) {
-        geom_add_polygon(curr_geom,
-                         p,
-                         end,
-                         r_global_vertices,
-                         offsets,
-                         state_material_index,
-                         state_group_index, /* TODO was wrongly material name! */
-                         state_shaded_smooth);
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "l")) {
-        geom_add_edge(curr_geom, p, end, offsets, r_global_vertices);
-      }
-      /* Objects. */
-      else if (parse_keyword(p, end, "o")) {
-        state_shaded_smooth = false;
-        state_group_name = "";
-        state_material_name = "";
-        curr_geom = create_geometry(curr_geom,
-                                    GEOM_MESH,
-                                    StringRef(p, end).trim(),
-                                    r_global_vertices,
-                                    r_all_geometries,
-                                    offsets);
-      }
-      /* Groups. */
-      else if (parse_keyword(p, end, "g")) {
-        geom_update_group(StringRef(p, end).trim(), state_group_name);
-        int new_index = curr_geom->group_indices_.size();
-        state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-        if (new_index == state_group_index) {
-          curr_geom->group_order_.append(state_group_name);
+        else if (element.type == eChunkElement::Face) {
+          geom_add_polygon(curr_geom,
+                           chunk.face_corners.as_span().slice(corner_index, element.count),
+                           r_global_vertices,
+                           offsets,
+                           state_material_index,
+                           state_group_index, /* TODO was wrongly material name! */
+                           state_shaded_smooth);
+          corner_index += element.count;
         }
-      }
-      /* Smoothing groups. */
-      else if (parse_keyword(p, end, "s")) {
-        geom_update_smooth_group(p, end, state_shaded_smooth);
-      }
-      /* Materials and their libraries. */
-      else if (parse_keyword(p, end, "usemtl")) {
-        state_material_name = StringRef(p, end).trim();
-        int new_mat_index = curr_geom->material_indices_.size();
-        state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                          new_mat_index);
-        if (new_mat_index == state_material_index) {
-          curr_geom->material_order_.append(state_material_name);
+        else {
+          const char *p = element.line.begin(), *end = element.line.end();
+          /* Edges. */
+          if (parse_keyword(p, end, "l")) {
+            geom_add_edge(curr_geom, p, end, offsets, r_global_vertices);
+          }
+          /* Objects. */
+          else if (parse_keyword(p, end, "o")) {
+            state_shaded_smooth = false;
+            state_group_name = "";
+            state_material_name = "";
+            curr_geom = create_geometry(curr_geom,
+                                        GEOM_MESH,
+                                        StringRef(p, end).trim(),
+                                        r_global_vertices,
+                                        r_all_geometries,
+                                        offsets);
+          }
+          /* Groups. */
+          else if (parse_keyword(p, end, "g")) {
+            geom_update_group(StringRef(p, end).trim(), state_group_name);
+            int new_index = curr_geom->group_indices_.size();
+            state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name,
+                                                                        new_index);
+            if (new_index == state_group_index) {
+              curr_geom->group_order_.append(state_group_name);
+            }
+          }
+          /* Smoothing groups. */
+          else if (parse_keyword(p, end, "s")) {
+            geom_update_smooth_group(p, end, state_shaded_smooth);
+          }
+          /* Materials and their libraries. */
+          else if (parse_keyword(p, end, "usemtl")) {
+            state_material_name = StringRef(p, end).trim();
+            int new_mat_index = curr_geom->material_indices_.size();
+            state_material_index = curr_geom->material_indices_.lookup_or_add(
+                state_material_name, new_mat_index);
+            if (new_mat_index == state_material_index) {
+              curr_geom->material_order_.append(state_material_name);
+            }
+          }
+          else if (parse_keyword(p, end, "mtllib")) {
+            add_mtl_library(StringRef(p, end).trim());
+          }
+          /* Curve related things. */
+          else if (parse_keyword(p, end, "cstype")) {
+            curr_geom = geom_set_curve_type(curr_geom,
+                                            p,
+                                            end,
+                                            r_global_vertices,
+                                            state_group_name,
+                                            offsets,
+                                            r_all_geometries);
+          }
+          else if (parse_keyword(p, end, "deg")) {
+            geom_set_curve_degree(curr_geom, p, end);
+          }
+          else if (parse_keyword(p, end, "curv")) {
+            geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+          }
+          else if (parse_keyword(p, end, "parm")) {
+            geom_add_curve_parameters(curr_geom, p, end);
+          }
+          else if (StringRef(p, end).startswith("end")) {
+            /* End of curve definition, nothing else to do. */
+          }
+          else {
+            std::cout << "OBJ element not recognized: '" << std::string(p, end) << "'"
+                      << std::endl;
+          }
         }
       }
-      else if (parse_keyword(p, end, "mtllib")) {
-        add_mtl_library(StringRef(p, end).trim());
-      }
-      /* Comments. */
-      else if (*p == '#') {
-        /* Nothing to do. */
-      }
-      /* Curve related things. */
-      else if (parse_keyword(p, end, "cstype")) {
-        curr_geom = geom_set_curve_type(
-            curr_geom, p, end, r_global_vertices, state_group_name, offsets, r_all_geometries);
-      }
-      else if (parse_keyword(p, end, "deg")) {
-        geom_set_curve_degree(curr_geom, p, end);
-      }
-      else if (parse_keyword(p, end, "curv")) {
-        geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
-      }
-      else if (parse_keyword(p, end, "parm")) {
-        geom_add_curve_parameters(curr_geom, p, end);
-      }
-      else if (StringRef(p, end).startswith("end")) {
-        /* End of curve definition, nothing else to do. */
-      }
-      else {
-        std::cout << "OBJ element not recognized: '" << std::string(p, end) << "'" << std::endl;
-      }
+      line_number += chunk.line_count;
     }
 
     /* We might have a line that was cut in the middle by the previous buffer;
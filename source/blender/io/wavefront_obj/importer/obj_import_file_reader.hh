@@ -25,13 +25,18 @@ class OBJParser {
  public:
   /**
    * Open OBJ file at the path given in import parameters.
+   * The file is read in blocks of `read_buffer_size` bytes (clamped to the file size), which
+   * also limits the maximum line length.
    */
   OBJParser(const OBJImportParams &import_params, size_t read_buffer_size);
   ~OBJParser();
 
   /**
-   * Read the OBJ file line by line and create OBJ Geometry instances. Also store all the vertex
+   * Read the OBJ file and create OBJ Geometry instances. Also store all the vertex
    * and UV vertex coordinates in a struct accessible by all objects.
+   *
+   * Each read block is split into line-aligned chunks that are tokenized in parallel, and then
+   * added to the geometries in file order, so the result is the same as parsing line by line.
    */
   void parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
              GlobalVertices &r_global_vertices);
@@ -214,6 +214,30 @@ parm u 0.0
   ASSERT_EQ(got_string, expected);
 }
 
+TEST(obj_exporter_writer, ordered_format_handlers)
+{
+  std::string out_file_path = blender::tests::flags_test_release_dir() + "/" + temp_file_path;
+  FILE *f = BLI_fopen(out_file_path.c_str(), "wb");
+  if (!f) {
+    ADD_FAILURE();
+    return;
+  }
+  {
+    OrderedFormatHandlers<eFileType::OBJ> buffers(f, 3);
+    /* Finish the buffers out of order, the output should still be in order. */
+    buffers.buffer(2).write<eOBJSyntaxElement::object_name>("c");
+    buffers.finish(2);
+    buffers.buffer(1).write<eOBJSyntaxElement::object_name>("b");
+    buffers.finish(1);
+    buffers.buffer(0).write<eOBJSyntaxElement::object_name>("a");
+    buffers.finish(0);
+  }
+  fclose(f);
+  const std::string result = read_temp_file_in_string(out_file_path);
+  ASSERT_EQ(result, "o a\no b\no c\n");
+  BLI_delete(out_file_path.c_str(), false, false);
+}
+
 /* Return true if string #a and string #b are equal after their first newline. */
 static bool strings_equal_after_first_lines(const std::string &a, const std::string &b)
 {
@@ -470,7 +470,9 @@ typedef struct Library {
   struct PackedFile *packedfile;
 
   ushort tag;
-  char _pad_0[6];
+  /** #eLibrary_Flag. */
+  ushort flag;
+  char _pad_0[4];
 
   /* Temp data needed by read/write code, and liboverride recursive resync. */
   int temp_index;
@@ -484,6 +486,15 @@ enum eLibrary_Tag {
   LIBRARY_TAG_RESYNC_REQUIRED = 1 << 0,
 };
 
+/** #Library.flag */
+enum eLibrary_Flag {
+  /**
+   * Data was linked from this library with #BLO_LIBLINK_USE_LAZY. Dependencies are linked lazily
+   * again when the file is opened.
+   */
+  LIBRARY_FLAG_LAZY_LINK = 1 << 0,
+};
+
 /**
  * A weak library/ID reference for local data that has been appended, to allow re-using that local
  * data instead of creating a new copy of it in future appends.
@@ -750,6 +761,12 @@ enum {
    * The data-block is a library override that needs re-sync to its linked reference.
    */
   LIB_TAG_LIB_OVERRIDE_NEED_RESYNC = 1 << 21,
+
+  /**
+   * RESET_NEVER tag linked data-block as an empty place-holder, whose data is only read from its
+   * library once it is used by a dependency graph (see #BLO_LIBLINK_USE_LAZY).
+   */
+  LIB_TAG_LAZY_LINK = 1 << 22,
 };
 
 /* Tag given ID for an update in all the dependency graphs. */
@@ -2298,7 +2298,11 @@ typedef struct NodesModifierData {
    * This can be used to help the user to debug a node tree.
    */
   void *runtime_eval_log;
-  void *_pad1;
+  /**
+   * Results of expensive nodes that are reused in later evaluations, only used on the original
+   * modifier. See `MOD_nodes_cache.hh`.
+   */
+  void *runtime_cache;
 } NodesModifierData;
 
 typedef struct MeshToVolumeModifierData {
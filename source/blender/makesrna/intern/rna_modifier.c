@@ -19,6 +19,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
+#include "BLI_path_util.h"
 
 #include "BLT_translation.h"
 
@@ -1677,6 +1678,72 @@ static IDProperty **rna_NodesModifier_properties(PointerRNA *ptr)
   NodesModifierSettings *settings = &nmd->settings;
   return &settings->properties;
 }
+
+static void rna_NodesModifier_profile_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  NodesModifierData *nmd = ptr->data;
+  int entries_num, entry_size;
+  const void *entries = MOD_nodes_profile_entries(nmd, &entries_num, &entry_size);
+  rna_iterator_array_begin(iter, (void *)entries, entry_size, entries_num, 0, NULL);
+}
+
+static void rna_NodesModifier_profile_write_json(NodesModifierData *nmd,
+                                                 ReportList *reports,
+                                                 const char *filepath)
+{
+  if (!MOD_nodes_profile_write_json(nmd, filepath)) {
+    BKE_reportf(reports, RPT_ERROR, "Could not write node profile to \"%s\"", filepath);
+  }
+}
+
+static void rna_NodesModifierProfileEntry_node_path_get(PointerRNA *ptr, char *value)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  strcpy(value, info.node_path);
+}
+
+static int rna_NodesModifierProfileEntry_node_path_length(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return strlen(info.node_path);
+}
+
+static bool rna_NodesModifierProfileEntry_is_group_get(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return info.is_group;
+}
+
+static int rna_NodesModifierProfileEntry_executions_get(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return info.executions;
+}
+
+static float rna_NodesModifierProfileEntry_wall_time_get(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return (float)info.wall_time;
+}
+
+static float rna_NodesModifierProfileEntry_thread_time_get(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return (float)info.thread_time;
+}
+
+static float rna_NodesModifierProfileEntry_memory_delta_get(PointerRNA *ptr)
+{
+  NodesModifierProfileInfo info;
+  MOD_nodes_profile_entry_info(ptr->data, &info);
+  return (float)info.memory_delta;
+}
 #else
 
 static void rna_def_property_subdivision_common(StructRNA *srna)
@@ -6982,10 +7049,68 @@ static void rna_def_modifier_weightednormal(BlenderRNA *brna)
   RNA_define_lib_overridable(false);
 }
 
+static void rna_def_modifier_nodes_profile_entry(BlenderRNA *brna)
+{
+  StructRNA *srna;
+  PropertyRNA *prop;
+
+  srna = RNA_def_struct(brna, "NodesModifierProfileEntry", NULL);
+  RNA_def_struct_ui_text(
+      srna,
+      "Nodes Modifier Profile Entry",
+      "Cost of a node or of all nodes in a group node in the last evaluation of the modifier");
+
+  prop = RNA_def_property(srna, "node_path", PROP_STRING, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_string_funcs(prop,
+                                "rna_NodesModifierProfileEntry_node_path_get",
+                                "rna_NodesModifierProfileEntry_node_path_length",
+                                NULL);
+  RNA_def_property_ui_text(
+      prop,
+      "Node Path",
+      "Names of the group nodes and of the node, separated by slashes. Empty for the whole tree");
+  RNA_def_struct_name_property(srna, prop);
+
+  prop = RNA_def_property(srna, "is_group", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_boolean_funcs(prop, "rna_NodesModifierProfileEntry_is_group_get", NULL);
+  RNA_def_property_ui_text(
+      prop, "Is Group", "The entry contains the sum of all nodes in a group node or the tree");
+
+  prop = RNA_def_property(srna, "executions", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_NodesModifierProfileEntry_executions_get", NULL, NULL);
+  RNA_def_property_ui_text(prop, "Executions", "Number of times the nodes were executed");
+
+  prop = RNA_def_property(srna, "wall_time", PROP_FLOAT, PROP_TIME_ABSOLUTE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(prop, "rna_NodesModifierProfileEntry_wall_time_get", NULL, NULL);
+  RNA_def_property_ui_text(prop, "Wall Time", "Time spent executing the nodes");
+
+  prop = RNA_def_property(srna, "thread_time", PROP_FLOAT, PROP_TIME_ABSOLUTE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(prop, "rna_NodesModifierProfileEntry_thread_time_get", NULL, NULL);
+  RNA_def_property_ui_text(
+      prop,
+      "Thread Time",
+      "CPU time of the threads that executed the nodes, without work done by other threads");
+
+  prop = RNA_def_property(srna, "memory_delta", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(prop, "rna_NodesModifierProfileEntry_memory_delta_get", NULL, NULL);
+  RNA_def_property_ui_text(prop,
+                           "Memory Delta",
+                           "Change of the memory in use while the nodes were executed, in bytes. "
+                           "Includes allocations of other nodes that ran at the same time");
+}
+
 static void rna_def_modifier_nodes(BlenderRNA *brna)
 {
   StructRNA *srna;
   PropertyRNA *prop;
+  FunctionRNA *func;
+  PropertyRNA *parm;
 
   srna = RNA_def_struct(brna, "NodesModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Nodes Modifier", "");
@@ -7002,6 +7127,33 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
   RNA_def_property_update(prop, 0, "rna_NodesModifier_node_group_update");
 
   RNA_define_lib_overridable(false);
+
+  prop = RNA_def_property(srna, "profile", PROP_COLLECTION, PROP_NONE);
+  RNA_def_property_struct_type(prop, "NodesModifierProfileEntry");
+  RNA_def_property_collection_funcs(prop,
+                                    "rna_NodesModifier_profile_begin",
+                                    "rna_iterator_array_next",
+                                    "rna_iterator_array_end",
+                                    "rna_iterator_array_get",
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    NULL);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop,
+                           "Profile",
+                           "Cost of the nodes in the last evaluation in the active depsgraph. The "
+                           "first entry is the entire evaluation. Entries are only valid until the "
+                           "modifier is evaluated again");
+
+  func = RNA_def_function(srna, "profile_write_json", "rna_NodesModifier_profile_write_json");
+  RNA_def_function_ui_description(func, "Write the profile of the last evaluation to a JSON file");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+  parm = RNA_def_string_file_path(
+      func, "filepath", NULL, FILE_MAX, "File Path", "Path of the JSON file to write");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
+  rna_def_modifier_nodes_profile_entry(brna);
 }
 
 static void rna_def_modifier_mesh_to_volume(BlenderRNA *brna)
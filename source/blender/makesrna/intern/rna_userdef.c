@@ -6429,6 +6429,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Draw Manager Locking", "Don't lock UI during background rendering");
 
+  prop = RNA_def_property(srna, "use_incremental_save", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_incremental_save", 1);
+  RNA_def_property_ui_text(prop,
+                           "Incremental Save",
+                           "Only copy and compress data-blocks that changed since the previous "
+                           "save (uses as much extra memory as an undo step)");
+
   prop = RNA_def_property(srna, "use_extended_asset_browser", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(prop,
                            "Extended Asset Browser",
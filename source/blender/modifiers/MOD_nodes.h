@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "BLI_sys_types.h"
+
 struct Main;
 struct NodesModifierData;
 struct Object;
@@ -17,6 +19,35 @@ extern "C" {
  */
 void MOD_nodes_update_interface(struct Object *object, struct NodesModifierData *nmd);
 
+/** Cost of a node or of all nodes in a group node in the last logged evaluation. */
+typedef struct NodesModifierProfileInfo {
+  /** Names of the group nodes and of the node, separated by slashes. Empty for the whole tree. */
+  const char *node_path;
+  bool is_group;
+  int executions;
+  /** In seconds. */
+  double wall_time;
+  double thread_time;
+  /** In bytes. */
+  int64_t memory_delta;
+} NodesModifierProfileInfo;
+
+/**
+ * Get the profile of the last evaluation of the modifier that was logged, which only happens in
+ * the active depsgraph. The first entry is the entire evaluation. The entries stay valid until the
+ * modifier is evaluated again. Returns null when there is no profile.
+ */
+const void *MOD_nodes_profile_entries(const struct NodesModifierData *nmd,
+                                      int *r_entries_num,
+                                      int *r_entry_size);
+void MOD_nodes_profile_entry_info(const void *entry, NodesModifierProfileInfo *r_info);
+
+/**
+ * Write the profile of the last logged evaluation to a JSON file.
+ * Returns false when there is no profile or the file can't be written.
+ */
+bool MOD_nodes_profile_write_json(const struct NodesModifierData *nmd, const char *filepath);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,7 +6,9 @@
  */
 
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 #include "MEM_guardedalloc.h"
@@ -15,9 +17,11 @@
 #include "BLI_listbase.h"
 #include "BLI_math_vec_types.hh"
 #include "BLI_multi_value_map.hh"
+#include "BLI_serialize.hh"
 #include "BLI_set.hh"
 #include "BLI_string.h"
 #include "BLI_string_search.h"
+#include "BLI_timeit.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_collection_types.h"
@@ -71,6 +75,7 @@
 
 #include "MOD_modifiertypes.h"
 #include "MOD_nodes.h"
+#include "MOD_nodes_cache.hh"
 #include "MOD_nodes_evaluator.hh"
 #include "MOD_ui_common.h"
 
@@ -108,6 +113,7 @@ using blender::StringRef;
 using blender::StringRefNull;
 using blender::Vector;
 using blender::bke::OutputAttribute;
+using blender::modifiers::geometry_nodes::NodeResultCache;
 using blender::fn::Field;
 using blender::fn::GField;
 using blender::fn::ValueOrField;
@@ -910,6 +916,29 @@ static void clear_runtime_data(NodesModifierData *nmd)
   }
 }
 
+static void free_runtime_cache(NodesModifierData *nmd)
+{
+  if (nmd->runtime_cache != nullptr) {
+    delete static_cast<NodeResultCache *>(nmd->runtime_cache);
+    nmd->runtime_cache = nullptr;
+  }
+}
+
+/**
+ * The cache is stored on the original modifier, because the evaluated modifier is freed when the
+ * object is evaluated again.
+ */
+static NodeResultCache &ensure_runtime_cache(NodesModifierData &nmd_orig)
+{
+  /* Multiple depsgraphs may evaluate the same modifier at the same time. */
+  static std::mutex mutex;
+  std::lock_guard lock{mutex};
+  if (nmd_orig.runtime_cache == nullptr) {
+    nmd_orig.runtime_cache = new NodeResultCache();
+  }
+  return *static_cast<NodeResultCache *>(nmd_orig.runtime_cache);
+}
+
 struct OutputAttributeInfo {
   GField field;
   StringRefNull name;
@@ -1129,8 +1158,24 @@ static GeometrySet compute_geometry(const DerivedNodeTree &tree,
   eval_params.depsgraph = ctx->depsgraph;
   eval_params.self_object = ctx->object;
   eval_params.geo_logger = geo_logger.has_value() ? &*geo_logger : nullptr;
+  eval_params.cache = &ensure_runtime_cache(*reinterpret_cast<NodesModifierData *>(
+      BKE_modifier_get_original(ctx->object, &nmd->modifier)));
+
+  const blender::timeit::TimePoint begin = blender::timeit::Clock::now();
+  const blender::timeit::Nanoseconds thread_begin = blender::timeit::thread_cpu_time();
+  const size_t memory_begin = MEM_get_memory_in_use();
+
   blender::modifiers::geometry_nodes::evaluate_geometry_nodes(eval_params);
 
+  if (geo_logger.has_value()) {
+    geo_log::NodeExecutionProfile profile;
+    profile.executions = 1;
+    profile.wall_time = blender::timeit::Clock::now() - begin;
+    profile.thread_time = blender::timeit::thread_cpu_time() - thread_begin;
+    profile.memory_delta = int64_t(MEM_get_memory_in_use()) - int64_t(memory_begin);
+    geo_logger->log_evaluation_profile(profile);
+  }
+
   GeometrySet output_geometry_set = std::move(*eval_params.r_output_values[0].get<GeometrySet>());
 
   if (geo_logger.has_value()) {
@@ -1712,6 +1757,38 @@ static void internal_dependencies_panel_draw(const bContext *UNUSED(C), Panel *p
   }
 }
 
+static void result_cache_panel_draw(const bContext *UNUSED(C), Panel *panel)
+{
+  uiLayout *layout = panel->layout;
+
+  PointerRNA *ptr = modifier_panel_get_property_pointers(panel, nullptr);
+  NodesModifierData *nmd = static_cast<NodesModifierData *>(ptr->data);
+
+  if (nmd->runtime_cache == nullptr) {
+    uiItemL(layout, IFACE_("No results cached"), ICON_INFO);
+    return;
+  }
+  const NodeResultCache::Stats stats = static_cast<NodeResultCache *>(nmd->runtime_cache)->stats();
+
+  auto add_row = [&](const char *label, const std::string &value) {
+    uiLayout *split = uiLayoutSplit(layout, 0.4f, false);
+    uiLayout *row = uiLayoutRow(split, false);
+    uiLayoutSetAlignment(row, UI_LAYOUT_ALIGN_RIGHT);
+    uiLayoutSetActive(row, false);
+    uiItemL(row, label, ICON_NONE);
+    row = uiLayoutRow(split, false);
+    uiItemL(row, value.c_str(), ICON_NONE);
+  };
+
+  char memory_str[15];
+  BLI_str_format_byte_unit(memory_str, stats.memory, false);
+
+  add_row(IFACE_("Results"), std::to_string(stats.results_num));
+  add_row(IFACE_("Memory"), memory_str);
+  add_row(IFACE_("Hits"), std::to_string(stats.hits));
+  add_row(IFACE_("Misses"), std::to_string(stats.misses));
+}
+
 static void panelRegister(ARegionType *region_type)
 {
   PanelType *panel_type = modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
@@ -1727,6 +1804,12 @@ static void panelRegister(ARegionType *region_type)
                              nullptr,
                              internal_dependencies_panel_draw,
                              panel_type);
+  modifier_subpanel_register(region_type,
+                             "result_cache",
+                             N_("Result Cache"),
+                             nullptr,
+                             result_cache_panel_draw,
+                             panel_type);
 }
 
 static void blendWrite(BlendWriter *writer, const ModifierData *md)
@@ -1750,6 +1833,7 @@ static void blendRead(BlendDataReader *reader, ModifierData *md)
     IDP_BlendDataRead(reader, &nmd->settings.properties);
   }
   nmd->runtime_eval_log = nullptr;
+  nmd->runtime_cache = nullptr;
 }
 
 static void copyData(const ModifierData *md, ModifierData *target, const int flag)
@@ -1760,6 +1844,7 @@ static void copyData(const ModifierData *md, ModifierData *target, const int fla
   BKE_modifier_copydata_generic(md, target, flag);
 
   tnmd->runtime_eval_log = nullptr;
+  tnmd->runtime_cache = nullptr;
 
   if (nmd->settings.properties != nullptr) {
     tnmd->settings.properties = IDP_CopyProperty_ex(nmd->settings.properties, flag);
@@ -1775,6 +1860,78 @@ static void freeData(ModifierData *md)
   }
 
   clear_runtime_data(nmd);
+  free_runtime_cache(nmd);
+}
+
+static const geo_log::ModifierLog *get_eval_log(const NodesModifierData *nmd)
+{
+  return static_cast<const geo_log::ModifierLog *>(nmd->runtime_eval_log);
+}
+
+const void *MOD_nodes_profile_entries(const NodesModifierData *nmd,
+                                      int *r_entries_num,
+                                      int *r_entry_size)
+{
+  *r_entry_size = sizeof(geo_log::NodeProfileEntry);
+  const geo_log::ModifierLog *log = get_eval_log(nmd);
+  if (log == nullptr) {
+    *r_entries_num = 0;
+    return nullptr;
+  }
+  *r_entries_num = int(log->profile().size());
+  return log->profile().data();
+}
+
+void MOD_nodes_profile_entry_info(const void *entry, NodesModifierProfileInfo *r_info)
+{
+  const geo_log::NodeProfileEntry &profile_entry = *static_cast<const geo_log::NodeProfileEntry *>(
+      entry);
+  const geo_log::NodeExecutionProfile &profile = profile_entry.profile;
+  r_info->node_path = profile_entry.node_path.c_str();
+  r_info->is_group = profile_entry.is_group;
+  r_info->executions = profile.executions;
+  r_info->wall_time = std::chrono::duration<double>(profile.wall_time).count();
+  r_info->thread_time = std::chrono::duration<double>(profile.thread_time).count();
+  r_info->memory_delta = profile.memory_delta;
+}
+
+bool MOD_nodes_profile_write_json(const NodesModifierData *nmd, const char *filepath)
+{
+  using namespace blender::io::serialize;
+  const geo_log::ModifierLog *log = get_eval_log(nmd);
+  if (log == nullptr || log->profile().is_empty()) {
+    return false;
+  }
+
+  DictionaryValue root;
+  DictionaryValue::Items &root_items = root.elements();
+  root_items.append_as(std::pair("modifier", new StringValue(nmd->modifier.name)));
+  ArrayValue *entries = new ArrayValue();
+  root_items.append_as(std::pair("entries", entries));
+  for (const geo_log::NodeProfileEntry &profile_entry : log->profile()) {
+    NodesModifierProfileInfo info;
+    MOD_nodes_profile_entry_info(&profile_entry, &info);
+    DictionaryValue *entry = new DictionaryValue();
+    DictionaryValue::Items &items = entry->elements();
+    items.append_as(std::pair("node_path", new StringValue(info.node_path)));
+    items.append_as(std::pair("is_group", new BooleanValue(info.is_group)));
+    items.append_as(std::pair("executions", new IntValue(info.executions)));
+    items.append_as(std::pair("wall_time", new DoubleValue(info.wall_time)));
+    items.append_as(std::pair("thread_time", new DoubleValue(info.thread_time)));
+    items.append_as(std::pair("memory_delta", new IntValue(info.memory_delta)));
+    entries->elements().append_as(entry);
+  }
+
+  std::ofstream os;
+  os.open(filepath, std::ios::out | std::ios::trunc);
+  if (!os.is_open()) {
+    return false;
+  }
+  JsonFormatter formatter;
+  formatter.indentation_len = 2;
+  formatter.serialize(os, root);
+  os.close();
+  return !os.fail();
 }
 
 static void requiredDataMask(Object *UNUSED(ob),
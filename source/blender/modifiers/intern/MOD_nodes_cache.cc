@@ -0,0 +1,571 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "MEM_guardedalloc.h"
+
+#include "MOD_nodes_cache.hh"
+
+#include "BLI_float4x4.hh"
+#include "BLI_hash.hh"
+#include "BLI_hash_mm2a.h"
+#include "BLI_listbase.h"
+#include "BLI_task.hh"
+
+#include "DNA_curves_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_geometry_set.hh"
+#include "BKE_node.h"
+
+#include "FN_field_cpp_type.hh"
+
+namespace blender::modifiers::geometry_nodes {
+
+using fn::ValueOrFieldCPPType;
+
+CachedSocketValue::CachedSocketValue(const int socket_index, const GPointer value)
+    : socket_index(socket_index)
+{
+  const CPPType &type = *value.type();
+  void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+  type.copy_construct(value.get(), buffer);
+  this->value = {type, buffer};
+}
+
+CachedSocketValue::CachedSocketValue(CachedSocketValue &&other)
+    : socket_index(other.socket_index), value(other.value)
+{
+  other.value = {*other.value.type(), nullptr};
+}
+
+CachedSocketValue::~CachedSocketValue()
+{
+  if (value.get() != nullptr) {
+    value.destruct();
+    MEM_freeN(value.get());
+  }
+}
+
+static bool is_geometry(const CPPType &type)
+{
+  return type.is<GeometrySet>();
+}
+
+static uint64_t value_hash(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (is_geometry(type)) {
+    uint64_t hash = 0;
+    for (const GeometryComponent *component :
+         value.get<GeometrySet>()->get_components_for_read()) {
+      hash = get_default_hash_2(hash, component);
+    }
+    return hash;
+  }
+  if (const ValueOrFieldCPPType *value_or_field_type = dynamic_cast<const ValueOrFieldCPPType *>(
+          &type)) {
+    if (value_or_field_type->is_field(value.get())) {
+      return value_or_field_type->get_field_ptr(value.get())->hash();
+    }
+    return value_or_field_type->base_type().hash(value_or_field_type->get_value_ptr(value.get()));
+  }
+  return type.hash(value.get());
+}
+
+static bool values_equal(const GPointer a, const GPointer b)
+{
+  const CPPType &type = *a.type();
+  if (type != *b.type()) {
+    return false;
+  }
+  if (is_geometry(type)) {
+    /* Components are only compared by identity, see #NodeResultCache. */
+    return a.get<GeometrySet>()->get_components_for_read() ==
+           b.get<GeometrySet>()->get_components_for_read();
+  }
+  if (const ValueOrFieldCPPType *value_or_field_type = dynamic_cast<const ValueOrFieldCPPType *>(
+          &type)) {
+    const bool a_is_field = value_or_field_type->is_field(a.get());
+    const bool b_is_field = value_or_field_type->is_field(b.get());
+    if (a_is_field != b_is_field) {
+      return false;
+    }
+    if (a_is_field) {
+      return *value_or_field_type->get_field_ptr(a.get()) ==
+             *value_or_field_type->get_field_ptr(b.get());
+    }
+    return value_or_field_type->base_type().is_equal(value_or_field_type->get_value_ptr(a.get()),
+                                                     value_or_field_type->get_value_ptr(b.get()));
+  }
+  return type.is_equal(a.get(), b.get());
+}
+
+/**
+ * Hash of arbitrary bytes. Large arrays are split into chunks that are hashed in parallel. Two
+ * 32 bit hashes with different seeds are combined for every chunk, because equal content hashes
+ * are used to identify geometry, see #geometry_content_hash.
+ */
+static uint64_t bytes_hash(const void *data, const int64_t size)
+{
+  const int64_t chunk_size = 1 << 20;
+  Array<uint64_t> chunk_hashes((size + chunk_size - 1) / chunk_size);
+  threading::parallel_for(chunk_hashes.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const unsigned char *chunk = static_cast<const unsigned char *>(data) + i * chunk_size;
+      const size_t chunk_len = size_t(std::min(chunk_size, size - i * chunk_size));
+      chunk_hashes[i] = (uint64_t(BLI_hash_mm2(chunk, chunk_len, 0)) << 32) |
+                        uint64_t(BLI_hash_mm2(chunk, chunk_len, 1));
+    }
+  });
+  uint64_t hash = uint64_t(size);
+  for (const uint64_t chunk_hash : chunk_hashes) {
+    hash = get_default_hash_2(hash, chunk_hash);
+  }
+  return hash;
+}
+
+/**
+ * Hash all layers of the custom data, or return nothing when a layer type has dynamically
+ * allocated members that can't be hashed.
+ */
+static std::optional<uint64_t> custom_data_hash(const CustomData &data, const int size)
+{
+  uint64_t hash = uint64_t(size);
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    hash = get_default_hash_3(hash, layer.type, StringRef(layer.name));
+    if (layer.data == nullptr) {
+      continue;
+    }
+    if (layer.type == CD_MDEFORMVERT) {
+      const Span<MDeformVert> dverts(static_cast<const MDeformVert *>(layer.data), size);
+      for (const MDeformVert &dvert : dverts) {
+        hash = get_default_hash_2(hash, bytes_hash(dvert.dw, dvert.totweight * sizeof(*dvert.dw)));
+      }
+      continue;
+    }
+    if (CustomData_layertype_is_dynamic(layer.type)) {
+      return std::nullopt;
+    }
+    hash = get_default_hash_2(hash, bytes_hash(layer.data, CustomData_sizeof(layer.type) * size));
+  }
+  return hash;
+}
+
+static uint64_t materials_hash(Material *const *materials, const int materials_num)
+{
+  uint64_t hash = uint64_t(materials_num);
+  for (const int i : IndexRange(materials_num)) {
+    hash = get_default_hash_2(hash, materials[i]);
+  }
+  return hash;
+}
+
+static std::optional<uint64_t> mesh_content_hash(const Mesh &mesh)
+{
+  if (mesh.runtime.wrapper_type != ME_WRAPPER_TYPE_MDATA) {
+    return std::nullopt;
+  }
+  uint64_t hash = get_default_hash_3(mesh.flag, mesh.smoothresh, int(mesh.cd_flag));
+  hash = get_default_hash_2(hash, materials_hash(mesh.mat, mesh.totcol));
+  LISTBASE_FOREACH (const bDeformGroup *, defgroup, &mesh.vertex_group_names) {
+    hash = get_default_hash_2(hash, StringRef(defgroup->name));
+  }
+  const std::pair<const CustomData *, int> domains[] = {{&mesh.vdata, mesh.totvert},
+                                                        {&mesh.edata, mesh.totedge},
+                                                        {&mesh.pdata, mesh.totpoly},
+                                                        {&mesh.ldata, mesh.totloop}};
+  for (const std::pair<const CustomData *, int> &domain : domains) {
+    const std::optional<uint64_t> data_hash = custom_data_hash(*domain.first, domain.second);
+    if (!data_hash) {
+      return std::nullopt;
+    }
+    hash = get_default_hash_2(hash, *data_hash);
+  }
+  return hash;
+}
+
+static std::optional<uint64_t> pointcloud_content_hash(const PointCloud &pointcloud)
+{
+  const std::optional<uint64_t> data_hash = custom_data_hash(pointcloud.pdata,
+                                                             pointcloud.totpoint);
+  if (!data_hash) {
+    return std::nullopt;
+  }
+  return get_default_hash_2(*data_hash, materials_hash(pointcloud.mat, pointcloud.totcol));
+}
+
+static std::optional<uint64_t> curves_content_hash(const Curves &curves)
+{
+  const CurvesGeometry &geometry = curves.geometry;
+  const std::optional<uint64_t> point_data_hash = custom_data_hash(geometry.point_data,
+                                                                   geometry.point_num);
+  const std::optional<uint64_t> curve_data_hash = custom_data_hash(geometry.curve_data,
+                                                                   geometry.curve_num);
+  if (!point_data_hash || !curve_data_hash) {
+    return std::nullopt;
+  }
+  uint64_t hash = get_default_hash_2(*point_data_hash, *curve_data_hash);
+  if (geometry.curve_offsets != nullptr) {
+    hash = get_default_hash_2(
+        hash, bytes_hash(geometry.curve_offsets, (geometry.curve_num + 1) * sizeof(int)));
+  }
+  return get_default_hash_2(hash, materials_hash(curves.mat, curves.totcol));
+}
+
+/**
+ * Hash the contents of all components of the geometry. This identifies geometry that is not
+ * owned by the cache, like the input of the modifier or the geometry of other objects. Returns
+ * nothing for component types that are not supported, e.g. instances and volumes.
+ */
+static std::optional<uint64_t> geometry_content_hash(const GeometrySet &geometry)
+{
+  uint64_t hash = 0;
+  for (const GeometryComponent *component : geometry.get_components_for_read()) {
+    std::optional<uint64_t> component_hash;
+    switch (component->type()) {
+      case GEO_COMPONENT_TYPE_MESH:
+        if (const Mesh *mesh = static_cast<const MeshComponent *>(component)->get_for_read()) {
+          component_hash = mesh_content_hash(*mesh);
+        }
+        break;
+      case GEO_COMPONENT_TYPE_POINT_CLOUD:
+        if (const PointCloud *pointcloud =
+                static_cast<const PointCloudComponent *>(component)->get_for_read()) {
+          component_hash = pointcloud_content_hash(*pointcloud);
+        }
+        break;
+      case GEO_COMPONENT_TYPE_CURVE:
+        /* The legacy curve component can't be hashed. */
+        if (const CurveComponent *curve_component = dynamic_cast<const CurveComponent *>(
+                component)) {
+          if (const Curves *curves = curve_component->get_for_read()) {
+            component_hash = curves_content_hash(*curves);
+          }
+        }
+        break;
+      case GEO_COMPONENT_TYPE_INSTANCES:
+      case GEO_COMPONENT_TYPE_VOLUME:
+        break;
+    }
+    if (!component_hash) {
+      return std::nullopt;
+    }
+    hash = get_default_hash_3(hash, component->type(), *component_hash);
+  }
+  return hash;
+}
+
+/**
+ * Estimate the memory used by a value. For geometry, this is the size of all attributes and the
+ * topology. Data that is shared with other geometry is counted as well.
+ */
+static int64_t estimate_value_memory(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (!is_geometry(type)) {
+    return type.size();
+  }
+  int64_t memory = 0;
+  for (const GeometryComponent *component : value.get<GeometrySet>()->get_components_for_read()) {
+    component->attribute_foreach(
+        [&](const bke::AttributeIDRef & /*attribute_id*/, const AttributeMetaData &meta_data) {
+          if (const CPPType *attribute_type = bke::custom_data_type_to_cpp_type(
+                  meta_data.data_type)) {
+            memory += component->attribute_domain_num(meta_data.domain) * attribute_type->size();
+          }
+          return true;
+        });
+    /* The topology and instance transforms are not exposed as attributes. */
+    memory += component->attribute_domain_num(ATTR_DOMAIN_EDGE) * sizeof(MEdge);
+    memory += component->attribute_domain_num(ATTR_DOMAIN_FACE) * sizeof(MPoly);
+    memory += component->attribute_domain_num(ATTR_DOMAIN_CORNER) * sizeof(MLoop);
+    memory += component->attribute_domain_num(ATTR_DOMAIN_CURVE) * sizeof(int);
+    memory += component->attribute_domain_num(ATTR_DOMAIN_INSTANCE) * sizeof(float4x4);
+  }
+  return memory;
+}
+
+bool operator==(const NodeResultCache::Key &a, const NodeResultCache::Key &b)
+{
+  if (a.hash_ != b.hash_) {
+    return false;
+  }
+  if (a.node_path_ != b.node_path_ || a.node_data_ != b.node_data_ ||
+      a.used_outputs_ != b.used_outputs_ || a.inputs_.size() != b.inputs_.size() ||
+      a.geometry_content_hashes_ != b.geometry_content_hashes_) {
+    return false;
+  }
+  for (const int i : a.inputs_.index_range()) {
+    if (a.inputs_[i].socket_index != b.inputs_[i].socket_index) {
+      return false;
+    }
+    if (!values_equal(a.inputs_[i].value, b.inputs_[i].value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NodeResultCache::node_supports_caching(const DNode node)
+{
+  const bNodeType &node_type = *node->typeinfo();
+  /* Nodes that support laziness may execute multiple times with different inputs. */
+  return node_type.geometry_node_execute_supports_caching &&
+         !node_type.geometry_node_execute_supports_laziness;
+}
+
+bool NodeResultCache::geometry_is_owned(const GeometrySet &geometry) const
+{
+  for (const GeometryComponent *component : geometry.get_components_for_read()) {
+    if (!component_users_.contains(component)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NodeResultCache::value_is_cacheable(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (is_geometry(type)) {
+    /* Either compared by identity or by content, see #build_key. */
+    return true;
+  }
+  if (const ValueOrFieldCPPType *value_or_field_type = dynamic_cast<const ValueOrFieldCPPType *>(
+          &type)) {
+    if (value_or_field_type->is_field(value.get())) {
+      return true;
+    }
+    const CPPType &base_type = value_or_field_type->base_type();
+    return base_type.is_hashable() && base_type.is_equality_comparable();
+  }
+  return type.is_hashable() && type.is_equality_comparable();
+}
+
+template<typename T> static void append_bytes(std::string &str, const T &value)
+{
+  str.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+std::optional<NodeResultCache::Key> NodeResultCache::build_key(
+    const DNode node,
+    const Span<int> used_outputs,
+    const Span<std::pair<int, GPointer>> inputs) const
+{
+  const bNode &bnode = *node->bnode();
+
+  std::string node_path;
+  for (const DTreeContext *context = node.context(); !context->is_root();
+       context = context->parent_context()) {
+    node_path.insert(0, std::string(context->parent_node()->name()) + "/");
+  }
+  node_path += node->name();
+
+  std::string node_data = bnode.idname;
+  append_bytes(node_data, bnode.custom1);
+  append_bytes(node_data, bnode.custom2);
+  append_bytes(node_data, bnode.custom3);
+  append_bytes(node_data, bnode.custom4);
+  if (bnode.storage != nullptr) {
+    node_data.append(static_cast<const char *>(bnode.storage), MEM_allocN_len(bnode.storage));
+  }
+
+  return this->build_key(std::move(node_path), std::move(node_data), used_outputs, inputs);
+}
+
+std::optional<NodeResultCache::Key> NodeResultCache::build_key(
+    std::string node_path,
+    std::string node_data,
+    const Span<int> used_outputs,
+    const Span<std::pair<int, GPointer>> inputs) const
+{
+  Key key;
+  key.node_path_ = std::move(node_path);
+  key.node_data_ = std::move(node_data);
+
+  for (const int index : used_outputs) {
+    if (index >= 64) {
+      return std::nullopt;
+    }
+    key.used_outputs_ |= uint64_t(1) << index;
+  }
+
+  for (const std::pair<int, GPointer> &input : inputs) {
+    if (!value_is_cacheable(input.second)) {
+      return std::nullopt;
+    }
+  }
+
+  /* Geometry that is not owned by the cache is identified by its content instead. */
+  Array<bool> use_content_hash(inputs.size(), false);
+  {
+    std::lock_guard lock{mutex_};
+    for (const int i : inputs.index_range()) {
+      const GPointer value = inputs[i].second;
+      if (is_geometry(*value.type())) {
+        use_content_hash[i] = !this->geometry_is_owned(*value.get<GeometrySet>());
+      }
+    }
+  }
+
+  uint64_t hash = get_default_hash_3(key.node_path_, key.node_data_, key.used_outputs_);
+  key.inputs_.reserve(inputs.size());
+  for (const int i : inputs.index_range()) {
+    const int socket_index = inputs[i].first;
+    const GPointer value = inputs[i].second;
+    if (use_content_hash[i]) {
+      const std::optional<uint64_t> content_hash = geometry_content_hash(
+          *value.get<GeometrySet>());
+      if (!content_hash) {
+        return std::nullopt;
+      }
+      /* Don't keep a reference to the geometry, it may be freed or modified in place later. */
+      const GeometrySet empty_geometry;
+      key.inputs_.append(CachedSocketValue(socket_index, &empty_geometry));
+      key.geometry_content_hashes_.append({i, *content_hash});
+      hash = get_default_hash_3(hash, socket_index, *content_hash);
+      continue;
+    }
+    key.inputs_.append(CachedSocketValue(socket_index, value));
+    hash = get_default_hash_3(hash, socket_index, value_hash(value));
+  }
+  key.hash_ = hash;
+  return key;
+}
+
+bool NodeResultCache::lookup(const Key &key, FunctionRef<bool(const Result &result)> fn)
+{
+  std::lock_guard lock{mutex_};
+  if (const Vector<std::unique_ptr<Entry>> *entries = entries_by_node_.lookup_ptr(
+          key.node_path_)) {
+    for (const std::unique_ptr<Entry> &entry : *entries) {
+      if (entry->key == key) {
+        if (fn(entry->result)) {
+          entry->last_access = ++access_counter_;
+          stats_.hits++;
+          return true;
+        }
+        break;
+      }
+    }
+  }
+  stats_.misses++;
+  return false;
+}
+
+void NodeResultCache::add(Key key, Result result)
+{
+  int64_t memory = 0;
+  for (const CachedSocketValue &output : result.outputs) {
+    if (is_geometry(*output.value.type())) {
+      /* The geometry may reference data that is freed after the evaluation. */
+      if (!output.value.get<GeometrySet>()->owns_direct_data()) {
+        return;
+      }
+    }
+    memory += estimate_value_memory(output.value);
+  }
+  if (memory > max_memory) {
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  Vector<std::unique_ptr<Entry>> &entries = entries_by_node_.lookup_or_add_default(
+      key.node_path_);
+  for (const int i : entries.index_range()) {
+    if (entries[i]->key == key) {
+      this->remove_entry(entries, i);
+      break;
+    }
+  }
+  if (entries.size() >= max_results_per_node) {
+    int oldest_index = 0;
+    for (const int i : entries.index_range()) {
+      if (entries[i]->last_access < entries[oldest_index]->last_access) {
+        oldest_index = i;
+      }
+    }
+    this->remove_entry(entries, oldest_index);
+  }
+
+  std::unique_ptr<Entry> entry = std::make_unique<Entry>(
+      Entry{std::move(key), std::move(result), memory, ++access_counter_});
+  this->add_component_users(*entry, 1);
+  stats_.memory += memory;
+  stats_.results_num++;
+  entries.append(std::move(entry));
+
+  while (stats_.memory > max_memory) {
+    this->remove_least_recently_used();
+  }
+}
+
+void NodeResultCache::add_component_users(const Entry &entry, const int change)
+{
+  auto add_geometry = [&](const CachedSocketValue &value) {
+    if (!is_geometry(*value.value.type())) {
+      return;
+    }
+    for (const GeometryComponent *component :
+         value.value.get<GeometrySet>()->get_components_for_read()) {
+      int &users = component_users_.lookup_or_add(component, 0);
+      users += change;
+      if (users == 0) {
+        component_users_.remove(component);
+      }
+    }
+  };
+  for (const CachedSocketValue &value : entry.key.inputs_) {
+    add_geometry(value);
+  }
+  for (const CachedSocketValue &value : entry.result.outputs) {
+    add_geometry(value);
+  }
+}
+
+void NodeResultCache::remove_entry(Vector<std::unique_ptr<Entry>> &entries, const int index)
+{
+  const Entry &entry = *entries[index];
+  this->add_component_users(entry, -1);
+  stats_.memory -= entry.memory;
+  stats_.results_num--;
+  entries.remove_and_reorder(index);
+}
+
+void NodeResultCache::remove_least_recently_used()
+{
+  Vector<std::unique_ptr<Entry>> *oldest_entries = nullptr;
+  int oldest_index = -1;
+  for (Vector<std::unique_ptr<Entry>> &entries : entries_by_node_.values()) {
+    for (const int i : entries.index_range()) {
+      if (oldest_entries == nullptr ||
+          entries[i]->last_access < (*oldest_entries)[oldest_index]->last_access) {
+        oldest_entries = &entries;
+        oldest_index = i;
+      }
+    }
+  }
+  BLI_assert(oldest_entries != nullptr);
+  this->remove_entry(*oldest_entries, oldest_index);
+}
+
+void NodeResultCache::clear()
+{
+  std::lock_guard lock{mutex_};
+  entries_by_node_.clear();
+  component_users_.clear();
+  stats_.memory = 0;
+  stats_.results_num = 0;
+}
+
+NodeResultCache::Stats NodeResultCache::stats() const
+{
+  std::lock_guard lock{mutex_};
+  return stats_;
+}
+
+}  // namespace blender::modifiers::geometry_nodes
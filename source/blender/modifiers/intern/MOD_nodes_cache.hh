@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup modifiers
+ *
+ * Keeps the outputs of expensive geometry nodes between evaluations of a nodes modifier, so that
+ * nodes whose inputs did not change don't have to be executed again when something downstream of
+ * them changed or when the frame changed without affecting them.
+ *
+ * A result is found again with a #NodeResultCache::Key that consists of:
+ * - The path of the node in the (nested) node groups.
+ * - The node type and its properties.
+ * - The set of outputs that are used.
+ * - The values of all inputs.
+ *
+ * Geometry inputs are compared by the identity of their components when those are owned by the
+ * cache already, e.g. because they are the output of another cached node. That makes sure that a
+ * component is never freed while it is used in a key, so a new component can't get the same
+ * address.
+ *
+ * Other geometry, like the input of the modifier or the geometry of other objects, is identified
+ * by a hash of its content instead. The key does not keep a reference to it, because it may be
+ * freed after the evaluation or be modified in place otherwise.
+ */
+
+#include <mutex>
+#include <optional>
+
+#include "BLI_function_ref.hh"
+#include "BLI_generic_pointer.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "NOD_derived_node_tree.hh"
+#include "NOD_geometry_nodes_eval_log.hh"
+
+class GeometryComponent;
+struct GeometrySet;
+
+namespace geo_log = blender::nodes::geometry_nodes_eval_log;
+
+namespace blender::modifiers::geometry_nodes {
+
+using namespace nodes::derived_node_tree_types;
+
+/**
+ * A value that is owned by a cache key or result, together with the index of its socket.
+ * Multi-input sockets have one value per link, with the same socket index.
+ */
+class CachedSocketValue : NonCopyable {
+ public:
+  int socket_index;
+  GMutablePointer value;
+
+  CachedSocketValue(int socket_index, GPointer value);
+  CachedSocketValue(CachedSocketValue &&other);
+  ~CachedSocketValue();
+
+  CachedSocketValue &operator=(CachedSocketValue &&other) = delete;
+};
+
+class NodeResultCache : NonCopyable, NonMovable {
+ public:
+  /** Memory that all results of one cache may use together, in bytes. */
+  static constexpr int64_t max_memory = int64_t(512) * 1024 * 1024;
+  /** Older results of the same node are removed when it has more results than this. */
+  static constexpr int max_results_per_node = 4;
+
+  class Key : NonCopyable {
+   private:
+    std::string node_path_;
+    /** Type name and properties of the node. */
+    std::string node_data_;
+    uint64_t used_outputs_ = 0;
+    Vector<CachedSocketValue> inputs_;
+    /**
+     * Indices in #inputs_ of geometry that is identified by its content, with the content hash.
+     * The geometry itself is replaced by an empty geometry set in #inputs_.
+     */
+    Vector<std::pair<int, uint64_t>> geometry_content_hashes_;
+    uint64_t hash_ = 0;
+
+    Key() = default;
+
+    friend NodeResultCache;
+
+   public:
+    Key(Key &&other) = default;
+    Key &operator=(Key &&other) = default;
+
+    uint64_t hash() const
+    {
+      return hash_;
+    }
+
+    friend bool operator==(const Key &a, const Key &b);
+  };
+
+  struct Result {
+    Vector<CachedSocketValue> outputs;
+    /** Warnings of the node are displayed again when the result is reused. */
+    Vector<geo_log::NodeWarning> warnings;
+    /** False when the node was executed without logging, so warnings were not recorded. */
+    bool warnings_logged = false;
+  };
+
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t results_num = 0;
+    int64_t memory = 0;
+  };
+
+ private:
+  struct Entry {
+    Key key;
+    Result result;
+    int64_t memory;
+    /** Value of #access_counter_ when this entry was used the last time. */
+    uint64_t last_access;
+  };
+
+  mutable std::mutex mutex_;
+  /** All entries, grouped by node path. */
+  Map<std::string, Vector<std::unique_ptr<Entry>>> entries_by_node_;
+  /** Number of uses of every geometry component that is referenced by an entry. */
+  Map<const GeometryComponent *, int> component_users_;
+  uint64_t access_counter_ = 0;
+  Stats stats_;
+
+ public:
+  NodeResultCache() = default;
+
+  /**
+   * Returns true when the node can be cached at all. This only depends on the node type, so it
+   * can be checked before anything else is done.
+   */
+  static bool node_supports_caching(DNode node);
+
+  /**
+   * Create the key for the node, or return nothing when one of the inputs can't be compared.
+   * \param used_outputs: Indices of the outputs that the node has to compute.
+   * \param inputs: Values of all available inputs, with their socket index.
+   */
+  std::optional<Key> build_key(DNode node,
+                               Span<int> used_outputs,
+                               Span<std::pair<int, GPointer>> inputs) const;
+  /**
+   * Same as above, for a node that is identified by its path and its type and properties
+   * directly.
+   */
+  std::optional<Key> build_key(std::string node_path,
+                               std::string node_data,
+                               Span<int> used_outputs,
+                               Span<std::pair<int, GPointer>> inputs) const;
+
+  /**
+   * Call the function with the result for the key while the cache is locked. Values can be copied
+   * out of the result in the function, which returns false when the result can't be used after
+   * all. Returns false when no result for the key has been used.
+   */
+  bool lookup(const Key &key, FunctionRef<bool(const Result &result)> fn);
+
+  /**
+   * Add a new result, replacing an existing result for the same key. Old results are removed when
+   * the memory limit is exceeded.
+   */
+  void add(Key key, Result result);
+
+  void clear();
+  Stats stats() const;
+
+ private:
+  static bool value_is_cacheable(GPointer value);
+  bool geometry_is_owned(const GeometrySet &geometry) const;
+  void add_component_users(const Entry &entry, int change);
+  void remove_entry(Vector<std::unique_ptr<Entry>> &entries, int index);
+  void remove_least_recently_used();
+};
+
+}  // namespace blender::modifiers::geometry_nodes
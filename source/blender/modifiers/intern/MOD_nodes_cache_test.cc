@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "MOD_nodes_cache.hh"
+
+#include "BLI_math_vector.h"
+
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::modifiers::geometry_nodes::tests {
+
+class NodeResultCacheTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+static std::optional<NodeResultCache::Key> build_int_key(const NodeResultCache &cache,
+                                                         const std::string &node_path,
+                                                         const int value,
+                                                         const int used_output = 0)
+{
+  const Array<std::pair<int, GPointer>> inputs = {{0, &value}};
+  return cache.build_key(node_path, "GeometryNodeTest", Span<int>{used_output}, inputs);
+}
+
+static std::optional<NodeResultCache::Key> build_geometry_key(const NodeResultCache &cache,
+                                                              const GeometrySet &geometry)
+{
+  const Array<std::pair<int, GPointer>> inputs = {{0, &geometry}};
+  return cache.build_key("Node", "GeometryNodeTest", Span<int>{0}, inputs);
+}
+
+static NodeResultCache::Result int_result(const int value)
+{
+  NodeResultCache::Result result;
+  result.outputs.append(CachedSocketValue(0, &value));
+  return result;
+}
+
+static bool lookup_int(NodeResultCache &cache, const NodeResultCache::Key &key, int &r_value)
+{
+  return cache.lookup(key, [&](const NodeResultCache::Result &result) {
+    r_value = *result.outputs[0].value.get<int>();
+    return true;
+  });
+}
+
+static Mesh *create_triangle_mesh()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(3, 0, 0, 0, 0);
+  copy_v3_fl3(mesh->mvert[0].co, 0.0f, 0.0f, 0.0f);
+  copy_v3_fl3(mesh->mvert[1].co, 1.0f, 0.0f, 0.0f);
+  copy_v3_fl3(mesh->mvert[2].co, 0.0f, 1.0f, 0.0f);
+  return mesh;
+}
+
+TEST_F(NodeResultCacheTest, KeyEquality)
+{
+  NodeResultCache cache;
+  std::optional<NodeResultCache::Key> key = build_int_key(cache, "Group/Node", 1);
+  ASSERT_TRUE(key.has_value());
+
+  std::optional<NodeResultCache::Key> same_key = build_int_key(cache, "Group/Node", 1);
+  EXPECT_TRUE(*key == *same_key);
+  EXPECT_EQ(key->hash(), same_key->hash());
+
+  EXPECT_FALSE(*key == *build_int_key(cache, "Group/Node", 2));
+  EXPECT_FALSE(*key == *build_int_key(cache, "Group/Other", 1));
+  EXPECT_FALSE(*key == *build_int_key(cache, "Group/Node", 1, 1));
+}
+
+TEST_F(NodeResultCacheTest, LookupAddedResult)
+{
+  NodeResultCache cache;
+  int value = 0;
+  EXPECT_FALSE(lookup_int(cache, *build_int_key(cache, "Node", 1), value));
+
+  cache.add(*build_int_key(cache, "Node", 1), int_result(10));
+  EXPECT_TRUE(lookup_int(cache, *build_int_key(cache, "Node", 1), value));
+  EXPECT_EQ(value, 10);
+  EXPECT_FALSE(lookup_int(cache, *build_int_key(cache, "Node", 2), value));
+
+  const NodeResultCache::Stats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.results_num, 1);
+}
+
+TEST_F(NodeResultCacheTest, EvictLeastRecentlyUsedResultOfNode)
+{
+  NodeResultCache cache;
+  for (const int i : IndexRange(NodeResultCache::max_results_per_node)) {
+    cache.add(*build_int_key(cache, "Node", i), int_result(i));
+  }
+  /* Results of other nodes are not affected. */
+  cache.add(*build_int_key(cache, "Other", 0), int_result(0));
+  EXPECT_EQ(cache.stats().results_num, NodeResultCache::max_results_per_node + 1);
+
+  /* Use the oldest result, so that the second one is removed instead. */
+  int value;
+  EXPECT_TRUE(lookup_int(cache, *build_int_key(cache, "Node", 0), value));
+  cache.add(*build_int_key(cache, "Node", NodeResultCache::max_results_per_node), int_result(0));
+
+  EXPECT_EQ(cache.stats().results_num, NodeResultCache::max_results_per_node + 1);
+  EXPECT_TRUE(lookup_int(cache, *build_int_key(cache, "Node", 0), value));
+  EXPECT_FALSE(lookup_int(cache, *build_int_key(cache, "Node", 1), value));
+  EXPECT_TRUE(lookup_int(cache, *build_int_key(cache, "Other", 0), value));
+}
+
+TEST_F(NodeResultCacheTest, RejectGeometryNotOwningDirectData)
+{
+  NodeResultCache cache;
+  Mesh *mesh = create_triangle_mesh();
+  const GeometrySet geometry = GeometrySet::create_with_mesh(mesh,
+                                                             GeometryOwnershipType::ReadOnly);
+  NodeResultCache::Result result;
+  result.outputs.append(CachedSocketValue(0, &geometry));
+  cache.add(*build_int_key(cache, "Node", 1), std::move(result));
+
+  EXPECT_EQ(cache.stats().results_num, 0);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(NodeResultCacheTest, GeometryNotOwnedByCacheComparedByContent)
+{
+  NodeResultCache cache;
+  Mesh *mesh = create_triangle_mesh();
+  Mesh *mesh_copy = BKE_mesh_copy_for_eval(mesh, false);
+  const GeometrySet geometry = GeometrySet::create_with_mesh(mesh,
+                                                             GeometryOwnershipType::ReadOnly);
+  const GeometrySet geometry_copy = GeometrySet::create_with_mesh(
+      mesh_copy, GeometryOwnershipType::ReadOnly);
+
+  std::optional<NodeResultCache::Key> key = build_geometry_key(cache, geometry);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_TRUE(*key == *build_geometry_key(cache, geometry_copy));
+
+  mesh_copy->mvert[1].co[0] = 2.0f;
+  EXPECT_FALSE(*key == *build_geometry_key(cache, geometry_copy));
+
+  /* The key must not reference the geometry, so it stays valid after it is freed. */
+  BKE_id_free(nullptr, mesh);
+  BKE_id_free(nullptr, mesh_copy);
+  Mesh *mesh_new = create_triangle_mesh();
+  EXPECT_TRUE(*key == *build_geometry_key(
+                          cache,
+                          GeometrySet::create_with_mesh(mesh_new,
+                                                        GeometryOwnershipType::ReadOnly)));
+  BKE_id_free(nullptr, mesh_new);
+}
+
+}  // namespace blender::modifiers::geometry_nodes::tests
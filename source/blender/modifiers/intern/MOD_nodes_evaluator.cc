@@ -1,7 +1,10 @@
 /* SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "MOD_nodes_cache.hh"
 #include "MOD_nodes_evaluator.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_type_conversions.hh"
 
 #include "NOD_geometry_exec.hh"
@@ -20,6 +23,7 @@
 #include "BLI_stack.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
+#include "BLI_timeit.hh"
 #include "BLI_vector_set.hh"
 
 #include <chrono>
@@ -432,6 +436,9 @@ class NodeParamsProvider : public nodes::GeoNodeExecParamsProvider {
   bool lazy_output_is_required(StringRef identifier) const override;
 
   void set_default_remaining_outputs() override;
+
+  /* When not null, a copy of every output is added here, so that it can be cached. */
+  Vector<CachedSocketValue> *recorded_outputs = nullptr;
 };
 
 class GeometryNodesEvaluator {
@@ -949,8 +956,6 @@ class GeometryNodesEvaluator {
    */
   void execute_node(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
   {
-    const bNode &bnode = *node->bnode();
-
     if (node_state.has_been_executed) {
       if (!node_supports_laziness(node)) {
         /* Nodes that don't support laziness must not be executed more than once. */
@@ -959,6 +964,29 @@ class GeometryNodesEvaluator {
     }
     node_state.has_been_executed = true;
 
+    if (params_.geo_logger == nullptr) {
+      this->execute_node_by_type(node, node_state, run_state);
+      return;
+    }
+
+    const timeit::TimePoint begin = timeit::Clock::now();
+    const timeit::Nanoseconds thread_begin = timeit::thread_cpu_time();
+    const size_t memory_begin = MEM_get_memory_in_use();
+
+    this->execute_node_by_type(node, node_state, run_state);
+
+    geo_log::NodeExecutionProfile profile;
+    profile.executions = 1;
+    profile.wall_time = timeit::Clock::now() - begin;
+    profile.thread_time = timeit::thread_cpu_time() - thread_begin;
+    profile.memory_delta = int64_t(MEM_get_memory_in_use()) - int64_t(memory_begin);
+    params_.geo_logger->local().log_execution_profile(node, profile);
+  }
+
+  void execute_node_by_type(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
+  {
+    const bNode &bnode = *node->bnode();
+
     /* Use the geometry node execute callback if it exists. */
     if (bnode.typeinfo->geometry_node_execute != nullptr) {
       this->execute_geometry_node(node, node_state, run_state);
@@ -980,9 +1008,33 @@ class GeometryNodesEvaluator {
     using Clock = std::chrono::steady_clock;
     const bNode &bnode = *node->bnode();
 
+    std::optional<NodeResultCache::Key> cache_key;
+    if (params_.cache != nullptr && NodeResultCache::node_supports_caching(node)) {
+      cache_key = this->build_cache_key(node, node_state);
+    }
+
+    Clock::time_point begin = Clock::now();
+    if (cache_key.has_value() &&
+        this->try_use_cached_result(node, node_state, *cache_key, run_state)) {
+      Clock::time_point end = Clock::now();
+      const std::chrono::microseconds duration =
+          std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+      if (params_.geo_logger != nullptr) {
+        params_.geo_logger->local().log_execution_time(node, duration);
+      }
+      return;
+    }
+
     NodeParamsProvider params_provider{*this, node, node_state, run_state};
+    Vector<CachedSocketValue> recorded_outputs;
+    int64_t warnings_start = 0;
+    if (cache_key.has_value()) {
+      params_provider.recorded_outputs = &recorded_outputs;
+      if (params_.geo_logger != nullptr) {
+        warnings_start = params_.geo_logger->local().node_warnings().size();
+      }
+    }
     GeoNodeExecParams params{params_provider};
-    Clock::time_point begin = Clock::now();
     bnode.typeinfo->geometry_node_execute(params);
     Clock::time_point end = Clock::now();
     const std::chrono::microseconds duration =
@@ -990,6 +1042,96 @@ class GeometryNodesEvaluator {
     if (params_.geo_logger != nullptr) {
       params_.geo_logger->local().log_execution_time(node, duration);
     }
+
+    if (cache_key.has_value()) {
+      NodeResultCache::Result result;
+      result.outputs = std::move(recorded_outputs);
+      if (params_.geo_logger != nullptr) {
+        result.warnings_logged = true;
+        /* Other nodes may have logged warnings on this thread while this node was running. */
+        for (const geo_log::NodeWithWarning &warning :
+             params_.geo_logger->local().node_warnings().drop_front(warnings_start)) {
+          if (warning.node == node) {
+            result.warnings.append(warning.warning);
+          }
+        }
+      }
+      params_.cache->add(std::move(*cache_key), std::move(result));
+    }
+  }
+
+  /**
+   * The key consists of all inputs of the node. Those are all available, because nodes that can
+   * be cached don't support laziness.
+   */
+  std::optional<NodeResultCache::Key> build_cache_key(const DNode node, NodeState &node_state)
+  {
+    Vector<int> used_outputs;
+    for (const int i : node_state.outputs.index_range()) {
+      if (node_state.outputs[i].output_usage_for_execution != ValueUsage::Unused) {
+        used_outputs.append(i);
+      }
+    }
+    Vector<std::pair<int, GPointer>> inputs;
+    for (const int i : node_state.inputs.index_range()) {
+      const InputState &input_state = node_state.inputs[i];
+      if (input_state.type == nullptr) {
+        continue;
+      }
+      if (!input_state.was_ready_for_execution) {
+        return std::nullopt;
+      }
+      if (node->input(i).is_multi_input_socket()) {
+        for (const void *value : input_state.value.multi->values) {
+          inputs.append({i, {*input_state.type, value}});
+        }
+      }
+      else {
+        inputs.append({i, {*input_state.type, input_state.value.single->value}});
+      }
+    }
+    return params_.cache->build_key(node, used_outputs, inputs);
+  }
+
+  bool try_use_cached_result(const DNode node,
+                             NodeState &node_state,
+                             const NodeResultCache::Key &key,
+                             NodeTaskRunState *run_state)
+  {
+    LinearAllocator<> &allocator = local_allocators_.local();
+    Vector<std::pair<int, GMutablePointer>> outputs;
+    Vector<geo_log::NodeWarning> warnings;
+    const bool found = params_.cache->lookup(key, [&](const NodeResultCache::Result &result) {
+      if (params_.geo_logger != nullptr && !result.warnings_logged) {
+        /* Execute the node again to get its warnings. */
+        return false;
+      }
+      for (const CachedSocketValue &output : result.outputs) {
+        const CPPType &type = *output.value.type();
+        void *buffer = allocator.allocate(type.size(), type.alignment());
+        type.copy_construct(output.value.get(), buffer);
+        outputs.append({output.socket_index, {type, buffer}});
+      }
+      warnings = result.warnings;
+      return true;
+    });
+    if (!found) {
+      return false;
+    }
+
+    /* Forward the values after the cache has been unlocked again. */
+    for (const std::pair<int, GMutablePointer> &output : outputs) {
+      this->forward_output(node.output(output.first), output.second, run_state);
+      node_state.outputs[output.first].has_been_computed = true;
+    }
+    if (params_.geo_logger != nullptr) {
+      geo_log::LocalGeoLogger &local_logger = params_.geo_logger->local();
+      for (geo_log::NodeWarning &warning : warnings) {
+        local_logger.log_node_warning(node, warning.type, std::move(warning.message));
+      }
+      local_logger.log_cached_result(node);
+    }
+    return true;
   }
 
   void execute_multi_function_node(const DNode node,
@@ -1837,6 +1979,9 @@ void NodeParamsProvider::set_output(StringRef identifier, GMutablePointer value)
 
   OutputState &output_state = node_state_.outputs[socket->index()];
   BLI_assert(!output_state.has_been_computed);
+  if (recorded_outputs != nullptr) {
+    recorded_outputs->append(CachedSocketValue(socket->index(), value));
+  }
   evaluator_.forward_output(socket, value, run_state_);
   output_state.has_been_computed = true;
 }
@@ -1914,6 +2059,9 @@ void NodeParamsProvider::set_default_remaining_outputs()
     BLI_assert(type != nullptr);
     void *buffer = allocator.allocate(type->size(), type->alignment());
     type->value_initialize(buffer);
+    if (recorded_outputs != nullptr) {
+      recorded_outputs->append(CachedSocketValue(i, {type, buffer}));
+    }
     evaluator_.forward_output(socket, {type, buffer}, run_state_);
     output_state.has_been_computed = true;
   }
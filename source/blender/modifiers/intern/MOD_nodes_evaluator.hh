@@ -19,6 +19,8 @@ namespace blender::modifiers::geometry_nodes {
 
 using namespace nodes::derived_node_tree_types;
 
+class NodeResultCache;
+
 struct GeometryNodesEvaluationParams {
   blender::LinearAllocator<> allocator;
 
@@ -35,6 +37,8 @@ struct GeometryNodesEvaluationParams {
   Depsgraph *depsgraph;
   Object *self_object;
   geo_log::GeoLogger *geo_logger;
+  /* Results of expensive nodes from previous evaluations. May be null. */
+  NodeResultCache *cache = nullptr;
 
   Vector<GMutablePointer> r_output_values;
 };
@@ -159,6 +159,45 @@ struct NodeWithExecutionTime {
   std::chrono::microseconds exec_time;
 };
 
+/** Cost of executing a node, summed over all its executions in one evaluation. */
+struct NodeExecutionProfile {
+  /** Nodes that support laziness can be executed more than once. */
+  int executions = 0;
+  std::chrono::nanoseconds wall_time{0};
+  /**
+   * CPU time of the thread that executed the node. Work that the node does on other threads in
+   * parallel is only part of the wall time.
+   */
+  std::chrono::nanoseconds thread_time{0};
+  /**
+   * Change of the memory in use while the node was executed. This is roughly the size of the data
+   * created by the node, but also contains allocations of nodes that run at the same time.
+   */
+  int64_t memory_delta = 0;
+
+  NodeExecutionProfile &operator+=(const NodeExecutionProfile &other)
+  {
+    executions += other.executions;
+    wall_time += other.wall_time;
+    thread_time += other.thread_time;
+    memory_delta += other.memory_delta;
+    return *this;
+  }
+};
+
+struct NodeWithExecutionProfile {
+  DNode node;
+  NodeExecutionProfile profile;
+};
+
+/** Profile of a node or of all the nodes in a group node, see #ModifierLog::profile. */
+struct NodeProfileEntry {
+  /** Names of the group nodes and of the node, separated by slashes. Empty for the entire tree. */
+  std::string node_path;
+  bool is_group;
+  NodeExecutionProfile profile;
+};
+
 struct NodeWithDebugMessage {
   DNode node;
   std::string message;
@@ -203,8 +242,10 @@ class LocalGeoLogger {
   Vector<ValueOfSockets> values_;
   Vector<NodeWithWarning> node_warnings_;
   Vector<NodeWithExecutionTime> node_exec_times_;
+  Vector<NodeWithExecutionProfile> node_profiles_;
   Vector<NodeWithDebugMessage> node_debug_messages_;
   Vector<NodeWithUsedNamedAttribute> used_named_attributes_;
+  Vector<DNode> nodes_with_cached_result_;
 
   friend ModifierLog;
 
@@ -218,12 +259,20 @@ class LocalGeoLogger {
   void log_multi_value_socket(DSocket socket, Span<GPointer> values);
   void log_node_warning(DNode node, NodeWarningType type, std::string message);
   void log_execution_time(DNode node, std::chrono::microseconds exec_time);
+  void log_execution_profile(DNode node, const NodeExecutionProfile &profile);
   void log_used_named_attribute(DNode node, std::string attribute_name, NamedAttributeUsage usage);
   /**
    * Log a message that will be displayed in the node editor next to the node.
    * This should only be used for debugging purposes and not to display information to users.
    */
   void log_debug_message(DNode node, std::string message);
+  /** Log that the outputs of the node have been reused from a previous evaluation. */
+  void log_cached_result(DNode node);
+
+  Span<NodeWithWarning> node_warnings() const
+  {
+    return node_warnings_;
+  }
 };
 
 /** The root logger class. */
@@ -240,6 +289,7 @@ class GeoLogger {
   /* These are only optional since they don't have a default constructor. */
   std::unique_ptr<GeometryValueLog> input_geometry_log_;
   std::unique_ptr<GeometryValueLog> output_geometry_log_;
+  NodeExecutionProfile evaluation_profile_;
 
   friend LocalGeoLogger;
   friend ModifierLog;
@@ -261,6 +311,12 @@ class GeoLogger {
     output_geometry_log_ = std::make_unique<GeometryValueLog>(geometry);
   }
 
+  /** Log the cost of the entire evaluation, measured on the thread that started it. */
+  void log_evaluation_profile(const NodeExecutionProfile &profile)
+  {
+    evaluation_profile_ = profile;
+  }
+
   LocalGeoLogger &local()
   {
     return threadlocals_.local();
@@ -300,6 +356,8 @@ class NodeLog {
   Vector<std::string, 0> debug_messages_;
   Vector<UsedNamedAttribute, 0> used_named_attributes_;
   std::chrono::microseconds exec_time_;
+  NodeExecutionProfile profile_;
+  bool result_is_cached_ = false;
 
   friend ModifierLog;
 
@@ -338,6 +396,17 @@ class NodeLog {
     return exec_time_;
   }
 
+  const NodeExecutionProfile &profile() const
+  {
+    return profile_;
+  }
+
+  /** True when the node was not executed, because its outputs were reused. */
+  bool result_is_cached() const
+  {
+    return result_is_cached_;
+  }
+
   Vector<const GeometryAttributeInfo *> lookup_available_attributes() const;
 };
 
@@ -367,6 +436,7 @@ class ModifierLog {
 
   std::unique_ptr<GeometryValueLog> input_geometry_log_;
   std::unique_ptr<GeometryValueLog> output_geometry_log_;
+  Vector<NodeProfileEntry> profile_;
 
  public:
   ModifierLog(GeoLogger &logger);
@@ -393,6 +463,15 @@ class ModifierLog {
   const GeometryValueLog *input_geometry_log() const;
   const GeometryValueLog *output_geometry_log() const;
 
+  /**
+   * The cost of every executed node and of every group node, whose entry contains the cost of all
+   * nodes inside. The first entry is the entire evaluation. Entries are sorted by their path.
+   */
+  Span<NodeProfileEntry> profile() const
+  {
+    return profile_;
+  }
+
  private:
   using LogByTreeContext = Map<const DTreeContext *, TreeLog *>;
 
@@ -400,6 +479,7 @@ class ModifierLog {
                                   const DTreeContext &tree_context);
   NodeLog &lookup_or_add_node_log(LogByTreeContext &log_by_tree_context, DNode node);
   SocketLog &lookup_or_add_socket_log(LogByTreeContext &log_by_tree_context, DSocket socket);
+  NodeExecutionProfile add_tree_profile(const TreeLog &tree_log, const std::string &path_prefix);
 };
 
 }  // namespace blender::nodes::geometry_nodes_eval_log
@@ -579,6 +579,7 @@ void register_node_type_geo_distribute_points_on_faces()
   node_type_size(&ntype, 170, 100, 320);
   ntype.declare = file_ns::node_declare;
   ntype.geometry_node_execute = file_ns::node_geo_exec;
+  ntype.geometry_node_execute_supports_caching = true;
   ntype.draw_buttons = file_ns::node_layout;
   nodeRegisterType(&ntype);
 }
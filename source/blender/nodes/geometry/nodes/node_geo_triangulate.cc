@@ -109,6 +109,7 @@ void register_node_type_geo_triangulate()
   ntype.declare = file_ns::node_declare;
   node_type_init(&ntype, file_ns::geo_triangulate_init);
   ntype.geometry_node_execute = file_ns::node_geo_exec;
+  ntype.geometry_node_execute_supports_caching = true;
   ntype.draw_buttons = file_ns::node_layout;
   nodeRegisterType(&ntype);
 }
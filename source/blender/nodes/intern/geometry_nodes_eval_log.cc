@@ -11,6 +11,7 @@
 
 #include "BLT_translation.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace blender::nodes::geometry_nodes_eval_log {
@@ -69,7 +70,53 @@ ModifierLog::ModifierLog(GeoLogger &logger)
                                                        node_with_attribute_name.node);
       node_log.used_named_attributes_.append(std::move(node_with_attribute_name.attribute));
     }
+
+    for (const DNode &node : local_logger.nodes_with_cached_result_) {
+      NodeLog &node_log = this->lookup_or_add_node_log(log_by_tree_context, node);
+      node_log.result_is_cached_ = true;
+    }
+
+    for (const NodeWithExecutionProfile &node_with_profile : local_logger.node_profiles_) {
+      NodeLog &node_log = this->lookup_or_add_node_log(log_by_tree_context,
+                                                       node_with_profile.node);
+      node_log.profile_ += node_with_profile.profile;
+    }
+  }
+
+  profile_.append({"", true, logger.evaluation_profile_});
+  this->add_tree_profile(*root_tree_logs_, "");
+  std::sort(profile_.begin() + 1,
+            profile_.end(),
+            [](const NodeProfileEntry &a, const NodeProfileEntry &b) {
+              return a.node_path < b.node_path;
+            });
+}
+
+/**
+ * Add profile entries for all nodes in the tree and its child trees. The profile of a group node
+ * is the sum of the profiles of all nodes inside, so its wall time can be larger than the time it
+ * took to evaluate the group when nodes were executed in parallel.
+ */
+NodeExecutionProfile ModifierLog::add_tree_profile(const TreeLog &tree_log,
+                                                   const std::string &path_prefix)
+{
+  NodeExecutionProfile tree_profile;
+  for (auto item : tree_log.node_logs_.items()) {
+    const NodeExecutionProfile &profile = item.value->profile_;
+    if (profile.executions == 0) {
+      continue;
+    }
+    profile_.append({path_prefix + item.key, false, profile});
+    tree_profile += profile;
+  }
+  for (auto item : tree_log.child_logs_.items()) {
+    const std::string path = path_prefix + item.key;
+    const int64_t index = profile_.append_and_get_index({path, true, {}});
+    const NodeExecutionProfile group_profile = this->add_tree_profile(*item.value, path + "/");
+    profile_[index].profile = group_profile;
+    tree_profile += group_profile;
   }
+  return tree_profile;
 }
 
 TreeLog &ModifierLog::lookup_or_add_tree_log(LogByTreeContext &log_by_tree_context,
@@ -493,6 +540,11 @@ void LocalGeoLogger::log_execution_time(DNode node, std::chrono::microseconds ex
   node_exec_times_.append({node, exec_time});
 }
 
+void LocalGeoLogger::log_execution_profile(DNode node, const NodeExecutionProfile &profile)
+{
+  node_profiles_.append({node, profile});
+}
+
 void LocalGeoLogger::log_used_named_attribute(DNode node,
                                               std::string attribute_name,
                                               NamedAttributeUsage usage)
@@ -505,4 +557,9 @@ void LocalGeoLogger::log_debug_message(DNode node, std::string message)
   node_debug_messages_.append({node, std::move(message)});
 }
 
+void LocalGeoLogger::log_cached_result(DNode node)
+{
+  nodes_with_cached_result_.append(node);
+}
+
 }  // namespace blender::nodes::geometry_nodes_eval_log
@@ -450,6 +450,16 @@ void RE_GetCameraModelMatrix(const struct Render *re,
 struct Scene *RE_GetScene(struct Render *re);
 void RE_SetScene(struct Render *re, struct Scene *sce);
 
+/**
+ * Read the data of lazily linked IDs needed to render \a scene, see
+ * #BKE_scene_lazy_link_load_for_render. Must be called from the main thread, before a render
+ * that runs in a job thread is started.
+ */
+void RE_lazy_link_load(struct Main *bmain,
+                       struct Scene *scene,
+                       struct ViewLayer *single_layer,
+                       struct ReportList *reports);
+
 bool RE_is_rendering_allowed(struct Scene *scene,
                              struct ViewLayer *single_layer,
                              struct Object *camera_override,
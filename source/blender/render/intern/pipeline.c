@@ -1767,6 +1767,15 @@ static void render_init_depsgraph(Render *re)
   re->pipeline_scene_eval = DEG_get_evaluated_scene(re->pipeline_depsgraph);
 }
 
+void RE_lazy_link_load(Main *bmain, Scene *scene, ViewLayer *single_layer, ReportList *reports)
+{
+  if (BKE_scene_lazy_link_load_for_render(bmain, scene, single_layer, reports) != 0) {
+    /* Loading replaces the place-holder IDs, which depsgraphs kept around with persistent data
+     * may still point to. */
+    RE_FreePersistentData(NULL);
+  }
+}
+
 /* Free data only needed during rendering operation. */
 static void render_pipeline_free(Render *re)
 {
@@ -1809,6 +1818,11 @@ void RE_RenderFrame(Render *re,
 {
   render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_INIT);
 
+  /* Render jobs load lazily linked data before they start, see #RE_lazy_link_load. */
+  if (BLI_thread_is_main()) {
+    RE_lazy_link_load(bmain, scene, single_layer, re->reports);
+  }
+
   /* Ugly global still...
    * is to prevent preview events and signal subdivision-surface etc to make full resolution. */
   G.is_rendering = true;
@@ -2140,6 +2154,10 @@ void RE_RenderAnim(Render *re,
    * copying (e.g. alter the output path). */
   render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_INIT);
 
+  if (BLI_thread_is_main()) {
+    RE_lazy_link_load(bmain, scene, single_layer, re->reports);
+  }
+
   const RenderData rd = scene->r;
   bMovieHandle *mh = NULL;
   const int cfra_old = rd.cfra;
@@ -416,6 +416,7 @@ void wm_event_do_depsgraph(bContext *C, bool is_after_open_file)
       DEG_graph_tag_on_visible_update(depsgraph, true);
     }
     DEG_make_active(depsgraph);
+    BKE_scene_graph_lazy_link_load(depsgraph, bmain, CTX_wm_reports(C));
     BKE_scene_graph_update_tagged(depsgraph, bmain);
   }
 
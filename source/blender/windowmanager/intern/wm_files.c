@@ -638,6 +638,9 @@ static void wm_file_read_post(bContext *C, const struct wmFileReadPost_Params *p
   bool addons_loaded = false;
 
   if (use_data) {
+    /* Data of the previous file is unlikely to match anything in the new one. */
+    wm_file_write_cache_free();
+
     if (!G.background) {
       /* remove windows which failed to be added via WM_check */
       wm_window_ghostwindows_remove_invalid(C, wm);
@@ -768,6 +771,7 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
 {
   double duration_whole_minutes, duration_whole_seconds;
   double duration_libraries_minutes, duration_libraries_seconds;
+  double duration_versioning_minutes, duration_versioning_seconds;
   double duration_lib_override_minutes, duration_lib_override_seconds;
   double duration_lib_override_resync_minutes, duration_lib_override_resync_seconds;
   double duration_lib_override_recursive_resync_minutes,
@@ -785,6 +789,12 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
                                   &duration_libraries_minutes,
                                   &duration_libraries_seconds,
                                   NULL);
+  BLI_math_time_seconds_decompose(bf_reports->duration.versioning,
+                                  NULL,
+                                  NULL,
+                                  &duration_versioning_minutes,
+                                  &duration_versioning_seconds,
+                                  NULL);
   BLI_math_time_seconds_decompose(bf_reports->duration.lib_overrides,
                                   NULL,
                                   NULL,
@@ -811,6 +821,11 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
             " * Loading libraries: %.0fm%.2fs",
             duration_libraries_minutes,
             duration_libraries_seconds);
+  CLOG_INFO(&LOG,
+            0,
+            " * Versioning: %.0fm%.2fs",
+            duration_versioning_minutes,
+            duration_versioning_seconds);
   CLOG_INFO(&LOG,
             0,
             " * Applying overrides: %.0fm%.2fs",
@@ -1706,6 +1721,17 @@ bool write_crash_blend(void)
   return 0;
 }
 
+/** Data of the previous save, for incremental saving. */
+static BlendFileWriteCache *wm_file_write_cache = NULL;
+
+void wm_file_write_cache_free(void)
+{
+  if (wm_file_write_cache) {
+    BLO_write_cache_free(wm_file_write_cache);
+    wm_file_write_cache = NULL;
+  }
+}
+
 /**
  * \see #wm_homefile_write_exec wraps #BLO_write_file in a similar way.
  */
@@ -1818,6 +1844,15 @@ static bool wm_file_write(bContext *C,
   /* XXX(ton): temp solution to solve bug, real fix coming. */
   bmain->recovered = 0;
 
+  if (USER_EXPERIMENTAL_TEST(&U, use_incremental_save)) {
+    if (wm_file_write_cache == NULL) {
+      wm_file_write_cache = BLO_write_cache_new();
+    }
+  }
+  else {
+    wm_file_write_cache_free();
+  }
+
   if (BLO_write_file(bmain,
                      filepath,
                      fileflags,
@@ -1826,6 +1861,7 @@ static bool wm_file_write(bContext *C,
                          .use_save_versions = true,
                          .use_save_as_copy = use_save_as_copy,
                          .thumb = thumb,
+                         .cache = wm_file_write_cache,
                      },
                      reports)) {
     const bool do_history_file_update = (G.background == false) &&
@@ -130,6 +130,10 @@ static int wm_link_append_flag(wmOperator *op)
   }
   if (RNA_boolean_get(op->ptr, "link")) {
     flag |= FILE_LINK;
+    if ((prop = RNA_struct_find_property(op->ptr, "use_lazy_link")) &&
+        RNA_property_boolean_get(op->ptr, prop)) {
+      flag |= BLO_LIBLINK_USE_LAZY;
+    }
   }
   else {
     if (RNA_boolean_get(op->ptr, "use_recursive")) {
@@ -450,6 +454,15 @@ void WM_OT_link(wmOperatorType *ot)
                                  FILE_SORT_DEFAULT);
 
   wm_link_append_properties_common(ot, true);
+
+  PropertyRNA *prop = RNA_def_boolean(
+      ot->srna,
+      "use_lazy_link",
+      false,
+      "Lazy Link",
+      "Only read meshes, images and node groups used by linked data once they are needed "
+      "for display or rendering, also when opening the file again");
+  RNA_def_property_flag(prop, PROP_SKIP_SAVE);
 }
 
 void WM_OT_append(wmOperatorType *ot)
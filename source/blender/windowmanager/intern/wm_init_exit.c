@@ -527,6 +527,7 @@ void WM_exit_ex(bContext *C, const bool do_python)
     /* Before BKE_blender_free! - since the ListBases get freed there. */
     wm_free_reports(wm);
   }
+  wm_file_write_cache_free();
 
   SEQ_clipboard_free(); /* sequencer.c */
   BKE_tracking_clipboard_free();
@@ -19,6 +19,10 @@ extern "C" {
 /* wm_files.c */
 
 void wm_history_file_read(void);
+/**
+ * Free the data kept from the last save for incremental saving.
+ */
+void wm_file_write_cache_free(void);
 
 struct wmHomeFileRead_Params {
   /** Load data, disable when only loading user preferences. */
@@ -304,17 +304,29 @@ int main(int argc,
    *       guarded allocator before any allocation happened.
    */
   {
+    bool use_guarded_allocator = false;
+    bool use_pooled_allocator = false;
     int i;
     for (i = 0; i < argc; i++) {
       if (STR_ELEM(argv[i], "-d", "--debug", "--debug-memory", "--debug-all")) {
-        printf("Switching to fully guarded memory allocator.\n");
-        MEM_use_guarded_allocator();
+        use_guarded_allocator = true;
         break;
       }
+      if (STREQ(argv[i], "--enable-pooled-allocator")) {
+        use_pooled_allocator = true;
+      }
       if (STREQ(argv[i], "--")) {
         break;
       }
     }
+    /* Debugging takes precedence, the pooled allocator doesn't keep track of blocks. */
+    if (use_guarded_allocator) {
+      printf("Switching to fully guarded memory allocator.\n");
+      MEM_use_guarded_allocator();
+    }
+    else if (use_pooled_allocator) {
+      MEM_use_pooled_allocator();
+    }
     MEM_init_memleak_detection();
   }
 
@@ -575,6 +575,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-time");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-pretty");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-uuid");
+  BLI_args_print_arg_doc(ba, "--debug-depsgraph-trace");
   BLI_args_print_arg_doc(ba, "--debug-ghost");
   BLI_args_print_arg_doc(ba, "--debug-wintab");
   BLI_args_print_arg_doc(ba, "--debug-gpu");
@@ -601,6 +602,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_args_print_arg_doc(ba, "--app-template");
   BLI_args_print_arg_doc(ba, "--factory-startup");
   BLI_args_print_arg_doc(ba, "--enable-event-simulate");
+  BLI_args_print_arg_doc(ba, "--enable-pooled-allocator");
   printf("\n");
   BLI_args_print_arg_doc(ba, "--env-system-datafiles");
   BLI_args_print_arg_doc(ba, "--env-system-scripts");
@@ -738,6 +740,18 @@ static int arg_handle_abort_handler_disable(int UNUSED(argc),
   return 0;
 }
 
+static const char arg_handle_pooled_allocator_enable_doc[] =
+    "\n\t"
+    "Use the memory allocator with per-thread pools, which scales better with many threads.\n"
+    "\tIgnored when memory debugging is enabled.";
+static int arg_handle_pooled_allocator_enable(int UNUSED(argc),
+                                              const char **UNUSED(argv),
+                                              void *UNUSED(data))
+{
+  /* The allocator is switched before parsing arguments, see #main. */
+  return 0;
+}
+
 static void clog_abort_on_error_callback(void *fp)
 {
   BLI_system_backtrace(fp);
@@ -999,6 +1013,21 @@ static int arg_handle_debug_mode_generic_set(int UNUSED(argc),
   return 0;
 }
 
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filepath>\n"
+    "\tRecord the evaluation of dependency graph operations and write it on exit,\n"
+    "\tas a Chrome trace which can be viewed in 'chrome://tracing' or Perfetto.";
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void *UNUSED(data))
+{
+  const char *arg_id = "--debug-depsgraph-trace";
+  if (argc > 1) {
+    DEG_debug_trace_begin(argv[1]);
+    return 1;
+  }
+  printf("\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_debug_mode_io_doc[] =
     "\n\t"
     "Enable debug messages for I/O (Collada, ...).";
@@ -2080,6 +2109,8 @@ void main_args_setup(bContext *C, bArgs *ba)
 
   BLI_args_add(ba, NULL, "--disable-crash-handler", CB(arg_handle_crash_handler_disable), NULL);
   BLI_args_add(ba, NULL, "--disable-abort-handler", CB(arg_handle_abort_handler_disable), NULL);
+  BLI_args_add(
+      ba, NULL, "--enable-pooled-allocator", CB(arg_handle_pooled_allocator_enable), NULL);
 
   BLI_args_add(ba, "-b", "--background", CB(arg_handle_background_mode_set), NULL);
 
@@ -2207,6 +2238,8 @@ void main_args_setup(bContext *C, bArgs *ba)
                "--debug-depsgraph-uuid",
                CB_EX(arg_handle_debug_mode_generic_set, depsgraph_uuid),
                (void *)G_DEBUG_DEPSGRAPH_UUID);
+  BLI_args_add(
+      ba, NULL, "--debug-depsgraph-trace", CB(arg_handle_debug_depsgraph_trace_set), NULL);
   BLI_args_add(ba,
                NULL,
                "--debug-gpu-force-workarounds",
@@ -0,0 +1,61 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+import glob
+import os
+import pathlib
+
+
+def _run(args):
+    import bpy
+    import time
+
+    filepath = args['filepath']
+
+    # Import once to ensure it's cached by OS.
+    bpy.ops.wm.obj_import(filepath=filepath)
+    bpy.ops.wm.read_homefile()
+
+    # Measure importing the second time.
+    start_time = time.time()
+    bpy.ops.wm.obj_import(filepath=filepath)
+    elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time}
+    return result
+
+
+class OBJImportTest(api.Test):
+    def __init__(self, filepath, num_threads):
+        self.filepath = filepath
+        self.num_threads = num_threads
+
+    def name(self):
+        # Same file with different thread counts, to measure how parsing scales with cores.
+        return f"{self.filepath.stem}_{self.num_threads}_threads"
+
+    def category(self):
+        return "io_obj"
+
+    def run(self, env, device_id):
+        args = {'filepath': str(self.filepath)}
+        result, _ = env.run_in_blender(_run, args, ['--threads', str(self.num_threads)])
+        return result
+
+
+def _thread_counts():
+    num_threads = 1
+    max_threads = os.cpu_count() or 1
+    while num_threads < max_threads:
+        yield num_threads
+        num_threads *= 2
+    yield max_threads
+
+
+def generate(env):
+    # Large OBJ files in the lib/benchmarks/io_obj directory.
+    filepaths = [pathlib.Path(filename)
+                 for filename in glob.iglob(str(env.benchmarks_dir / 'io_obj' / '*.obj'))]
+    return [OBJImportTest(filepath, num_threads)
+            for filepath in filepaths
+            for num_threads in _thread_counts()]
@@ -471,6 +471,67 @@ class TestBlendLibDataLibrariesLoad(TestBlendLibLinkHelper):
         assert(len(bpy.data.collections) == 1)
 
 
+class TestBlendLibLazyLinkRender(TestBlendLibLinkHelper):
+
+    def __init__(self, args):
+        self.args = args
+
+    def test_lazy_link_render(self):
+        output_dir = self.args.output_dir
+        self.ensure_path(output_dir)
+
+        self.reset_blender()
+
+        me = bpy.data.meshes.new("LibMesh")
+        me.from_pydata(((0.0, 0.0, 0.0), (1.0, 0.0, 0.0), (0.0, 1.0, 0.0)), (), ((0, 1, 2),))
+        ob = bpy.data.objects.new("LibMesh", me)
+        ob.use_fake_user = True
+        # Take care to keep the name unique so multiple test jobs can run at once.
+        output_lib_path = os.path.join(output_dir, self.unique_blendfile_name("blendlib_lazy"))
+
+        bpy.ops.wm.save_as_mainfile(filepath=output_lib_path, check_existing=False, compress=False)
+
+        # Lazily link an Object, its mesh is only read once it is needed.
+        self.reset_blender()
+
+        link_dir = os.path.join(output_lib_path, "Object")
+        bpy.ops.wm.link(directory=link_dir, filename="LibMesh", use_lazy_link=True)
+
+        # Only render the object, so that the viewport depsgraph does not read its mesh.
+        ob = bpy.data.objects["LibMesh"]
+        coll = bpy.data.collections.new("Hidden")
+        coll.hide_viewport = True
+        bpy.context.scene.collection.children.link(coll)
+        for coll_iter in ob.users_collection:
+            coll_iter.objects.unlink(ob)
+        coll.objects.link(ob)
+
+        # A compositor-only render, which needs neither a camera nor a render engine.
+        scene = bpy.context.scene
+        scene.render.resolution_x = 4
+        scene.render.resolution_y = 4
+        scene.render.resolution_percentage = 100
+        scene.use_nodes = True
+        tree = scene.node_tree
+        tree.nodes.clear()
+        node_rgb = tree.nodes.new("CompositorNodeRGB")
+        node_composite = tree.nodes.new("CompositorNodeComposite")
+        tree.links.new(node_rgb.outputs[0], node_composite.inputs[0])
+
+        output_path = os.path.join(output_dir, self.unique_blendfile_name("blendfile"))
+        bpy.ops.wm.save_as_mainfile(filepath=output_path, check_existing=False, compress=False)
+        bpy.ops.wm.open_mainfile(filepath=output_path, load_ui=False)
+
+        assert(len(bpy.data.meshes["LibMesh"].vertices) == 0)
+
+        bpy.ops.render.render()
+
+        # The render read the mesh, replacing its place-holder.
+        me = bpy.data.meshes["LibMesh"]
+        assert(me.is_missing is False)
+        assert(len(me.vertices) == 3)
+
+
 TESTS = (
     TestBlendLibLinkSaveLoadBasic,
     TestBlendLibAppendBasic,
@@ -478,6 +539,7 @@ TESTS = (
     TestBlendLibLibraryReload,
     TestBlendLibLibraryRelocate,
     TestBlendLibDataLibrariesLoad,
+    TestBlendLibLazyLinkRender,
 )
 
 